@@ -13,10 +13,27 @@ public:
   using time_point = RdtscTimePoint<RdtscClock, RdtscDuration>;
   static constexpr bool is_steady = true;
 
+#ifdef IDK_SIMULATED_CLOCK
+  // Simulation targets (network::network_sim) read a virtual clock which moves only when the simulator sets it, so a
+  // run does not depend on how fast the host executes it, see net::sim::Simulator
+  static time_point
+  now() noexcept {
+    return simulated_now;
+  }
+
+  static void
+  set_simulated_now(time_point now) noexcept {
+    simulated_now = now;
+  }
+
+private:
+  static inline time_point simulated_now{};
+#else
   static time_point
   now() noexcept {
     return time_point(duration(quill::BackendTscClock::rdtsc().value()));
   }
+#endif
 };
 
 } // namespace idk::base
@@ -89,6 +89,19 @@ public:
     write += s.size();
   }
 
+  [[nodiscard]] size_t
+  capacity() const {
+    return buffer.size();
+  }
+
+  // Grows the buffer, views into it are invalidated
+  void
+  reserve(size_t size) {
+    if (size > buffer.size()) {
+      buffer.resize(size);
+    }
+  }
+
   size_t
   available_suffix_bytes() const {
     return buffer.size() - write;
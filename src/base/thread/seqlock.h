@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace idk::base {
+
+// Single writer, many readers. The writer never waits: it bumps the sequence to odd, stores the value with plain
+// stores and bumps it back to even. Readers copy the value and retry if the sequence was odd or moved meanwhile. On
+// x86 both sides compile to plain loads and stores, the fences only stop the compiler from reordering.
+template<typename T>
+  requires std::is_trivially_copyable_v<T>
+class SeqLock {
+public:
+  SeqLock() = default;
+
+  explicit SeqLock(const T& value) : value(value) {}
+
+  // Writer thread only
+  void
+  store(const T& new_value) {
+    const uint64_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&value, &new_value, sizeof(T));
+    sequence.store(current + 2, std::memory_order_release);
+  }
+
+  // Any thread
+  [[nodiscard]] T
+  load() const {
+    T copy;
+    uint64_t before;
+    uint64_t after;
+    do {
+      before = sequence.load(std::memory_order_acquire);
+      std::memcpy(&copy, &value, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1) != 0);
+    return copy;
+  }
+
+private:
+  // Readers spinning on the sequence do not share a cache line with the fields around the lock
+  alignas(64) std::atomic<uint64_t> sequence{0};
+  T value{};
+};
+
+} // namespace idk::base
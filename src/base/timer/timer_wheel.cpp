@@ -0,0 +1,177 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+
+namespace idk::base {
+
+Timer::Timer(Timer&& rhs) {
+  REQUIRE(!rhs.is_armed(), "An armed timer can't be moved");
+}
+
+Timer&
+Timer::operator=(Timer&& rhs) {
+  REQUIRE(!is_armed() && !rhs.is_armed(), "An armed timer can't be moved");
+  return *this;
+}
+
+RdtscClock::time_point
+Timer::deadline() const {
+  return RdtscClock::time_point(RdtscClock::duration(expires * wheel->tick.count()));
+}
+
+void
+Timer::cancel() {
+  if (is_armed()) {
+    wheel->remove(*this);
+  }
+}
+
+TimerWheel::TimerWheel(duration tick, time_point now) : tick(tick), now_tick(to_tick(now)) {
+  REQUIRE(tick.count() > 0, "Timer wheel tick must not be zero");
+}
+
+TimerWheel::~TimerWheel() {
+  // Timers may outlive the wheel, they must not point to it
+  for (auto& level: slots) {
+    for (auto* head: level) {
+      while (head) {
+        auto* next = head->next;
+        head->next = nullptr;
+        head->pprev = nullptr;
+        head = next;
+      }
+    }
+  }
+}
+
+void
+TimerWheel::arm(Timer& timer, time_point deadline, Timer::Callback callback, void* context) {
+  timer.cancel();
+  // Rounded up, a timer never fires before its deadline
+  const uint64_t ticks = (deadline.time_since_epoch().count() + tick.count() - 1) / tick.count();
+  timer.expires = std::max(ticks, now_tick + 1);
+  timer.callback = callback;
+  timer.context = context;
+  timer.wheel = this;
+  insert(timer);
+  armed_++;
+}
+
+void
+TimerWheel::link(Timer*& head, Timer& timer) {
+  timer.next = head;
+  if (head) {
+    head->pprev = &timer.next;
+  }
+  timer.pprev = &head;
+  head = &timer;
+}
+
+void
+TimerWheel::insert(Timer& timer) {
+  static constexpr uint64_t kSpan = uint64_t{1} << (kSlotBits * kLevels);
+  // Timers beyond the wheel span wait in the farthest slot and are placed again when it cascades
+  const uint64_t expires = std::min(timer.expires, now_tick + kSpan - 1);
+  const uint64_t delta = expires - now_tick;
+  size_t level = 0;
+  while (level + 1 < kLevels && delta >= uint64_t{1} << (kSlotBits * (level + 1))) {
+    level++;
+  }
+  const size_t slot = (expires >> (kSlotBits * level)) & (kSlots - 1);
+  timer.level = level;
+  level_sizes[level]++;
+  link(slots[level][slot], timer);
+}
+
+void
+TimerWheel::unlink(Timer& timer) {
+  level_sizes[timer.level]--;
+  *timer.pprev = timer.next;
+  if (timer.next) {
+    timer.next->pprev = timer.pprev;
+  }
+  timer.next = nullptr;
+  timer.pprev = nullptr;
+}
+
+void
+TimerWheel::remove(Timer& timer) {
+  unlink(timer);
+  armed_--;
+}
+
+void
+TimerWheel::cascade(size_t level) {
+  Timer*& slot = slots[level][(now_tick >> (kSlotBits * level)) & (kSlots - 1)];
+  Timer* head = std::exchange(slot, nullptr);
+  while (head) {
+    auto* next = head->next;
+    level_sizes[level]--;
+    insert(*head);
+    head = next;
+  }
+}
+
+size_t
+TimerWheel::fire() {
+  // The slot is moved to a local list, so callbacks can arm and cancel any timer, including the ones not fired yet
+  Timer* expired = nullptr;
+  Timer*& slot = slots[0][now_tick & (kSlots - 1)];
+  while (slot) {
+    auto& timer = *slot;
+    unlink(timer);
+    link(expired, timer);
+    level_sizes[0]++;
+  }
+
+  size_t fired = 0;
+  while (expired) {
+    auto& timer = *expired;
+    unlink(timer);
+    if (timer.expires > now_tick) [[unlikely]] {
+      insert(timer);
+      continue;
+    }
+    armed_--;
+    timer.callback(timer.context);
+    fired++;
+  }
+  return fired;
+}
+
+size_t
+TimerWheel::advance(time_point now) {
+  const uint64_t target = to_tick(now);
+  size_t fired = 0;
+  while (now_tick < target) {
+    if (armed_ == 0) {
+      now_tick = target;
+      break;
+    }
+    // Nothing can fire before the next boundary of the lowest occupied level
+    size_t lowest = 0;
+    while (level_sizes[lowest] == 0) {
+      lowest++;
+    }
+    if (lowest > 0) {
+      now_tick = std::min(target, now_tick | ((uint64_t{1} << (kSlotBits * lowest)) - 1));
+      if (now_tick == target) {
+        break;
+      }
+    }
+    now_tick++;
+    for (size_t level = kLevels - 1; level > 0; --level) {
+      if ((now_tick & ((uint64_t{1} << (kSlotBits * level)) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+    fired += fire();
+  }
+  return fired;
+}
+
+} // namespace idk::base
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/type/default_constructor.h"
+
+namespace idk::base {
+
+class TimerWheel;
+
+// Intrusive timer node, lives inside its owner. Arming and cancelling never allocate. A timer is cancelled when it is
+// destroyed and must not be moved while armed: its callback is bound to the address of the owner, so an owner which
+// moves cancels its timers and arms them again at their `deadline`.
+class Timer : NoCopy {
+public:
+  using Callback = void (*)(void* context);
+
+  Timer() = default;
+
+  Timer(Timer&& rhs);
+
+  Timer&
+  operator=(Timer&& rhs);
+
+  ~Timer() { cancel(); }
+
+  [[nodiscard]] bool
+  is_armed() const {
+    return pprev != nullptr;
+  }
+
+  // When an armed timer fires, rounded up to the wheel tick
+  [[nodiscard]] RdtscClock::time_point
+  deadline() const;
+
+  void
+  cancel();
+
+private:
+  friend class TimerWheel;
+
+  Timer* next{nullptr};
+  Timer** pprev{nullptr};
+  TimerWheel* wheel{nullptr};
+  uint64_t expires{0};
+  uint8_t level{0};
+  Callback callback{nullptr};
+  void* context{nullptr};
+};
+
+// Hierarchical timer wheel (Varghese & Lauck) clocked by rdtsc. Four levels of 256 slots cover 2^32 ticks, arm and
+// cancel are O(1), empty stretches of time are skipped a level at a time. The wheel does not read the clock itself,
+// `advance` is called from the poll loop with the current time, so the cost is paid where the loop can afford it and
+// tests can drive a virtual clock.
+class TimerWheel : NoCopy {
+public:
+  using time_point = RdtscClock::time_point;
+  using duration = RdtscClock::duration;
+
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 8;
+  static constexpr size_t kSlots = 1 << kSlotBits;
+
+  explicit TimerWheel(duration tick, time_point now = RdtscClock::now());
+
+  ~TimerWheel();
+
+  // Calls `(object->*Method)()` at `deadline`. The owner is bound on every arm, so an owner moved while its timers
+  // were idle is still called correctly.
+  template<auto Method, typename T>
+  void
+  arm(Timer& timer, time_point deadline, T* object) {
+    arm(timer, deadline, [](void* context) { (static_cast<T*>(context)->*Method)(); }, object);
+  }
+
+  void
+  arm(Timer& timer, time_point deadline, Timer::Callback callback, void* context);
+
+  // Fires every timer with a deadline up to `now`. Returns the number of fired timers.
+  size_t
+  advance(time_point now);
+
+  // Time of the last advance
+  [[nodiscard]] time_point
+  now() const {
+    return time_point(duration(now_tick * tick.count()));
+  }
+
+  [[nodiscard]] size_t
+  armed() const {
+    return armed_;
+  }
+
+private:
+  friend class Timer;
+
+  [[nodiscard]] uint64_t
+  to_tick(time_point time) const {
+    return time.time_since_epoch().count() / tick.count();
+  }
+
+  void
+  insert(Timer& timer);
+
+  static void
+  link(Timer*& head, Timer& timer);
+
+  void
+  unlink(Timer& timer);
+
+  void
+  remove(Timer& timer);
+
+  void
+  cascade(size_t level);
+
+  size_t
+  fire();
+
+  duration tick;
+  uint64_t now_tick;
+  size_t armed_{0};
+  std::array<std::array<Timer*, kSlots>, kLevels> slots{};
+  // Timers per level, whole empty levels are skipped by `advance`
+  std::array<size_t, kLevels> level_sizes{};
+};
+
+} // namespace idk::base
@@ -3,23 +3,58 @@
 #include <string>
 #include <vector>
 #include <cinttypes>
+#include <optional>
 
 #include "network/wss/client.h"
 
 namespace idk {
 
 
+// A thread pinned to `cpu_affinity` which polls rx queue `queue_id`
+struct WorkerConfig {
+  static constexpr bool kLoggable = true;
+
+  size_t cpu_affinity;
+  uint16_t queue_id;
+};
+
+// A websocket stream of the host of `GatewayConfig::ws`
+struct StreamConfig {
+  static constexpr bool kLoggable = true;
+
+  std::string path;
+  // Text messages sent on every connection of the stream once it is upgraded
+  std::optional<std::vector<std::string>> subscriptions;
+};
+
 struct GatewayConfig {
   static constexpr bool kLoggable = true;
   net::wss::Client::Config ws;
 
+  // The only worker if `workers` is not set
   size_t cpu_affinity;
   uint16_t queue_id;
+  // One worker per rx queue, each owns the connections whose replies hash to its queue
+  std::optional<std::vector<WorkerConfig>> workers;
   std::string interface;
 
-  uint16_t src_port;
+  // Picked per worker so that the replies land on its queue if not set. A configured port is served by the worker
+  // polling the queue it hashes to, the other workers get picked ones.
+  std::optional<uint16_t> src_port;
   uint16_t dst_port;
   net::Ip dst_ip;
+  // Coalesced if not set
+  std::optional<net::tcp::AckPolicy> ack_policy;
+
+  // Warm connections kept by every worker besides the active one, to take over when it fails. None if not set.
+  std::optional<size_t> standby_connections;
+  // Text messages sent on every connection of `ws.path` once it is upgraded
+  std::optional<std::vector<std::string>> subscriptions;
+  // Spread over the workers round robin, each stream has connections of its own. Only `ws.path` if not set.
+  std::optional<std::vector<StreamConfig>> streams;
+  // Connection attempts per second and handshakes in flight at once, per worker
+  std::optional<uint32_t> syn_rate;
+  std::optional<uint32_t> max_handshakes;
 };
 
 }
\ No newline at end of file
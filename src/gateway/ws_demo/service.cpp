@@ -1,8 +1,18 @@
 #include "service.h"
 
+#include <algorithm>
+#include <deque>
+
 #include "base/thread/cpu.h"
+#include "base/thread/thread.h"
+#include "base/timer/timer_wheel.h"
+#include "network/dispatch/dispatcher.h"
 #include "network/interface/interface_manager.h"
+#include "network/dpdk/rss.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/port_allocator.h"
 #include "network/wss/client.h"
+#include "network/wss/connection_pool.h"
 
 namespace idk {
 
@@ -12,69 +22,146 @@ WsDemoServiceImpl::WsDemoServiceImpl(Args args_, base::ToolLauncherContext* ctx)
 int
 WsDemoServiceImpl::run() {
   auto config = base::parse_file<Config>(args.config.value());
+  const auto workers = config.workers.value_or(std::vector{WorkerConfig{config.cpu_affinity, config.queue_id}});
+
+  std::vector<net::Dpdk::DeviceInfo> devices_info;
+  for (const auto& worker: workers) {
+    devices_info.push_back({config.interface, worker.cpu_affinity, worker.queue_id});
+  }
+  net::Dpdk dpdk(interface_manager, devices_info);
+
+  // The NIC spreads the replies over the queues by RSS, each worker gets a source port whose replies it polls
+  const auto interface = interface_manager.get_interface(config.interface);
+  const net::Endpoint remote{.ip = config.dst_ip, .port = net::Port(config.dst_port)};
+  net::tcp::PortAllocator ports(
+      net::dpdk::Rss::query(dpdk.get_device(config.interface, workers.front().queue_id).port_id()));
+  // A configured source port goes to the worker polling the queue its replies hash to, the others get allocated ones
+  std::optional<net::Port> configured;
+  uint16_t configured_queue = 0;
+  if (config.src_port) {
+    configured = net::Port(config.src_port.value());
+    configured_queue = ports.reserve(interface.ip, remote, configured.value());
+    REQUIRE(std::ranges::find(workers, configured_queue, &WorkerConfig::queue_id) != workers.end(),
+            "Replies to port {} arrive on queue {}, which no worker polls", configured->value(), configured_queue);
+  }
+  std::vector<std::pair<WorkerConfig, net::Port>> assignments;
+  for (const auto& worker: workers) {
+    if (configured && worker.queue_id == configured_queue) {
+      assignments.emplace_back(worker, configured.value());
+      continue;
+    }
+    const auto port = ports.allocate(interface.ip, remote, worker.queue_id);
+    REQUIRE(port, "No free source port hashes to queue {}", worker.queue_id);
+    assignments.emplace_back(worker, port.value());
+  }
 
-  run_worker(config);
+  const auto streams = config.streams.value_or(std::vector{StreamConfig{config.ws.path, config.subscriptions}});
+  std::vector<std::vector<StreamConfig>> worker_streams(assignments.size());
+  for (size_t idx = 0; idx < streams.size(); ++idx) {
+    worker_streams[idx % assignments.size()].push_back(streams[idx]);
+  }
 
+  // Joined when they go out of scope
+  std::deque<base::Thread> threads;
+  for (size_t idx = 0; idx < assignments.size(); ++idx) {
+    const auto& [worker, port] = assignments[idx];
+    INFO("Worker on cpu {} polls queue {}, source port {}, {} streams", worker.cpu_affinity, worker.queue_id,
+         port.value(), worker_streams[idx].size());
+    threads.emplace_back([this, &config, &dpdk, &ports, &worker_streams, idx, worker, port] {
+      run_worker(config, worker, dpdk.get_device(config.interface, worker.queue_id), ports.rss_model(), port,
+                 worker_streams[idx]);
+    });
+  }
   return 0;
 }
 
 void
-WsDemoServiceImpl::run_worker(const Config& config) {
-  base::Cpu::bind_this_thread_to_cpu(config.cpu_affinity);
+WsDemoServiceImpl::run_worker(const Config& config, const WorkerConfig& worker, net::dpdk::Device& device,
+                              const net::dpdk::Rss& rss, net::Port src_port, const std::vector<StreamConfig>& streams) {
+  base::Cpu::bind_this_thread_to_cpu(worker.cpu_affinity);
 
   auto interface = interface_manager.get_interface(config.interface);
-  net::Dpdk dpdk(net::Dpdk{interface_manager, {{config.interface, config.cpu_affinity, config.queue_id}}});
-  auto* device = &dpdk.get_device(config.interface);
-  std::ignore = device->clear_receive_queue();
-
-  net::arp::ArpHandler arp_handler(net::Host{.mac = interface.mac, .ip = interface.ip}, device->get_sender());
-
-  net::tcp::Client tcp(
-     net::Connection{
-         .session = {.src = {.mac = interface.mac, .ip = interface.ip},
-                     .dst = {.mac = interface.gateway_mac, .ip = config.dst_ip}},
-         .src_port = net::Port(config.src_port),
-         .dst_port = net::Port(config.dst_port),
-     },
-     device->get_sender());
+  std::ignore = device.clear_receive_queue();
 
-  net::wss::Client connection(config.ws, std::move(tcp));
+  base::TimerWheel timers(kTimerTick);
 
-  while (!ctx->is_stopped()) {
-    const auto raw_packet = device->receive();
-    if (raw_packet.has_value()) {
-      net::EthernetPacketView eth(raw_packet->bytes());
-      TRACE("Eth packet of ARP: {} valid: {} header: {}", eth.header().type == net::EthernetType::Arp, eth.is_valid(),
-            eth.header());
-      if (eth.header().type == net::EthernetType::Arp) {
-        arp_handler.handle_packet(raw_packet->bytes());
-        continue;
-      }
-      if (eth.header().type != net::EthernetType::Ipv4) {
-        continue;
-      }
+  net::arp::ArpHandler arp_handler(net::Host{.mac = interface.mac, .ip = interface.ip}, device.get_sender());
+  arp_handler.announce();
+  if (interface.gateway_ip && interface.gateway_mac != net::Mac{}) {
+    arp_handler.neighbours().seed(interface.gateway_ip.value(), interface.gateway_mac);
+  }
 
-      net::IPPacketView ip(eth);
-      if (ip.header().protocol != net::IpProtocol::Tcp) {
-        continue;
-      }
+  const net::Connection connection{
+      .session = {.src = {.mac = interface.mac, .ip = interface.ip},
+                  .dst = {.mac = interface.gateway_mac, .ip = config.dst_ip}},
+      .src_port = src_port,
+      .dst_port = net::Port(config.dst_port),
+  };
+  // Only this worker takes ports steered to its queue, the allocators of the workers never hand out the same one
+  net::tcp::PortAllocator ports(rss);
+  ports.reserve(interface.ip, net::Endpoint{.ip = config.dst_ip, .port = connection.dst_port}, src_port);
+
+  net::wss::ConnectionPool::Connections connections(device.get_sender());
+  // The workers share the pool of the port, half of it is left to the rx rings and to the sends
+  const size_t workers = config.workers ? config.workers->size() : 1;
+  net::wss::ConnectionPool::Config pool_config{.standby = config.standby_connections.value_or(0),
+                                               .held_mbufs = device.pool_size() / 2 / workers};
+  pool_config.connect.syn_rate = config.syn_rate.value_or(pool_config.connect.syn_rate);
+  pool_config.connect.max_in_flight = config.max_handshakes.value_or(pool_config.connect.max_in_flight);
+  net::wss::ConnectionPool pool(
+      pool_config, connection, worker.queue_id, ports, connections, [&](const net::Connection& next) {
+        net::tcp::Client tcp(next, device.get_sender(), timers);
+        tcp.set_ack_policy(config.ack_policy.value_or(net::tcp::AckPolicy::Coalesced));
+        if (interface.gateway_ip) {
+          tcp.set_next_hop(arp_handler.neighbours(), interface.gateway_ip.value());
+        }
+        return tcp;
+      });
+  // The handshakes of all streams run at once, paced by the pool. The first connection keeps the assigned port.
+  for (size_t idx = 0; idx < streams.size(); ++idx) {
+    pool.add_stream({.host = config.ws.host, .path = streams[idx].path},
+                    streams[idx].subscriptions.value_or(std::vector<std::string>{}),
+                    idx == 0 ? std::optional{src_port} : std::nullopt);
+  }
 
-      net::tcp::PacketView tcp(ip);
+  net::dispatch::Dispatcher dispatcher;
+  dispatcher.on_arp([&](std::span<net::dpdk::RxPacket> packets) {
+    for (auto& packet: packets) {
+      arp_handler.handle_packet(packet.bytes());
+    }
+  });
+  connections.attach(dispatcher, [&](net::wss::ConnectionPool::Session& session, const net::dpdk::RxPacket& packet) {
+    pool.process_packet(session, packet,
+                        [this](uint32_t stream, base::ByteView payload) { process_payload(stream, payload); });
+  });
 
-      connection.process_packet(tcp);
-      auto payload = connection.next_message();
-      while (payload) {
-        process_payload(payload.value());
-        payload = connection.next_message();
+  auto next_stats_log = base::RdtscClock::now() + base::RdtscDuration(kStatsInterval);
+  while (!ctx->is_stopped()) {
+    arp_handler.poll();
+    const auto now = base::RdtscClock::now();
+    timers.advance(now);
+    pool.poll(now);
+    if (next_stats_log < now) [[unlikely]] {
+      for (uint32_t stream = 0; stream < pool.streams(); ++stream) {
+        if (const auto* ws = pool.active(stream)) {
+          DEBUG("Stream {} tcp stats: {}", stream, ws->tcp_stats());
+        }
       }
-      TRACE("No payload. Going to next packet");
+      INFO("{} of {} streams up, {} attempts queued, {} in flight, pool stats: {}", pool.streams_up(), pool.streams(),
+           pool.connect_scheduler().queued(), pool.connect_scheduler().in_flight(), pool.stats());
+      next_stats_log = now + base::RdtscDuration(kStatsInterval);
+    }
+    auto burst = device.receive_burst();
+    if (!burst.empty()) {
+      dispatcher.dispatch(burst);
+      TRACE("Burst of {} packets dispatched, dropped so far: {}", burst.size(), dispatcher.dropped());
     }
   }
 }
 
 void
-WsDemoServiceImpl::process_payload(base::ByteView payload) {
-  DEBUG("Ws msg: {}", base::to_string_view(payload));
+WsDemoServiceImpl::process_payload(uint32_t stream, base::ByteView payload) {
+  DEBUG("Ws msg of stream {}: {}", stream, base::to_string_view(payload));
 }
 
 
@@ -5,6 +5,7 @@
 #include "../../network/arp/arp_handler.h"
 #include "base/launcher/tool_launcher.h"
 #include "network/dpdk/dpdk.h"
+#include "network/dpdk/rss.h"
 #include "network/interface/interface.h"
 #include "network/wss/client.h"
 
@@ -27,10 +28,18 @@ public:
   int
   run();
 
-  void run_worker(const Config& config);
+  // Serves `streams` from the rx queue of `device` on the current thread. The first connection is from `src_port`,
+  // the others from ports whose replies `rss` steers to the same queue.
+  void
+  run_worker(const Config& config, const WorkerConfig& worker, net::dpdk::Device& device, const net::dpdk::Rss& rss,
+             net::Port src_port, const std::vector<StreamConfig>& streams);
 
 private:
-  void process_payload(base::ByteView payload);
+  // Resolution of the tcp timers, well below the minimal rto
+  static constexpr std::chrono::microseconds kTimerTick{100};
+  static constexpr std::chrono::seconds kStatsInterval{10};
+
+  void process_payload(uint32_t stream, base::ByteView payload);
 
 private:
   Args args;
@@ -3,7 +3,7 @@
 namespace idk::net::arp {
 
 ArpHandler::ArpHandler(Host local_host, dpdk::Sender sender) :
-    local_host_(std::move(local_host)), sender_(std::move(sender)) {}
+    local_host_(std::move(local_host)), sender_(std::move(sender)), poll_interval_(kPollInterval) {}
 
 void
 ArpHandler::handle_packet(base::MutableByteView raw_packet) {
@@ -17,6 +17,12 @@ ArpHandler::handle_packet(base::MutableByteView raw_packet) {
   const auto& arp_header = arp_packet.header();
   TRACE_L3("ARP packet: {}", arp_header);
 
+  // Both requests and replies carry the sender binding, only neighbours we are interested in are updated
+  if (arp_header.sender_ip != local_host_.ip && neighbours_.learn(arp_header.sender_ip, arp_header.sender_mac,
+                                                                  base::RdtscClock::now())) {
+    on_resolved(*neighbours_.find(arp_header.sender_ip));
+  }
+
   // Only respond to ARP requests for our IP address
   if (arp_header.operation == Operation::Request && arp_header.target_ip == local_host_.ip) {
     INFO("Responding to ARP request for {} from {}", arp_header.target_ip.as_string(),
@@ -40,7 +46,27 @@ ArpHandler::handle_packet(base::MutableByteView raw_packet) {
 void
 ArpHandler::send_request(Ip target_ip) {
   INFO("Sending ARP request for {}", target_ip.as_string());
+  send_request(local_host_.ip, target_ip);
+}
+
+void
+ArpHandler::announce() {
+  INFO("Announcing {} at {}", local_host_.ip.as_string(), local_host_.mac);
+  send_request(local_host_.ip, local_host_.ip);
+}
 
+void
+ArpHandler::poll() {
+  const auto now = base::RdtscClock::now();
+  if (now < next_poll_) {
+    return;
+  }
+  next_poll_ = now + poll_interval_;
+  neighbours_.expire(now, [&](Ip ip) { send_request(ip); });
+}
+
+void
+ArpHandler::send_request(Ip sender_ip, Ip target_ip) {
   auto request_buffer = sender_.send_raw(PacketView::predict_size());
 
   PacketView request_packet(request_buffer);
@@ -52,7 +78,7 @@ ArpHandler::send_request(Ip target_ip) {
   // Note: init_request sets Ethernet dst to target_mac parameter, which isn't ideal for broadcast
   // But we can use it and then fix the values we need
   request_packet.init_request(local_host_.mac, // sender_mac
-                              local_host_.ip, // sender_ip
+                              sender_ip, // sender_ip
                               zero_mac, // target_mac (unknown MAC in ARP header)
                               target_ip // target_ip
   );
@@ -64,4 +90,12 @@ ArpHandler::send_request(Ip target_ip) {
   TRACE("Sent broadcast ARP request for {}", target_ip.as_string());
 }
 
+void
+ArpHandler::on_resolved(const Neighbour& neighbour) {
+  neighbours_.release_pending(neighbour, [&](dpdk::TxPacket packet, size_t size) {
+    EthernetPacketView(packet.view()).header().dst_mac = neighbour.mac;
+    sender_.send_raw(std::move(packet), size);
+  });
+}
+
 } // namespace idk::net::arp
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "arp.h"
+#include "base/clock/rdtsc_clock.h"
 #include "base/logger/macros.h"
 #include "base/type/span.h"
+#include "neighbour_table.h"
 #include "network/dpdk/sender.h"
 #include "network/type/endpoint.h"
 
@@ -10,6 +12,8 @@ namespace idk::net::arp {
 
 class ArpHandler {
 public:
+  static constexpr std::chrono::milliseconds kPollInterval{100};
+
   ArpHandler(Host local_host, dpdk::Sender sender);
 
   void
@@ -18,9 +22,31 @@ public:
   void
   send_request(Ip target_ip);
 
+  // Gratuitous ARP, lets the switch and the gateway learn our mac before the first connection is opened.
+  void
+  announce();
+
+  // Ages the neighbour table and sends the probes. Cheap enough to be called on every poll loop iteration.
+  void
+  poll();
+
+  NeighbourTable&
+  neighbours() {
+    return neighbours_;
+  }
+
 private:
+  void
+  send_request(Ip sender_ip, Ip target_ip);
+
+  void
+  on_resolved(const Neighbour& neighbour);
+
   Host local_host_;
   dpdk::Sender sender_;
+  NeighbourTable neighbours_;
+  base::RdtscDuration poll_interval_;
+  base::RdtscClock::time_point next_poll_;
 };
 
-} // namespace idk::net::dpdk
\ No newline at end of file
+} // namespace idk::net::dpdk
@@ -0,0 +1,96 @@
+#include "neighbour_table.h"
+
+#include "base/macros/require.h"
+
+namespace idk::net::arp {
+
+NeighbourTable::NeighbourTable() : reachable_time(kReachableTime), probe_interval(kProbeInterval) {
+  pending.reserve(kMaxPendingPackets);
+}
+
+const Neighbour&
+NeighbourTable::track(Ip ip) {
+  return emplace(ip);
+}
+
+Neighbour&
+NeighbourTable::emplace(Ip ip) {
+  if (auto* neighbour = find_mutable(ip)) {
+    return *neighbour;
+  }
+  Neighbour* neighbour = nullptr;
+  for (auto& el: neighbours) {
+    if (el.state == Neighbour::State::Free) {
+      neighbour = &el;
+      break;
+    }
+  }
+  REQUIRE(neighbour, "Neighbour table is full");
+  *neighbour = Neighbour{.ip = ip, .mac = {}, .state = Neighbour::State::Incomplete};
+  DEBUG("Tracking neighbour {}", ip);
+  return *neighbour;
+}
+
+const Neighbour*
+NeighbourTable::find(Ip ip) const {
+  for (const auto& neighbour: neighbours) {
+    if (neighbour.state != Neighbour::State::Free && neighbour.ip == ip) {
+      return &neighbour;
+    }
+  }
+  return nullptr;
+}
+
+Neighbour*
+NeighbourTable::find_mutable(Ip ip) {
+  return const_cast<Neighbour*>(std::as_const(*this).find(ip));
+}
+
+void
+NeighbourTable::seed(Ip ip, Mac mac) {
+  auto& neighbour = emplace(ip);
+  neighbour.mac = mac;
+  neighbour.state = Neighbour::State::Stale;
+  neighbour.probes = 0;
+  neighbour.probed_at = {};
+}
+
+bool
+NeighbourTable::learn(Ip ip, Mac mac, base::RdtscClock::time_point now) {
+  auto* neighbour = find_mutable(ip);
+  if (!neighbour) {
+    return false;
+  }
+  const bool was_resolved = neighbour->is_resolved();
+  if (neighbour->mac != mac) {
+    INFO("Neighbour {} is at {}", ip, mac);
+  }
+  neighbour->mac = mac;
+  neighbour->state = Neighbour::State::Reachable;
+  neighbour->probes = 0;
+  neighbour->confirmed_at = now;
+  return !was_resolved;
+}
+
+void
+NeighbourTable::hold(const Neighbour& neighbour, dpdk::TxPacket packet, size_t size) {
+  if (pending.size() == kMaxPendingPackets) [[unlikely]] {
+    WARN("Pending queue is full, dropping packet to {}", neighbour.ip);
+    return;
+  }
+  pending.push_back({.next_hop = neighbour.ip, .packet = std::move(packet), .size = size});
+}
+
+void
+NeighbourTable::on_probes_exhausted(Neighbour& neighbour) {
+  if (neighbour.state == Neighbour::State::Stale) {
+    WARN("Neighbour {} does not respond, resolving again", neighbour.ip);
+    neighbour.state = Neighbour::State::Incomplete;
+  } else {
+    const auto dropped = std::erase_if(pending, [&](const Pending& el) { return el.next_hop == neighbour.ip; });
+    WARN("Failed to resolve neighbour {}, dropped {} pending packets", neighbour.ip, dropped);
+  }
+  neighbour.probes = 0;
+}
+
+} // namespace idk::net::arp
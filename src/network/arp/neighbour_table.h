@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/logger/macros.h"
+#include "base/type/default_constructor.h"
+#include "network/dpdk/packet.h"
+#include "network/type/ip.h"
+#include "network/type/mac.h"
+
+namespace idk::net::arp {
+
+struct Neighbour {
+  enum class State : uint8_t {
+    Free,
+    // Resolution in flight, the mac is not usable yet.
+    Incomplete,
+    Reachable,
+    // Aged out, still usable while it is being re-probed.
+    Stale,
+  };
+
+  [[nodiscard]] bool
+  is_resolved() const {
+    return state == State::Reachable || state == State::Stale;
+  }
+
+  Ip ip;
+  Mac mac;
+  State state{State::Free};
+  uint8_t probes{0};
+  base::RdtscClock::time_point confirmed_at;
+  base::RdtscClock::time_point probed_at;
+};
+
+// Neighbour cache of the interface. Entries live in a fixed array, so references returned by `track` stay valid for
+// the table lifetime and can be cached on the hot path.
+class NeighbourTable : base::NoCopy {
+public:
+  static constexpr size_t kCapacity = 16;
+  static constexpr size_t kMaxPendingPackets = 64;
+  static constexpr uint8_t kMaxProbes = 3;
+  static constexpr std::chrono::seconds kReachableTime{30};
+  static constexpr std::chrono::seconds kProbeInterval{1};
+
+  NeighbourTable();
+
+  // Returns the entry for `ip`, creating an incomplete one if the ip is not known yet.
+  const Neighbour&
+  track(Ip ip);
+
+  [[nodiscard]] const Neighbour*
+  find(Ip ip) const;
+
+  // Uses a configured mac as a starting point. The entry is stale, so it is re-probed right away.
+  void
+  seed(Ip ip, Mac mac);
+
+  // Returns true if the entry became usable.
+  bool
+  learn(Ip ip, Mac mac, base::RdtscClock::time_point now);
+
+  // Keeps the packet until `neighbour` is resolved. The packet is dropped if the queue is full.
+  void
+  hold(const Neighbour& neighbour, dpdk::TxPacket packet, size_t size);
+
+  template<typename F>
+  void
+  release_pending(const Neighbour& neighbour, F&& f) {
+    std::erase_if(pending, [&](Pending& pending_packet) {
+      if (pending_packet.next_hop != neighbour.ip) {
+        return false;
+      }
+      f(std::move(pending_packet.packet), pending_packet.size);
+      return true;
+    });
+  }
+
+  // Ages entries and calls `f(ip)` for every entry which should be probed now.
+  template<typename F>
+  void
+  expire(base::RdtscClock::time_point now, F&& f) {
+    for (auto& neighbour: neighbours) {
+      switch (neighbour.state) {
+        case Neighbour::State::Free:
+          break;
+        case Neighbour::State::Reachable:
+          if (now - neighbour.confirmed_at >= reachable_time) {
+            TRACE("Neighbour {} is stale", neighbour.ip);
+            neighbour.state = Neighbour::State::Stale;
+            neighbour.probes = 0;
+            probe(neighbour, now, f);
+          }
+          break;
+        case Neighbour::State::Stale:
+        case Neighbour::State::Incomplete:
+          // An entry which was never probed goes out right away, whatever the clock reads
+          if (neighbour.probes != 0 && now - neighbour.probed_at < probe_interval) {
+            break;
+          }
+          if (neighbour.probes >= kMaxProbes) {
+            on_probes_exhausted(neighbour);
+          }
+          probe(neighbour, now, f);
+          break;
+      }
+    }
+  }
+
+  [[nodiscard]] size_t
+  pending_size() const {
+    return pending.size();
+  }
+
+private:
+  struct Pending {
+    Ip next_hop;
+    dpdk::TxPacket packet;
+    size_t size;
+  };
+
+  template<typename F>
+  void
+  probe(Neighbour& neighbour, base::RdtscClock::time_point now, F&& f) {
+    neighbour.probed_at = now;
+    neighbour.probes++;
+    f(neighbour.ip);
+  }
+
+  void
+  on_probes_exhausted(Neighbour& neighbour);
+
+  Neighbour&
+  emplace(Ip ip);
+
+  Neighbour*
+  find_mutable(Ip ip);
+
+  std::array<Neighbour, kCapacity> neighbours{};
+  std::vector<Pending> pending;
+
+  base::RdtscDuration reachable_time;
+  base::RdtscDuration probe_interval;
+};
+
+} // namespace idk::net::arp
@@ -0,0 +1,108 @@
+#include "classifier.h"
+
+#include <immintrin.h>
+
+#include "base/macros/require.h"
+
+namespace idk::net::dispatch {
+
+namespace {
+
+constexpr size_t kLanes = 8;
+
+// Offsets in an untagged ipv4 frame without options
+constexpr int64_t kEtherTypeOffset = 12;
+constexpr int64_t kFragmentOffset = 20;
+constexpr int64_t kSrcIpOffset = 26;
+constexpr int64_t kDstIpOffset = 30;
+constexpr int64_t kPortsOffset = 34;
+
+// Lanes of padding in the last group point here
+alignas(64) constexpr uint8_t kEmptyFrame[64]{};
+
+__m256i
+gather(__m256i lo_addresses, __m256i hi_addresses, int64_t offset) {
+  const auto shift = _mm256_set1_epi64x(offset);
+  const auto* base = static_cast<const int*>(nullptr);
+  const auto lo = _mm256_i64gather_epi32(base, _mm256_add_epi64(lo_addresses, shift), 1);
+  const auto hi = _mm256_i64gather_epi32(base, _mm256_add_epi64(hi_addresses, shift), 1);
+  return _mm256_set_m128i(hi, lo);
+}
+
+__m256i
+mullo(__m256i value, uint32_t factor) {
+  return _mm256_mullo_epi32(value, _mm256_set1_epi32(static_cast<int>(factor)));
+}
+
+void
+classify_group(const uint8_t* const* packets, Classification& out, size_t offset) {
+  const auto lo_addresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packets));
+  const auto hi_addresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packets + 4));
+
+  const auto ether = gather(lo_addresses, hi_addresses, kEtherTypeOffset);
+  const auto fragment = gather(lo_addresses, hi_addresses, kFragmentOffset);
+  const auto src_ip = gather(lo_addresses, hi_addresses, kSrcIpOffset);
+  const auto dst_ip = gather(lo_addresses, hi_addresses, kDstIpOffset);
+  const auto ports = gather(lo_addresses, hi_addresses, kPortsOffset);
+
+  // Lanes hold little endian loads of network order bytes, so the constants are byte swapped
+  const auto ether_type = _mm256_and_si256(ether, _mm256_set1_epi32(0xffff));
+  const auto is_arp = _mm256_cmpeq_epi32(ether_type, _mm256_set1_epi32(0x0608));
+  const auto is_ipv4 = _mm256_cmpeq_epi32(_mm256_and_si256(ether, _mm256_set1_epi32(0x00ffffff)),
+                                          _mm256_set1_epi32(0x00450008));
+  const auto is_whole = _mm256_cmpeq_epi32(_mm256_and_si256(fragment, _mm256_set1_epi32(0xff3f)),
+                                           _mm256_setzero_si256());
+  const auto is_plain_ipv4 = _mm256_and_si256(is_ipv4, is_whole);
+  const auto protocol = _mm256_srli_epi32(fragment, 24);
+  const auto is_tcp = _mm256_and_si256(is_plain_ipv4, _mm256_cmpeq_epi32(protocol, _mm256_set1_epi32(6)));
+  const auto is_udp = _mm256_and_si256(is_plain_ipv4, _mm256_cmpeq_epi32(protocol, _mm256_set1_epi32(17)));
+
+  auto classes = _mm256_and_si256(is_arp, _mm256_set1_epi32(static_cast<int>(PacketClass::Arp)));
+  classes = _mm256_or_si256(classes, _mm256_and_si256(is_tcp, _mm256_set1_epi32(static_cast<int>(PacketClass::Tcp))));
+  classes = _mm256_or_si256(classes, _mm256_and_si256(is_udp, _mm256_set1_epi32(static_cast<int>(PacketClass::Udp))));
+
+  auto hash = _mm256_add_epi32(_mm256_add_epi32(mullo(src_ip, 0x9e3779b1u), mullo(dst_ip, 0x85ebca77u)),
+                               mullo(ports, 0xc2b2ae3du));
+  hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 16));
+
+  // Bytes 2 and 3 of every lane hold the big endian dst port
+  const auto swap_dst_port = _mm256_setr_epi8(3, 2, -1, -1, 7, 6, -1, -1, 11, 10, -1, -1, 15, 14, -1, -1, //
+                                              3, 2, -1, -1, 7, 6, -1, -1, 11, 10, -1, -1, 15, 14, -1, -1);
+  const auto dst_port = _mm256_shuffle_epi8(ports, swap_dst_port);
+
+  alignas(32) std::array<uint32_t, kLanes> classes_out;
+  alignas(32) std::array<uint32_t, kLanes> dst_port_out;
+  _mm256_store_si256(reinterpret_cast<__m256i*>(classes_out.data()), classes);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(dst_port_out.data()), dst_port);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.src_ip.data() + offset), src_ip);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.dst_ip.data() + offset), dst_ip);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.ports.data() + offset), ports);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.flow_hash.data() + offset), hash);
+  for (size_t i = 0; i < kLanes; ++i) {
+    out.classes[offset + i] = static_cast<PacketClass>(classes_out[i]);
+    out.dst_port[offset + i] = static_cast<uint16_t>(dst_port_out[i]);
+  }
+}
+
+} // namespace
+
+static_assert(dpdk::RxBurst::kMaxSize % kLanes == 0);
+
+void
+classify(std::span<const uint8_t* const> packets, Classification& out) {
+  REQUIRE_LE(packets.size(), dpdk::RxBurst::kMaxSize, "Burst is too big");
+  out.size = packets.size();
+
+  size_t offset = 0;
+  for (; offset + kLanes <= packets.size(); offset += kLanes) {
+    classify_group(packets.data() + offset, out, offset);
+  }
+  if (offset < packets.size()) {
+    std::array<const uint8_t*, kLanes> tail;
+    tail.fill(kEmptyFrame);
+    std::copy(packets.begin() + offset, packets.end(), tail.begin());
+    classify_group(tail.data(), out, offset);
+  }
+}
+
+} // namespace idk::net::dispatch
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "network/dpdk/packet.h"
+
+namespace idk::net::dispatch {
+
+enum class PacketClass : uint8_t {
+  Drop = 0,
+  Arp = 1,
+  Tcp = 2,
+  Udp = 3,
+};
+
+// Fields of one burst in SoA layout. Addresses and ports are kept in network byte order, `dst_port` is in host order.
+struct Classification {
+  std::array<PacketClass, dpdk::RxBurst::kMaxSize> classes;
+  std::array<uint32_t, dpdk::RxBurst::kMaxSize> src_ip;
+  std::array<uint32_t, dpdk::RxBurst::kMaxSize> dst_ip;
+  // src port in the low half, dst port in the high half, as they are laid out in the header
+  std::array<uint32_t, dpdk::RxBurst::kMaxSize> ports;
+  std::array<uint16_t, dpdk::RxBurst::kMaxSize> dst_port;
+  std::array<uint32_t, dpdk::RxBurst::kMaxSize> flow_hash;
+  size_t size{0};
+};
+
+// 4-tuple hash, `classify` computes the same value for every tcp/udp packet.
+[[nodiscard]] constexpr uint32_t
+flow_hash(uint32_t src_ip, uint32_t dst_ip, uint32_t ports) {
+  uint32_t hash = src_ip * 0x9e3779b1u + dst_ip * 0x85ebca77u + ports * 0xc2b2ae3du;
+  return hash ^ (hash >> 16);
+}
+
+// Classifies packets by the first 64 bytes of the frame. Eight frames are processed at once with AVX2 gathers, so
+// there is no data dependent branch per packet. Every pointer must have at least 64 readable bytes, which is always
+// true for mbuf data. Ipv4 packets with options or fragments are classified as Drop.
+void
+classify(std::span<const uint8_t* const> packets, Classification& out);
+
+} // namespace idk::net::dispatch
@@ -0,0 +1,125 @@
+#include "dispatcher.h"
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+
+namespace idk::net::dispatch {
+
+Dispatcher::Route::Route(Handler handler) : handler(std::move(handler)) {
+  batch.reserve(dpdk::RxBurst::kMaxSize);
+}
+
+void
+Dispatcher::Route::flush() {
+  if (batch.empty()) {
+    return;
+  }
+  handler(batch);
+  batch.clear();
+}
+
+Dispatcher::UnknownTcpRoute::UnknownTcpRoute(UnknownTcpHandler handler) : handler(std::move(handler)) {
+  batch.reserve(dpdk::RxBurst::kMaxSize);
+  flow_hashes.reserve(dpdk::RxBurst::kMaxSize);
+}
+
+void
+Dispatcher::UnknownTcpRoute::flush() {
+  if (batch.empty()) {
+    return;
+  }
+  handler(batch, flow_hashes);
+  batch.clear();
+  flow_hashes.clear();
+}
+
+void
+Dispatcher::on_arp(Handler handler) {
+  arp.emplace(std::move(handler));
+}
+
+void
+Dispatcher::on_tcp(const Connection& connection, Handler handler) {
+  REQUIRE_LT(tcp.size(), kMaxTcpRoutes, "Too many tcp routes");
+  REQUIRE(tcp_flows.insert(FlowKey::incoming(connection), tcp.size()), "Tcp route {} already exists", connection);
+  tcp.emplace_back(std::move(handler));
+  DEBUG("Tcp route added: {}", connection);
+}
+
+void
+Dispatcher::on_unknown_tcp(UnknownTcpHandler handler) {
+  unknown_tcp.emplace(std::move(handler));
+}
+
+void
+Dispatcher::on_udp(Port dst_port, Handler handler) {
+  udp.push_back({.dst_port = dst_port.value(), .route = Route(std::move(handler))});
+  DEBUG("Udp route added: {}", dst_port);
+}
+
+void
+Dispatcher::dispatch(dpdk::RxBurst& burst) {
+  std::array<const uint8_t*, dpdk::RxBurst::kMaxSize> packets;
+  for (size_t i = 0; i < burst.size(); ++i) {
+    packets[i] = burst.data(i);
+  }
+  classify({packets.data(), burst.size()}, classification);
+
+  for (size_t i = 0; i < burst.size(); ++i) {
+    if (!validator.validate(burst.bytes(i), burst.ol_flags(i), classification.classes[i])) [[unlikely]] {
+      continue;
+    }
+    if (auto* route = find_route(i)) [[likely]] {
+      route->batch.push_back(burst.take(i));
+    } else if (classification.classes[i] == PacketClass::Tcp && unknown_tcp) {
+      unknown_tcp->batch.push_back(burst.take(i));
+      unknown_tcp->flow_hashes.push_back(classification.flow_hash[i]);
+    } else {
+      ++dropped_;
+    }
+  }
+
+  if (arp) {
+    arp->flush();
+  }
+  for (auto& el: tcp) {
+    el.flush();
+  }
+  if (unknown_tcp) {
+    unknown_tcp->flush();
+  }
+  for (auto& el: udp) {
+    el.route.flush();
+  }
+}
+
+Dispatcher::Route*
+Dispatcher::find_route(size_t idx) {
+  switch (classification.classes[idx]) {
+    case PacketClass::Arp:
+      return arp ? &arp.value() : nullptr;
+    case PacketClass::Tcp: {
+      const FlowKey key{
+          .src_ip = classification.src_ip[idx],
+          .dst_ip = classification.dst_ip[idx],
+          .ports = classification.ports[idx],
+      };
+      // The classifier already hashed the tuple
+      const uint32_t route = tcp_flows.find(key, classification.flow_hash[idx]);
+      // Segments of flows without a route go to `unknown_tcp` with their hash
+      return route != FlowTable::kNotFound ? &tcp[route] : nullptr;
+    }
+    case PacketClass::Udp:
+      for (auto& el: udp) {
+        if (el.dst_port == classification.dst_port[idx]) {
+          return &el.route;
+        }
+      }
+      return nullptr;
+    case PacketClass::Drop:
+      return nullptr;
+  }
+  return nullptr;
+}
+
+} // namespace idk::net::dispatch
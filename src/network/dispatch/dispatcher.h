@@ -0,0 +1,95 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "base/type/default_constructor.h"
+#include "classifier.h"
+#include "flow_table.h"
+#include "rx_validator.h"
+#include "network/dpdk/packet.h"
+#include "network/type/endpoint.h"
+
+namespace idk::net::dispatch {
+
+// Routes a classified burst to the protocol handlers. Packets are grouped per handler first, so every handler is
+// called at most once per burst with all of its packets. Corrupted packets and packets without a handler are dropped.
+class Dispatcher : base::NoCopy {
+public:
+  using Handler = std::function<void(std::span<dpdk::RxPacket>)>;
+  // Also gets the `flow_hash` of every segment, the classifier computed it already
+  using UnknownTcpHandler = std::function<void(std::span<dpdk::RxPacket>, std::span<const uint32_t>)>;
+
+  void
+  on_arp(Handler handler);
+
+  // `connection` is the local view: src is us, dst is the peer
+  void
+  on_tcp(const Connection& connection, Handler handler);
+
+  // Tcp segments of flows without a route
+  void
+  on_unknown_tcp(UnknownTcpHandler handler);
+
+  void
+  on_udp(Port dst_port, Handler handler);
+
+  void
+  dispatch(dpdk::RxBurst& burst);
+
+  // Packets without a handler
+  [[nodiscard]] uint64_t
+  dropped() const {
+    return dropped_;
+  }
+
+  [[nodiscard]] const RxValidator::Stats&
+  validation_stats() const {
+    return validator.stats();
+  }
+
+private:
+  struct Route {
+    explicit Route(Handler handler);
+
+    void
+    flush();
+
+    Handler handler;
+    std::vector<dpdk::RxPacket> batch;
+  };
+
+  struct UnknownTcpRoute {
+    explicit UnknownTcpRoute(UnknownTcpHandler handler);
+
+    void
+    flush();
+
+    UnknownTcpHandler handler;
+    std::vector<dpdk::RxPacket> batch;
+    std::vector<uint32_t> flow_hashes;
+  };
+
+  struct UdpRoute {
+    uint16_t dst_port;
+    Route route;
+  };
+
+  Route*
+  find_route(size_t idx);
+
+  Classification classification;
+  RxValidator validator;
+  std::optional<Route> arp;
+  static constexpr size_t kMaxTcpRoutes = 64;
+
+  // Values are indices into `tcp`
+  FlowTable tcp_flows{2 * kMaxTcpRoutes};
+  std::vector<Route> tcp;
+  std::optional<UnknownTcpRoute> unknown_tcp;
+  std::vector<UdpRoute> udp;
+  uint64_t dropped_{0};
+};
+
+} // namespace idk::net::dispatch
@@ -0,0 +1,87 @@
+#include "flow_table.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "base/macros/require.h"
+
+namespace idk::net::dispatch {
+
+FlowKey
+FlowKey::incoming(const Connection& connection) {
+  // Incoming segments carry the peer as the source
+  return {
+      .src_ip = connection.session.dst.ip.data(),
+      .dst_ip = connection.session.src.ip.data(),
+      .ports = connection.dst_port.as_big_endian() | (uint32_t{connection.src_port.as_big_endian()} << 16),
+  };
+}
+
+FlowTable::FlowTable(size_t capacity) : slots(std::bit_ceil(std::max<size_t>(capacity, 2))), mask(slots.size() - 1) {}
+
+bool
+FlowTable::insert(const FlowKey& key, uint32_t value) {
+  REQUIRE_LT(value, kTombstone, "Flow table value {} is reserved", value);
+  if (2 * (used + 1) > slots.size() && used > size_) {
+    drop_tombstones();
+  }
+  REQUIRE_LE(2 * (used + 1), slots.size(), "Flow table is full, {} entries", size_);
+  Slot* reusable = nullptr;
+  for (size_t idx = key.hash() & mask;; idx = (idx + 1) & mask) {
+    auto& slot = slots[idx];
+    if (slot.value == kEmpty) {
+      if (!reusable) {
+        reusable = &slot;
+        used++;
+      }
+      break;
+    }
+    if (slot.value == kTombstone) {
+      if (!reusable) {
+        reusable = &slot;
+      }
+      continue;
+    }
+    if (slot.key == key) {
+      return false;
+    }
+  }
+  reusable->key = key;
+  reusable->value = value;
+  size_++;
+  return true;
+}
+
+void
+FlowTable::drop_tombstones() {
+  std::vector<Slot> live;
+  live.reserve(size_);
+  for (const auto& slot: slots) {
+    if (slot.value != kEmpty && slot.value != kTombstone) {
+      live.push_back(slot);
+    }
+  }
+  std::ranges::fill(slots, Slot{});
+  size_ = 0;
+  used = 0;
+  for (const auto& slot: live) {
+    insert(slot.key, slot.value);
+  }
+}
+
+bool
+FlowTable::erase(const FlowKey& key) {
+  for (size_t idx = key.hash() & mask;; idx = (idx + 1) & mask) {
+    auto& slot = slots[idx];
+    if (slot.value == kEmpty) {
+      return false;
+    }
+    if (slot.value != kTombstone && slot.key == key) {
+      slot.value = kTombstone;
+      size_--;
+      return true;
+    }
+  }
+}
+
+} // namespace idk::net::dispatch
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <immintrin.h>
+#include <vector>
+
+#include "base/type/default_constructor.h"
+#include "classifier.h"
+#include "network/type/endpoint.h"
+
+namespace idk::net::dispatch {
+
+// 4-tuple of an incoming segment, fields as they are on the wire. Padded to 16 bytes so it is compared with one SSE
+// instruction.
+struct alignas(16) FlowKey {
+  // Key of the segments sent to us over `connection`, which is the local view: src is us, dst is the peer
+  static FlowKey
+  incoming(const Connection& connection);
+
+  [[nodiscard]] uint32_t
+  hash() const {
+    return flow_hash(src_ip, dst_ip, ports);
+  }
+
+  [[nodiscard]] bool
+  operator==(const FlowKey& rhs) const {
+    const auto eq = _mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(this)),
+                                    _mm_load_si128(reinterpret_cast<const __m128i*>(&rhs)));
+    return _mm_movemask_epi8(eq) == 0xffff;
+  }
+
+  uint32_t src_ip{0};
+  uint32_t dst_ip{0};
+  // src port in the low half, dst port in the high half
+  uint32_t ports{0};
+  uint32_t padding{0};
+};
+
+static_assert(sizeof(FlowKey) == 16);
+
+// Open addressing hash table from FlowKey to a small integer, typically an index into the owner's connections. All
+// slots live in one array, two per cache line, and are probed linearly. The table is kept at most half full, so a
+// lookup touches one or two cache lines.
+class FlowTable : base::NoCopy {
+public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  // `capacity` is rounded up to a power of two
+  explicit FlowTable(size_t capacity);
+
+  // Returns false if the key is already present
+  bool
+  insert(const FlowKey& key, uint32_t value);
+
+  [[nodiscard]] uint32_t
+  find(const FlowKey& key, uint32_t hash) const {
+    for (size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+      const auto& slot = slots[idx];
+      if (slot.value == kEmpty) {
+        return kNotFound;
+      }
+      if (slot.value != kTombstone && slot.key == key) {
+        return slot.value;
+      }
+    }
+  }
+
+  [[nodiscard]] uint32_t
+  find(const FlowKey& key) const {
+    return find(key, key.hash());
+  }
+
+  // Returns false if the key is not present
+  bool
+  erase(const FlowKey& key);
+
+  [[nodiscard]] size_t
+  size() const {
+    return size_;
+  }
+
+  [[nodiscard]] size_t
+  capacity() const {
+    return slots.size();
+  }
+
+private:
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+  static constexpr uint32_t kTombstone = UINT32_MAX - 1;
+
+  struct alignas(32) Slot {
+    FlowKey key;
+    uint32_t value{kEmpty};
+  };
+
+  static_assert(sizeof(Slot) == 32);
+
+  // Rebuilds the table without the erased entries
+  void
+  drop_tombstones();
+
+  std::vector<Slot> slots;
+  size_t mask;
+  size_t size_{0};
+  // Live entries plus tombstones, bounds the probe length
+  size_t used{0};
+};
+
+} // namespace idk::net::dispatch
@@ -0,0 +1,88 @@
+#include "rx_validator.h"
+
+#include "base/logger/macros.h"
+#include "network/eth_ip/checksum.h"
+#include "network/eth_ip/ip.h"
+
+namespace idk::net::dispatch {
+
+bool
+RxValidator::validate(base::MutableByteView frame, uint64_t ol_flags, PacketClass packet_class) {
+  if (packet_class != PacketClass::Tcp && packet_class != PacketClass::Udp) {
+    return true;
+  }
+
+  IPPacketView ip(frame);
+  const auto& header = ip.header();
+  const size_t ip_size = header.total_length.value();
+  const size_t l4_min_size = packet_class == PacketClass::Tcp ? 20 : 8;
+  if (ip_size > frame.size() - sizeof(EthernetHeader) || ip_size < header.size() + l4_min_size) [[unlikely]] {
+    TRACE("Dropping frame with ip total length {}, frame size {}", ip_size, frame.size());
+    stats_.bad_length++;
+    return false;
+  }
+
+  const auto ip_check = ip_verdict(ol_flags);
+  auto l4_check = l4_verdict(ol_flags);
+  if (ip_check == Verdict::Good && l4_check == Verdict::Good) [[likely]] {
+    stats_.hw_verified++;
+    return true;
+  }
+
+  if (ip_check == Verdict::Bad ||
+      (ip_check == Verdict::Unknown &&
+       !is_checksum_valid(checksum_add({reinterpret_cast<const uint8_t*>(&header), header.size()})))) [[unlikely]] {
+    TRACE("Dropping frame with bad ip checksum from {}", header.src_addr);
+    stats_.bad_ip_checksum++;
+    return false;
+  }
+
+  if (l4_check == Verdict::Unknown) {
+    const auto segment = ip.payload();
+    // Zero udp checksum means the sender did not compute it
+    const bool no_checksum = packet_class == PacketClass::Udp && segment[6] == 0 && segment[7] == 0;
+    const auto protocol = static_cast<uint8_t>(header.protocol);
+    if (!no_checksum &&
+        !is_checksum_valid(checksum_add(segment, pseudo_header_sum(header.src_addr, header.dst_addr, protocol,
+                                                                     static_cast<uint16_t>(segment.size()))))) {
+      l4_check = Verdict::Bad;
+    }
+  }
+  if (l4_check == Verdict::Bad) [[unlikely]] {
+    TRACE("Dropping frame with bad l4 checksum from {}", header.src_addr);
+    stats_.bad_l4_checksum++;
+    return false;
+  }
+
+  stats_.sw_verified++;
+  return true;
+}
+
+RxValidator::Verdict
+RxValidator::ip_verdict(uint64_t ol_flags) {
+  switch (ol_flags & RTE_MBUF_F_RX_IP_CKSUM_MASK) {
+    case RTE_MBUF_F_RX_IP_CKSUM_GOOD:
+    // The header was verified, only the checksum in the packet data is not updated
+    case RTE_MBUF_F_RX_IP_CKSUM_NONE:
+      return Verdict::Good;
+    case RTE_MBUF_F_RX_IP_CKSUM_BAD:
+      return Verdict::Bad;
+    default:
+      return Verdict::Unknown;
+  }
+}
+
+RxValidator::Verdict
+RxValidator::l4_verdict(uint64_t ol_flags) {
+  switch (ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK) {
+    case RTE_MBUF_F_RX_L4_CKSUM_GOOD:
+    case RTE_MBUF_F_RX_L4_CKSUM_NONE:
+      return Verdict::Good;
+    case RTE_MBUF_F_RX_L4_CKSUM_BAD:
+      return Verdict::Bad;
+    default:
+      return Verdict::Unknown;
+  }
+}
+
+} // namespace idk::net::dispatch
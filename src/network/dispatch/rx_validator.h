@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include "base/type/span.h"
+#include "classifier.h"
+
+namespace idk::net::dispatch {
+
+// Drops corrupted tcp/udp frames before they reach the protocol layers. Checksum results reported by the NIC in
+// the mbuf flags are trusted, frames the NIC did not look at are verified in software.
+class RxValidator {
+public:
+  struct Stats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t hw_verified{0};
+    uint64_t sw_verified{0};
+    uint64_t bad_length{0};
+    uint64_t bad_ip_checksum{0};
+    uint64_t bad_l4_checksum{0};
+  };
+
+  // Returns false if the frame has to be dropped. Only Tcp and Udp frames are checked.
+  [[nodiscard]] bool
+  validate(base::MutableByteView frame, uint64_t ol_flags, PacketClass packet_class);
+
+  [[nodiscard]] const Stats&
+  stats() const {
+    return stats_;
+  }
+
+private:
+  enum class Verdict : uint8_t {
+    Good,
+    Bad,
+    Unknown,
+  };
+
+  static Verdict
+  ip_verdict(uint64_t ol_flags);
+
+  static Verdict
+  l4_verdict(uint64_t ol_flags);
+
+  Stats stats_;
+};
+
+} // namespace idk::net::dispatch
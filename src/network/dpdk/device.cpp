@@ -1,9 +1,12 @@
 #include "device.h"
+
+#include <cerrno>
 #include <rte_version.h>
 
 #include "rte_eal.h"
 #include "rte_ethdev.h"
 #include "rte_ip.h"
+#include "rte_mbuf_dyn.h"
 
 
 namespace idk::net::dpdk {
@@ -17,9 +20,44 @@ Device::Device(const std::string& pci_addr, uint16_t port_id, const std::string&
 
   send_mbufs.reserve(kSendBurstSize);
   receive_mbufs.reserve(kReceiveBurstSize);
+  init_rx_timestamps();
   INFO("Device {} on port {} initialized", pci_addr, port_id);
 }
 
+void
+Device::init_rx_timestamps() {
+  // The driver registers them once a port is configured with RTE_ETH_RX_OFFLOAD_TIMESTAMP, see the dpdk master
+  const int offset = rte_mbuf_dynfield_lookup(RTE_MBUF_DYNFIELD_TIMESTAMP_NAME, nullptr);
+  const int flag = rte_mbuf_dynflag_lookup(RTE_MBUF_DYNFLAG_RX_TIMESTAMP_NAME, nullptr);
+  uint64_t start_ticks = 0;
+  if (offset < 0 || flag < 0 || rte_eth_read_clock(port_id_, &start_ticks) != 0) {
+    DEBUG("Port {} has no rx timestamps", port_id_);
+    return;
+  }
+  const auto start = base::SyncRdtscClock::now();
+  while (base::SyncRdtscClock::now() - start < kClockCalibration) {
+  }
+  uint64_t end_ticks = 0;
+  REQUIRE_EQ(rte_eth_read_clock(port_id_, &end_ticks), 0, "Failed to read the clock of port {}", port_id_);
+  const std::chrono::nanoseconds elapsed = base::SyncRdtscClock::now() - start;
+  REQUIRE_GT(end_ticks, start_ticks, "The clock of port {} does not run", port_id_);
+  timestamp_offset = offset;
+  timestamp_flag = 1ULL << flag;
+  ns_per_tick = static_cast<double>(elapsed.count()) / static_cast<double>(end_ticks - start_ticks);
+  INFO("Port {} timestamps received packets, {:.3f}ns per tick", port_id_, ns_per_tick);
+}
+
+std::optional<base::SyncRdtscClock::time_point>
+Device::rx_timestamp(const RxBurst& burst, size_t idx) const {
+  const rte_mbuf* mbuf = burst.mbufs[idx];
+  if (timestamp_offset < 0 || (mbuf->ol_flags & timestamp_flag) == 0) {
+    return std::nullopt;
+  }
+  const auto ticks = *RTE_MBUF_DYNFIELD(mbuf, timestamp_offset, const rte_mbuf_timestamp_t*);
+  return base::SyncRdtscClock::time_point(
+      std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(ticks) * ns_per_tick)));
+}
+
 std::optional<RxPacket>
 Device::receive() {
   std::optional<RxPacket> ret;
@@ -36,6 +74,22 @@ Device::receive() {
   return std::nullopt;
 }
 
+RxBurst
+Device::receive_burst() {
+  RxBurst burst;
+  if (current_recieve_mbuf_idx < receive_mbufs.size()) {
+    burst.size_ = receive_mbufs.size() - current_recieve_mbuf_idx;
+    std::copy(receive_mbufs.begin() + current_recieve_mbuf_idx, receive_mbufs.end(), burst.mbufs.begin());
+    current_recieve_mbuf_idx = receive_mbufs.size();
+    burst.received_at_ = last_receive_time_point;
+    return burst;
+  }
+  burst.size_ = rte_eth_rx_burst(port_id_, queue_id_, burst.mbufs.data(), burst.mbufs.size());
+  last_receive_time_point = base::SyncRdtscClock::now();
+  burst.received_at_ = last_receive_time_point;
+  return burst;
+}
+
 TxPacket
 Device::get_send_buffer() const {
   TxPacket packet(rte_pktmbuf_alloc(mbuf_pool));
@@ -104,6 +158,19 @@ Device::mac() const {
   return mac;
 }
 
+void
+Device::set_multicast_filter(std::span<const Mac> macs) {
+  auto* addresses = reinterpret_cast<rte_ether_addr*>(const_cast<Mac*>(macs.data()));
+  const int ret = rte_eth_dev_set_mc_addr_list(port_id_, addresses, macs.size());
+  if (ret == -ENOTSUP) {
+    WARN("Port {} has no multicast filter, enabling all-multicast mode", port_id_);
+    REQUIRE_EQ(rte_eth_allmulticast_enable(port_id_), 0, "Failed to enable all-multicast mode on port {}", port_id_);
+    return;
+  }
+  REQUIRE_EQ(ret, 0, "Failed to set multicast filter on port {}", port_id_);
+  DEBUG("Multicast filter of port {} has {} addresses", port_id_, macs.size());
+}
+
 const std::string&
 Device::pci_address() const {
   return pci_addr;
@@ -120,6 +187,11 @@ Device::port_id() const {
   return port_id_;
 }
 
+size_t
+Device::pool_size() const {
+  return mbuf_pool->size;
+}
+
 Device::Stats
 Device::stats() const {
   rte_eth_stats rte_stats{};
@@ -1,4 +1,6 @@
 #pragma once
+#include <chrono>
+#include <optional>
 #include <string>
 
 
@@ -22,8 +24,17 @@ public:
   std::optional<RxPacket>
   receive();
 
+  // Returns the whole rx burst at once. Packets left over from `receive` are returned first.
+  RxBurst
+  receive_burst();
+
   base::SyncRdtscClock::time_point get_last_receive_time_point() const;
 
+  // When packet `idx` of `burst` arrived by the clock of the NIC, if the port timestamps received packets. Comparable
+  // between the queues of one port only, every NIC has a clock of its own.
+  [[nodiscard]] std::optional<base::SyncRdtscClock::time_point>
+  rx_timestamp(const RxBurst& burst, size_t idx) const;
+
   TxPacket
   get_send_buffer() const;
 
@@ -61,11 +72,24 @@ public:
 
   Mac mac() const;
 
+  // Programs the multicast mac filter. Falls back to all-multicast mode if the NIC has no filter.
+  void
+  set_multicast_filter(std::span<const Mac> macs);
+
   const std::string& pci_address() const;
   const std::string& interface_name() const;
 
   uint16_t port_id() const;
 
+  // Mbufs of the port's pool, all its queues receive into it and send from it
+  [[nodiscard]] size_t
+  pool_size() const;
+
+  uint16_t
+  queue_id() const {
+    return queue_id_;
+  }
+
   struct Stats {
     static constexpr bool kLoggable = true;
     uint64_t ipackets;
@@ -94,8 +118,14 @@ private:
   friend Sender;
   friend class Dpdk;
 
-  static constexpr uint16_t kReceiveBurstSize = 32;
+  static constexpr uint16_t kReceiveBurstSize = RxBurst::kMaxSize;
   static constexpr uint16_t kSendBurstSize = 32;
+  // The ticks of the NIC clock are timed against the tsc over this long
+  static constexpr std::chrono::milliseconds kClockCalibration{10};
+
+  // Finds the rx timestamp field the driver registered and measures the tick of the NIC clock
+  void
+  init_rx_timestamps();
 
   rte_mempool* mbuf_pool;
   std::string pci_addr;
@@ -109,6 +139,10 @@ private:
   std::vector<rte_mbuf*> receive_mbufs;
   size_t current_recieve_mbuf_idx{0};
   base::SyncRdtscClock::time_point last_receive_time_point{std::chrono::nanoseconds(0)};
+  // Offset of the rx timestamp in the mbuf and the flag of the mbufs which carry one, -1 if the port has none
+  int timestamp_offset{-1};
+  uint64_t timestamp_flag{0};
+  double ns_per_tick{0};
 };
 
 } // namespace idk::net::dpdk
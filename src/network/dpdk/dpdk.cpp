@@ -130,6 +130,16 @@ Dpdk::get_device(const std::string& interface_name) {
   REQUIRE(false, "Unable to find device {}", interface_name);
 }
 
+dpdk::Device&
+Dpdk::get_device(const std::string& interface_name, uint16_t queue_id) {
+  for (auto& device: devices) {
+    if (device.interface_name() == interface_name && device.queue_id() == queue_id) {
+      return device;
+    }
+  }
+  REQUIRE(false, "Unable to find queue {} of device {}", queue_id, interface_name);
+}
+
 Dpdk::~Dpdk() {
   if (ownership_flag) {
     rte_eal_cleanup();
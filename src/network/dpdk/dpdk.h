@@ -29,6 +29,10 @@ public:
   dpdk::Device&
   get_device(const std::string& interface_name);
 
+  // Device of one rx queue of an interface opened several times, one per worker
+  dpdk::Device&
+  get_device(const std::string& interface_name, uint16_t queue_id);
+
 private:
   static std::atomic_flag initialized;
   std::unique_ptr<bool> ownership_flag;
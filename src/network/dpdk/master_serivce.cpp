@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <vector>
 
+#include "rss.h"
 
 namespace idk::base {
 
@@ -52,6 +53,12 @@ DpdkMasterServiceImpl::init() {
       INFO("  Requested RSS flags: 0x{:x}, Device supported: 0x{:x}, Using: 0x{:x}", rss_hf,
            dev_info.flow_type_rss_offloads, port_conf.rx_adv_conf.rss_conf.rss_hf);
     }
+    // Let the NIC verify rx checksums where it can, the rest is verified in software by the dispatcher. Rx
+    // timestamps tell which line of an A/B feed was first, see dpdk::Device::rx_timestamp.
+    port_conf.rxmode.offloads = (RTE_ETH_RX_OFFLOAD_IPV4_CKSUM | RTE_ETH_RX_OFFLOAD_TCP_CKSUM |
+                                 RTE_ETH_RX_OFFLOAD_UDP_CKSUM | RTE_ETH_RX_OFFLOAD_TIMESTAMP) &
+                                dev_info.rx_offload_capa;
+    DEBUG("  rx offloads: 0x{:x}", port_conf.rxmode.offloads);
     REQUIRE_EQ(rte_eth_dev_configure(port_id, nb_rx_queues, nb_tx_queues, &port_conf), 0, "");
 
     uint16_t nb_rxd = 512;
@@ -102,13 +109,13 @@ DpdkMasterServiceImpl::init() {
       std::vector<rte_eth_rss_reta_entry64> reta_conf(reta_conf_size);
 
       // Distribute RETA entries round-robin across available queues
+      const auto reta = net::dpdk::Rss::spread(reta_size, nb_rx_queues);
       for (uint16_t i = 0; i < reta_size; i++) {
         uint16_t reta_idx = i / RTE_ETH_RETA_GROUP_SIZE;
         uint16_t reta_pos = i % RTE_ETH_RETA_GROUP_SIZE;
-        uint16_t queue = (i < reta_size / nb_rx_queues) ? 0 : 1;
 
         reta_conf[reta_idx].mask |= (1ULL << reta_pos);
-        reta_conf[reta_idx].reta[reta_pos] = queue;
+        reta_conf[reta_idx].reta[reta_pos] = reta[i];
       }
 
       REQUIRE_EQ(rte_eth_dev_rss_reta_update(port_id, reta_conf.data(), reta_size), 0,
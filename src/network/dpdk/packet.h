@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
 #include <optional>
+#include <utility>
 
 
+#include "base/clock/sync_rdtsc_clock.h"
 #include "base/macros/require.h"
 #include "base/type/default_constructor.h"
 #include "base/type/span.h"
@@ -21,14 +24,14 @@ class Device;
 class RxPacket : base::NoCopy {
 public:
   friend class Device;
+  friend class RxBurst;
   friend class std::optional<RxPacket>;
 
   RxPacket(RxPacket&& rhs) noexcept : rx_packet(rhs.rx_packet) { rhs.rx_packet = nullptr; }
 
   RxPacket&
   operator=(RxPacket&& rhs) noexcept {
-    rx_packet = rhs.rx_packet;
-    rhs.rx_packet = nullptr;
+    std::swap(rx_packet, rhs.rx_packet);
     return *this;
   }
 
@@ -45,6 +48,13 @@ public:
     return {rte_pktmbuf_mtod(rx_packet, uint8_t*), rx_packet->pkt_len};
   }
 
+  // Another owner of the same mbuf, the mbuf is freed when the last owner goes away
+  [[nodiscard]] RxPacket
+  share() const {
+    rte_mbuf_refcnt_update(rx_packet, 1);
+    return RxPacket(rx_packet);
+  }
+
 private:
   explicit RxPacket(rte_mbuf* rx_packet) : rx_packet(rx_packet) { REQUIRE(rx_packet, "Nullptr in rx_packet"); }
 
@@ -53,6 +63,85 @@ private:
 
 static_assert(sizeof(RxPacket) == sizeof(rte_mbuf*));
 
+// Packets of one rx burst. Packets which were not taken out are freed together with the burst.
+class RxBurst : base::NoCopy {
+public:
+  friend class Device;
+
+  static constexpr size_t kMaxSize = 32;
+
+  RxBurst(RxBurst&& rhs) noexcept : mbufs(rhs.mbufs), size_(rhs.size_), received_at_(rhs.received_at_) {
+    rhs.size_ = 0;
+  }
+
+  RxBurst&
+  operator=(RxBurst&& rhs) noexcept {
+    free();
+    mbufs = rhs.mbufs;
+    size_ = rhs.size_;
+    received_at_ = rhs.received_at_;
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  ~RxBurst() { free(); }
+
+  [[nodiscard]] size_t
+  size() const {
+    return size_;
+  }
+
+  [[nodiscard]] bool
+  empty() const {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] const uint8_t*
+  data(size_t idx) const {
+    return rte_pktmbuf_mtod(mbufs[idx], const uint8_t*);
+  }
+
+  [[nodiscard]] base::MutableByteView
+  bytes(size_t idx) const {
+    return {rte_pktmbuf_mtod(mbufs[idx], uint8_t*), mbufs[idx]->pkt_len};
+  }
+
+  [[nodiscard]] uint64_t
+  ol_flags(size_t idx) const {
+    return mbufs[idx]->ol_flags;
+  }
+
+  // Time of the rx poll which returned the burst
+  [[nodiscard]] base::SyncRdtscClock::time_point
+  received_at() const {
+    return received_at_;
+  }
+
+  [[nodiscard]] RxPacket
+  take(size_t idx) {
+    REQUIRE(mbufs[idx], "Packet {} is already taken", idx);
+    RxPacket packet(mbufs[idx]);
+    mbufs[idx] = nullptr;
+    return packet;
+  }
+
+private:
+  RxBurst() = default;
+
+  void
+  free() {
+    for (size_t i = 0; i < size_; ++i) {
+      if (mbufs[i]) {
+        rte_pktmbuf_free(mbufs[i]);
+      }
+    }
+  }
+
+  std::array<rte_mbuf*, kMaxSize> mbufs{};
+  size_t size_{0};
+  base::SyncRdtscClock::time_point received_at_{};
+};
+
 class TxPacket : base::NoCopy {
 public:
   friend class Device;
@@ -62,8 +151,7 @@ public:
 
   TxPacket&
   operator=(TxPacket&& rhs) noexcept {
-    tx_packet = rhs.tx_packet;
-    rhs.tx_packet = nullptr;
+    std::swap(tx_packet, rhs.tx_packet);
     return *this;
   }
 
@@ -80,7 +168,36 @@ public:
     return {begin, rte_pktmbuf_data_room_size(tx_packet->pool)};
   }
 
+  // Another owner of the same mbuf. Keeps a sent packet alive after the NIC has released it.
+  [[nodiscard]] TxPacket
+  share() const {
+    rte_mbuf_refcnt_update(tx_packet, 1);
+    return adopt(tx_packet);
+  }
+
+  // Copy of a sent packet into a new mbuf, which can be modified while the original may still sit in the tx ring
+  [[nodiscard]] TxPacket
+  copy() const {
+    auto* mbuf = rte_pktmbuf_copy(tx_packet, tx_packet->pool, 0, UINT32_MAX);
+    REQUIRE(mbuf, "Failed to copy mbuf");
+    return adopt(mbuf);
+  }
+
+  [[nodiscard]] size_t
+  size() const {
+    return tx_packet->pkt_len;
+  }
+
 private:
+  TxPacket() = default;
+
+  static TxPacket
+  adopt(rte_mbuf* mbuf) {
+    TxPacket packet;
+    packet.tx_packet = mbuf;
+    return packet;
+  }
+
   explicit TxPacket(rte_mbuf* tx_packet) : tx_packet(tx_packet) {
     REQUIRE(tx_packet, "Nullptr in tx_packet");
     rte_pktmbuf_reset(tx_packet);
@@ -0,0 +1,89 @@
+#include "rss.h"
+
+#include <array>
+#include <cstring>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+#include "rte_ethdev.h"
+
+namespace idk::net::dpdk {
+
+uint32_t
+toeplitz_hash(std::span<const uint8_t> key, std::span<const uint8_t> input) {
+  REQUIRE_GE(key.size(), input.size() + sizeof(uint32_t), "Rss key of {} bytes is too short", key.size());
+  uint32_t result = 0;
+  // The 32 key bits aligned with the current input bit
+  uint32_t window = (uint32_t{key[0]} << 24) | (uint32_t{key[1]} << 16) | (uint32_t{key[2]} << 8) | key[3];
+  for (size_t i = 0; i < input.size(); ++i) {
+    for (int bit = 7; bit >= 0; --bit) {
+      if ((input[i] >> bit) & 1) {
+        result ^= window;
+      }
+      window = (window << 1) | ((key[i + sizeof(uint32_t)] >> bit) & 1);
+    }
+  }
+  return result;
+}
+
+Rss::Rss(std::vector<uint8_t> key, std::vector<uint16_t> reta) : key(std::move(key)), reta(std::move(reta)) {}
+
+std::vector<uint16_t>
+Rss::spread(size_t size, uint16_t queues) {
+  REQUIRE_GT(queues, 0, "Rss needs at least one queue");
+  std::vector<uint16_t> reta(size);
+  for (size_t i = 0; i < reta.size(); ++i) {
+    reta[i] = i % queues;
+  }
+  return reta;
+}
+
+Rss
+Rss::query(uint16_t port_id) {
+  rte_eth_dev_info info{};
+  REQUIRE_EQ(rte_eth_dev_info_get(port_id, &info), 0, "Failed to get the info of port {}", port_id);
+  if (info.reta_size == 0 || info.hash_key_size == 0) {
+    DEBUG("Port {} has no rss", port_id);
+    return Rss({kDefaultKey.begin(), kDefaultKey.end()}, {});
+  }
+
+  std::vector<uint8_t> key(info.hash_key_size);
+  rte_eth_rss_conf conf{.rss_key = key.data(), .rss_key_len = info.hash_key_size};
+  REQUIRE_EQ(rte_eth_dev_rss_hash_conf_get(port_id, &conf), 0, "Failed to get the rss key of port {}", port_id);
+
+  std::vector<rte_eth_rss_reta_entry64> groups((info.reta_size + RTE_ETH_RETA_GROUP_SIZE - 1) /
+                                               RTE_ETH_RETA_GROUP_SIZE);
+  for (auto& group: groups) {
+    group.mask = ~0ULL;
+  }
+  REQUIRE_EQ(rte_eth_dev_rss_reta_query(port_id, groups.data(), info.reta_size), 0,
+             "Failed to query the reta of port {}", port_id);
+  std::vector<uint16_t> reta(info.reta_size);
+  for (size_t i = 0; i < reta.size(); ++i) {
+    reta[i] = groups[i / RTE_ETH_RETA_GROUP_SIZE].reta[i % RTE_ETH_RETA_GROUP_SIZE];
+  }
+  INFO("Port {} rss: {} byte key, {} reta entries", port_id, key.size(), reta.size());
+  return Rss(std::move(key), std::move(reta));
+}
+
+uint32_t
+Rss::hash(Ip src, Ip dst, Port src_port, Port dst_port) const {
+  // Addresses and ports in network byte order, as they are on the wire
+  std::array<uint8_t, 12> input;
+  const uint16_t ports[] = {src_port.as_big_endian(), dst_port.as_big_endian()};
+  std::memcpy(input.data(), &src.data(), sizeof(uint32_t));
+  std::memcpy(input.data() + 4, &dst.data(), sizeof(uint32_t));
+  std::memcpy(input.data() + 8, ports, sizeof(ports));
+  return toeplitz_hash(key, input);
+}
+
+uint16_t
+Rss::queue(Ip src, Ip dst, Port src_port, Port dst_port) const {
+  if (reta.empty()) {
+    return 0;
+  }
+  // The NIC indexes the table with the low bits of the hash
+  return reta[hash(src, dst, src_port, dst_port) % reta.size()];
+}
+
+} // namespace idk::net::dpdk
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "network/type/endpoint.h"
+
+namespace idk::net::dpdk {
+
+// Toeplitz hash of `input` under `key` as the NIC computes it for RSS. The key must be 4 bytes longer than the input.
+[[nodiscard]] uint32_t
+toeplitz_hash(std::span<const uint8_t> key, std::span<const uint8_t> input);
+
+// Software model of the receive side scaling of a port: the Toeplitz hash of a packet's 4-tuple with the port's key
+// picks an entry of the redirection table (RETA), which names the rx queue. It tells in advance on which queue the
+// replies of a connection will arrive.
+class Rss {
+public:
+  // Microsoft's default key, which most drivers use unless told otherwise
+  static constexpr std::array<uint8_t, 40> kDefaultKey{
+      0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+      0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+      0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+  };
+
+  // An empty table means a single queue
+  Rss(std::vector<uint8_t> key, std::vector<uint16_t> reta);
+
+  // Table of `size` entries which spreads the hash buckets round robin over `queues` queues, as the dpdk master
+  // programs it
+  [[nodiscard]] static std::vector<uint16_t>
+  spread(size_t size, uint16_t queues);
+
+  // The key and table programmed on `port_id`, a single queue if the port has no RSS
+  [[nodiscard]] static Rss
+  query(uint16_t port_id);
+
+  // Hash of an ipv4 tcp or udp packet
+  [[nodiscard]] uint32_t
+  hash(Ip src, Ip dst, Port src_port, Port dst_port) const;
+
+  [[nodiscard]] uint16_t
+  queue(Ip src, Ip dst, Port src_port, Port dst_port) const;
+
+  // Queue the replies of `connection` (local view) arrive on
+  [[nodiscard]] uint16_t
+  reply_queue(const Connection& connection) const {
+    return queue(connection.session.dst.ip, connection.session.src.ip, connection.dst_port, connection.src_port);
+  }
+
+  [[nodiscard]] size_t
+  reta_size() const {
+    return reta.size();
+  }
+
+private:
+  std::vector<uint8_t> key;
+  std::vector<uint16_t> reta;
+};
+
+} // namespace idk::net::dpdk
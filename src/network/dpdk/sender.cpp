@@ -27,5 +27,10 @@ Sender::flush() {
   device->flush_send_queue();
 }
 
+void
+Sender::set_multicast_filter(std::span<const Mac> macs) {
+  device->set_multicast_filter(macs);
+}
+
 
 } // namespace idk::net::dpdk
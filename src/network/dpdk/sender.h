@@ -1,5 +1,6 @@
 #pragma once
 #include "base/type/span.h"
+#include "network/type/mac.h"
 #include "packet.h"
 
 
@@ -21,6 +22,9 @@ public:
   void
   flush();
 
+  void
+  set_multicast_filter(std::span<const Mac> macs);
+
 private:
   friend class Device;
   explicit Sender(Device* device);
@@ -0,0 +1,73 @@
+#include "checksum.h"
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace idk::net {
+
+namespace {
+
+constexpr size_t kBlockSize = sizeof(__m256i);
+// Every block adds at most 2 * 0xffff to a 32 bit lane
+constexpr size_t kBlocksBeforeSpill = 0x7fff;
+
+uint64_t
+reduce(__m256i acc) {
+  alignas(32) uint32_t lanes[8];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  uint64_t sum = 0;
+  for (auto lane: lanes) {
+    sum += lane;
+  }
+  return sum;
+}
+
+} // namespace
+
+uint64_t
+checksum_add(base::ByteView data, uint64_t sum) {
+  const uint8_t* ptr = data.data();
+  size_t size = data.size();
+
+  const auto zero = _mm256_setzero_si256();
+  while (size >= kBlockSize) {
+    auto acc = _mm256_setzero_si256();
+    for (size_t blocks = 0; size >= kBlockSize && blocks < kBlocksBeforeSpill; ++blocks) {
+      const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+      acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(block, zero));
+      acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(block, zero));
+      ptr += kBlockSize;
+      size -= kBlockSize;
+    }
+    sum += reduce(acc);
+  }
+
+  for (; size >= sizeof(uint16_t); size -= sizeof(uint16_t), ptr += sizeof(uint16_t)) {
+    uint16_t word;
+    std::memcpy(&word, ptr, sizeof(word));
+    sum += word;
+  }
+  if (size) {
+    // The odd byte is padded with zero on the right, which is the low byte of a little endian word
+    sum += *ptr;
+  }
+  return sum;
+}
+
+uint16_t
+checksum_fold(uint64_t sum) {
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(sum);
+}
+
+uint64_t
+pseudo_header_sum(Ip src, Ip dst, uint8_t protocol, uint16_t l4_length) {
+  const uint8_t tail[4] = {0, protocol, static_cast<uint8_t>(l4_length >> 8), static_cast<uint8_t>(l4_length)};
+  uint64_t sum = checksum_add(base::to_byte_view(src.data()));
+  sum = checksum_add(base::to_byte_view(dst.data()), sum);
+  return checksum_add({tail, sizeof(tail)}, sum);
+}
+
+} // namespace idk::net
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "base/type/span.h"
+#include "network/type/ip.h"
+
+namespace idk::net {
+
+// Internet checksum (RFC 1071). The one's complement sum does not depend on the byte order, so words are summed as
+// they are loaded and the folded result is already in network order.
+
+// Adds `data` to a running sum. Uses AVX2 for everything longer than one vector.
+[[nodiscard]] uint64_t
+checksum_add(base::ByteView data, uint64_t sum = 0);
+
+[[nodiscard]] uint16_t
+checksum_fold(uint64_t sum);
+
+// Sum of the tcp/udp pseudo header
+[[nodiscard]] uint64_t
+pseudo_header_sum(Ip src, Ip dst, uint8_t protocol, uint16_t l4_length);
+
+// A block which includes its own checksum field is valid when it sums up to 0xffff
+[[nodiscard]] inline bool
+is_checksum_valid(uint64_t sum) {
+  return checksum_fold(sum) == 0xffff;
+}
+
+} // namespace idk::net
@@ -15,6 +15,7 @@ namespace idk::net {
 enum class IpVersion : uint8_t { IPv4 = 4, IPv6 = 6 };
 
 enum class IpProtocol : uint8_t {
+  Igmp = 2,
   Tcp = 6,
   Udp = 17
 };
@@ -0,0 +1,15 @@
+#include "ab_feed.h"
+
+#include "base/logger/macros.h"
+
+namespace idk::net::feed {
+
+AbFeed::AbFeed(LineConfig a, LineConfig b) :
+    lines{{{.device = a.device, .group = a.group.data(), .port = a.port.value()},
+           {.device = b.device, .group = b.group.data(), .port = b.port.value()}}},
+    shared_clock(a.device->port_id() == b.device->port_id()) {
+  INFO("A/B feed: line A {}:{} on port {}, line B {}:{} on port {}", a.group, a.port, a.device->port_id(), b.group,
+       b.port, b.device->port_id());
+}
+
+} // namespace idk::net::feed
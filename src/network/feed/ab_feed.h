@@ -0,0 +1,116 @@
+#pragma once
+
+#include <optional>
+
+#include "base/type/default_constructor.h"
+#include "line_arbiter.h"
+#include "network/dispatch/classifier.h"
+#include "network/dispatch/rx_validator.h"
+#include "network/dpdk/device.h"
+#include "network/udp/packet_view.h"
+
+namespace idk::net::feed {
+
+// Polls the A and B lines of a multicast feed on one core and forwards the first copy of every datagram. The lines
+// can be two ports or two queues of one port, every line has its own Device. Packets which do not belong to the feed
+// are dropped, so the devices should not be shared with other traffic.
+//
+// Which line won is told by the rx timestamps of the NIC when both lines are queues of a port which has them.
+// Otherwise a datagram arrived when the poll cycle which returned it started: copies returned by one cycle are a tie,
+// and the lines take turns at being polled first so that neither looks faster for it.
+class AbFeed : base::NoCopy {
+public:
+  struct LineConfig {
+    dpdk::Device* device;
+    Ip group;
+    Port port;
+  };
+
+  AbFeed(LineConfig a, LineConfig b);
+
+  // `sequence_of(payload)` returns the feed sequence number of a datagram as std::optional<uint64_t>, datagrams
+  // without one are dropped. `on_message(datagram, line)` receives the first copy of every message.
+  template<typename SequenceOf, typename OnMessage>
+  void
+  poll(SequenceOf&& sequence_of, OnMessage&& on_message) {
+    const auto cycle = base::SyncRdtscClock::now();
+    const Line first = b_first ? Line::B : Line::A;
+    b_first = !b_first;
+    poll_line(first, cycle, sequence_of, on_message);
+    poll_line(first == Line::A ? Line::B : Line::A, cycle, sequence_of, on_message);
+  }
+
+  [[nodiscard]] const LineArbiter::Stats&
+  stats() const {
+    return arbiter.stats();
+  }
+
+  [[nodiscard]] const dispatch::RxValidator::Stats&
+  validation_stats() const {
+    return validator.stats();
+  }
+
+  // Datagrams of the feed dropped because of an inconsistent udp length
+  [[nodiscard]] uint64_t
+  invalid_datagrams() const {
+    return invalid_datagrams_;
+  }
+
+private:
+  struct LineState {
+    dpdk::Device* device;
+    uint32_t group;
+    uint16_t port;
+  };
+
+  template<typename SequenceOf, typename OnMessage>
+  void
+  poll_line(Line line, base::SyncRdtscClock::time_point cycle, SequenceOf& sequence_of, OnMessage& on_message) {
+    auto& state = lines[static_cast<size_t>(line)];
+    auto burst = state.device->receive_burst();
+    if (burst.empty()) {
+      return;
+    }
+
+    std::array<const uint8_t*, dpdk::RxBurst::kMaxSize> packets;
+    for (size_t i = 0; i < burst.size(); ++i) {
+      packets[i] = burst.data(i);
+    }
+    dispatch::classify({packets.data(), burst.size()}, classification);
+
+    for (size_t i = 0; i < burst.size(); ++i) {
+      if (classification.classes[i] != dispatch::PacketClass::Udp || classification.dst_ip[i] != state.group ||
+          classification.dst_port[i] != state.port) {
+        continue;
+      }
+      if (!validator.validate(burst.bytes(i), burst.ol_flags(i), dispatch::PacketClass::Udp)) [[unlikely]] {
+        continue;
+      }
+      udp::PacketView datagram(burst.bytes(i));
+      // A udp length below the header size or beyond the ip payload would make the payload bogus
+      if (!datagram.is_valid()) [[unlikely]] {
+        invalid_datagrams_++;
+        continue;
+      }
+      const std::optional<uint64_t> seq = sequence_of(datagram.payload());
+      if (!seq) [[unlikely]] {
+        continue;
+      }
+      const auto received_at = shared_clock ? state.device->rx_timestamp(burst, i).value_or(cycle) : cycle;
+      if (arbiter.on_message(line, seq.value(), received_at) == LineArbiter::Verdict::Forward) {
+        on_message(datagram, line);
+      }
+    }
+  }
+
+  std::array<LineState, 2> lines;
+  // Both lines are queues of one port, their rx timestamps come from the same clock
+  bool shared_clock;
+  bool b_first{false};
+  LineArbiter arbiter;
+  dispatch::Classification classification;
+  dispatch::RxValidator validator;
+  uint64_t invalid_datagrams_{0};
+};
+
+} // namespace idk::net::feed
@@ -0,0 +1,89 @@
+#include "line_arbiter.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logger/macros.h"
+
+namespace idk::net::feed {
+
+LineArbiter::Verdict
+LineArbiter::on_message(Line line, uint64_t seq, time_point received_at) {
+  line_stats(line).received++;
+  track_line_gap(line, seq);
+
+  if (head != 0 && seq + kWindow < head) [[unlikely]] {
+    stats_.stale++;
+    return Verdict::Stale;
+  }
+
+  auto& current = slot(seq);
+  if (current.state == Slot::State::Seen && current.seq == seq) {
+    stats_.duplicates++;
+    if (current.line != line && !current.confirmed) {
+      current.confirmed = true;
+      const int64_t delay = std::chrono::nanoseconds(received_at - current.first_at).count();
+      if (delay == 0) {
+        stats_.ties++;
+        return Verdict::Duplicate;
+      }
+      // Stamped by the NIC, the copy which was forwarded may have arrived second
+      auto& winner = line_stats(delay > 0 ? current.line : line);
+      const int64_t margin = std::abs(delay);
+      winner.wins++;
+      winner.win_margin_ns += margin;
+      winner.max_win_margin_ns = std::max(winner.max_win_margin_ns, margin);
+    }
+    return Verdict::Duplicate;
+  }
+
+  if (seq >= head) {
+    advance(seq);
+  }
+  // Either a new message or a hole which is filled late
+  current = Slot{.seq = seq, .first_at = received_at, .state = Slot::State::Seen, .line = line};
+  stats_.forwarded++;
+  return Verdict::Forward;
+}
+
+void
+LineArbiter::track_line_gap(Line line, uint64_t seq) {
+  auto& next = line_next[static_cast<size_t>(line)];
+  if (next != 0 && seq > next) [[unlikely]] {
+    auto& stats = line_stats(line);
+    stats.gaps++;
+    stats.gap_messages += seq - next;
+    TRACE("Gap on line {}: expected {}, received {}", static_cast<int>(line), next, seq);
+  }
+  next = std::max(next, seq + 1);
+}
+
+void
+LineArbiter::advance(uint64_t seq) {
+  if (head == 0) {
+    head = seq + 1;
+    return;
+  }
+  // Sequence numbers jumped over are missing until one of the lines delivers them
+  if (seq - head >= kWindow) [[unlikely]] {
+    stats_.lost += seq - head - kWindow;
+    head = seq - kWindow;
+  }
+  for (; head < seq; ++head) {
+    auto& missing = slot(head);
+    retire(missing);
+    missing = Slot{.seq = head, .state = Slot::State::Missing};
+  }
+  retire(slot(seq));
+  head = seq + 1;
+}
+
+void
+LineArbiter::retire(Slot& slot) {
+  if (slot.state == Slot::State::Missing) {
+    stats_.lost++;
+  }
+  slot.state = Slot::State::Empty;
+}
+
+} // namespace idk::net::feed
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "base/clock/sync_rdtsc_clock.h"
+
+namespace idk::net::feed {
+
+enum class Line : uint8_t {
+  A = 0,
+  B = 1,
+};
+
+// A/B arbitration by feed sequence number. The first copy of every message is forwarded, the copy from the other line
+// is dropped and tells which line won and by how much. Copies which arrived at the same time as far as the clock can
+// tell are a tie, neither line wins. Sequence numbers are tracked in a sliding window, messages
+// older than the window can not be told apart from duplicates and are dropped as stale.
+class LineArbiter {
+public:
+  using time_point = base::SyncRdtscClock::time_point;
+
+  static constexpr size_t kWindow = 4096;
+
+  enum class Verdict : uint8_t {
+    Forward,
+    Duplicate,
+    Stale,
+  };
+
+  struct LineStats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t received{0};
+    // Messages this line delivered first while the other line delivered them too
+    uint64_t wins{0};
+    int64_t win_margin_ns{0};
+    int64_t max_win_margin_ns{0};
+    // Jumps in the sequence of this line, and the number of messages skipped by them
+    uint64_t gaps{0};
+    uint64_t gap_messages{0};
+  };
+
+  struct Stats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t forwarded{0};
+    uint64_t duplicates{0};
+    // Messages both lines delivered at the same time
+    uint64_t ties{0};
+    uint64_t stale{0};
+    // Messages none of the lines delivered within the window
+    uint64_t lost{0};
+    LineStats a;
+    LineStats b;
+  };
+
+  Verdict
+  on_message(Line line, uint64_t seq, time_point received_at);
+
+  [[nodiscard]] const Stats&
+  stats() const {
+    return stats_;
+  }
+
+private:
+  static_assert((kWindow & (kWindow - 1)) == 0);
+
+  struct Slot {
+    enum class State : uint8_t {
+      Empty,
+      Missing,
+      Seen,
+    };
+
+    uint64_t seq{0};
+    time_point first_at{};
+    State state{State::Empty};
+    Line line{Line::A};
+    bool confirmed{false};
+  };
+
+  LineStats&
+  line_stats(Line line) {
+    return line == Line::A ? stats_.a : stats_.b;
+  }
+
+  void
+  track_line_gap(Line line, uint64_t seq);
+
+  void
+  advance(uint64_t seq);
+
+  void
+  retire(Slot& slot);
+
+  Slot&
+  slot(uint64_t seq) {
+    return slots[seq & (kWindow - 1)];
+  }
+
+  std::array<Slot, kWindow> slots{};
+  std::array<uint64_t, 2> line_next{};
+  // Next sequence number after the highest one seen on any line, 0 until the first message
+  uint64_t head{0};
+  Stats stats_;
+};
+
+} // namespace idk::net::feed
@@ -1,4 +1,5 @@
 #pragma once
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -13,7 +14,9 @@ struct Interface {
   std::string driver;
   Mac mac;
   Ip ip;
+  // Used as the initial neighbour entry of the gateway when gateway_ip is set
   Mac gateway_mac;
+  std::optional<Ip> gateway_ip;
 
   std::string gateway_name = "default";
 };
@@ -0,0 +1,70 @@
+#include "link.h"
+
+#include <algorithm>
+
+#include "network/eth_ip/ethernet.h"
+
+namespace idk::net::sim {
+
+Link::Link(const LinkConfig& config) : config_(config), random(config.seed) {}
+
+double
+Link::uniform() {
+  return static_cast<double>(random() >> 11) * 0x1.0p-53;
+}
+
+void
+Link::send(base::ByteView frame, time_point now) {
+  stats_.sent++;
+  if (frame.size() > sizeof(EthernetHeader) + config_.mtu) {
+    stats_.oversize++;
+    return;
+  }
+
+  time_point departure = std::max(busy_until, now);
+  if (config_.bandwidth_bps > 0) {
+    const auto serialisation = std::chrono::nanoseconds(frame.size() * 8 * 1'000'000'000 / config_.bandwidth_bps);
+    departure += base::RdtscDuration(serialisation);
+    busy_until = departure;
+  }
+  // Lost frames still took their time on the wire
+  if (uniform() < config_.loss) {
+    stats_.lost++;
+    return;
+  }
+  stats_.bytes += frame.size();
+
+  time_point at = departure + base::RdtscDuration(config_.latency);
+  if (config_.jitter.count() > 0) {
+    const auto extra = static_cast<int64_t>(uniform() * static_cast<double>(config_.jitter.count()));
+    at += base::RdtscDuration(std::chrono::nanoseconds(extra));
+  }
+  if (uniform() < config_.reorder) {
+    stats_.reordered++;
+    at += base::RdtscDuration(config_.reorder_delay);
+  } else {
+    at = std::max(at, last_in_order);
+    last_in_order = at;
+  }
+  schedule(frame, at);
+
+  if (uniform() < config_.duplicate) {
+    stats_.duplicated++;
+    schedule(frame, at);
+  }
+}
+
+void
+Link::schedule(base::ByteView frame, time_point at) {
+  in_flight.push(Frame{.at = at, .sequence = sequence++, .bytes = {frame.begin(), frame.end()}});
+}
+
+std::optional<Link::time_point>
+Link::next_delivery() const {
+  if (in_flight.empty()) {
+    return std::nullopt;
+  }
+  return in_flight.top().at;
+}
+
+} // namespace idk::net::sim
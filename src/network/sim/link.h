@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/type/span.h"
+
+namespace idk::net::sim {
+
+// Impairments of one direction of a simulated link. Probabilities are per frame.
+struct LinkConfig {
+  static constexpr bool kLoggable = true;
+
+  // One way propagation delay
+  std::chrono::nanoseconds latency{std::chrono::microseconds(100)};
+  // Extra delay, uniform in [0, jitter]. Frames keep their order unless they are picked for reordering.
+  std::chrono::nanoseconds jitter{0};
+  double loss{0};
+  double duplicate{0};
+  // A reordered frame is held back by `reorder_delay`, so the frames sent after it overtake it
+  double reorder{0};
+  std::chrono::nanoseconds reorder_delay{std::chrono::microseconds(50)};
+  // Serialisation rate, zero is unlimited. Frames queue behind each other at the sender.
+  uint64_t bandwidth_bps{0};
+  // Largest ip packet, larger frames are dropped like a switch would
+  size_t mtu{1500};
+  // The same seed replays the same run
+  uint64_t seed{1};
+};
+
+// One direction of a simulated link: frames go in with `send` and come out of `deliver` once the virtual clock passes
+// their delivery time. Entirely deterministic, the random decisions come from a generator seeded by the config.
+class Link {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  struct Stats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t sent{0};
+    uint64_t delivered{0};
+    uint64_t lost{0};
+    uint64_t duplicated{0};
+    uint64_t reordered{0};
+    uint64_t oversize{0};
+    uint64_t bytes{0};
+  };
+
+  explicit Link(const LinkConfig& config);
+
+  // Copies `frame` (ethernet header included) into the link
+  void
+  send(base::ByteView frame, time_point now);
+
+  // Delivery time of the next frame, nullopt if the link is empty
+  [[nodiscard]] std::optional<time_point>
+  next_delivery() const;
+
+  // Calls `on_frame(frame)` for every frame due by `now`, in delivery order. Returns the number of frames.
+  template<typename F>
+  size_t
+  deliver(time_point now, F&& on_frame) {
+    size_t count = 0;
+    while (!in_flight.empty() && in_flight.top().at <= now) {
+      // The frame leaves the queue before the callback, which may send into the link again
+      Frame frame = std::move(const_cast<Frame&>(in_flight.top()));
+      in_flight.pop();
+      stats_.delivered++;
+      on_frame(base::ByteView{frame.bytes.data(), frame.bytes.size()});
+      ++count;
+    }
+    return count;
+  }
+
+  [[nodiscard]] const Stats&
+  stats() const {
+    return stats_;
+  }
+
+  [[nodiscard]] const LinkConfig&
+  config() const {
+    return config_;
+  }
+
+private:
+  struct Frame {
+    time_point at;
+    // Order of the sends, ties in `at` are delivered in it
+    uint64_t sequence;
+    std::vector<uint8_t> bytes;
+
+    bool
+    operator>(const Frame& other) const {
+      return at != other.at ? at > other.at : sequence > other.sequence;
+    }
+  };
+
+  // Uniform in [0, 1), the same sequence on every standard library
+  double
+  uniform();
+
+  void
+  schedule(base::ByteView frame, time_point at);
+
+  LinkConfig config_;
+  std::mt19937_64 random;
+  std::priority_queue<Frame, std::vector<Frame>, std::greater<>> in_flight;
+  // The sender's interface is busy serialising until then
+  time_point busy_until{};
+  // Delivery time of the last frame sent in order, jitter never makes a frame overtake it
+  time_point last_in_order{};
+  uint64_t sequence{0};
+  Stats stats_;
+};
+
+} // namespace idk::net::sim
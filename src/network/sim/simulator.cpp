@@ -0,0 +1,126 @@
+#include "simulator.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+#include "rte_eal.h"
+#include "rte_errno.h"
+#include "rte_eth_ring.h"
+#include "rte_ethdev.h"
+#include "rte_ring.h"
+
+namespace idk::net::sim {
+
+namespace {
+
+void
+init_eal() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    const char* eal_args[] = {"simulator", "--no-huge", "--no-pci", "--in-memory", "-l", "0", "--log-level=error"};
+    const int eal_argc = std::size(eal_args);
+    REQUIRE_EQ(rte_eal_init(eal_argc, const_cast<char**>(eal_args)), eal_argc - 1, "Failed to initialize EAL: {}",
+               rte_errno);
+  });
+}
+
+std::atomic<uint32_t> next_id{0};
+
+} // namespace
+
+Simulator::Simulator(const Config& config) :
+    links{Link(config.to_server), Link(config.to_client)}, now_(base::RdtscClock::now()) {
+  init_eal();
+  const uint32_t id = next_id++;
+  open(ends[kClient], id, kClient);
+  open(ends[kServer], id, kServer);
+  INFO("Simulator {}: to server {}, to client {}", id, config.to_server, config.to_client);
+}
+
+void
+Simulator::open(End& end, uint32_t id, Side side) {
+  const auto name = fmt::format("sim{}_{}", id, side == kClient ? "client" : "server");
+  // The simulator and the device are the only users of a ring
+  constexpr unsigned kRingFlags = RING_F_SP_ENQ | RING_F_SC_DEQ;
+  end.rx = rte_ring_create(fmt::format("{}_rx", name).c_str(), kRingSize, rte_socket_id(), kRingFlags);
+  end.tx = rte_ring_create(fmt::format("{}_tx", name).c_str(), kRingSize, rte_socket_id(), kRingFlags);
+  REQUIRE(end.rx && end.tx, "Failed to create the rings of {}", name);
+  const int port_id = rte_eth_from_rings(name.c_str(), &end.rx, 1, &end.tx, 1, rte_socket_id());
+  REQUIRE_GE(port_id, 0, "Failed to create ring port {}", name);
+  end.port_id = port_id;
+
+  // dpdk::Device finds its pool by the port
+  end.pool = rte_pktmbuf_pool_create(fmt::format("pool_{}", end.port_id).c_str(), kPoolSize, 256, 0,
+                                     RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+  REQUIRE(end.pool, "Failed to create the mbuf pool of {}", name);
+  rte_eth_conf port_conf{};
+  REQUIRE_EQ(rte_eth_dev_configure(end.port_id, 1, 1, &port_conf), 0, "Failed to configure {}", name);
+  REQUIRE_EQ(rte_eth_rx_queue_setup(end.port_id, 0, kRingSize, rte_socket_id(), nullptr, end.pool), 0,
+             "Failed to setup the rx queue of {}", name);
+  REQUIRE_EQ(rte_eth_tx_queue_setup(end.port_id, 0, kRingSize, rte_socket_id(), nullptr), 0,
+             "Failed to setup the tx queue of {}", name);
+  REQUIRE_EQ(rte_eth_dev_start(end.port_id), 0, "Failed to start {}", name);
+  end.device.emplace(name, end.port_id, name);
+}
+
+Simulator::~Simulator() {
+  for (auto& end: ends) {
+    end.device.reset();
+    rte_eth_dev_stop(end.port_id);
+    rte_eth_dev_close(end.port_id);
+    rte_ring_free(end.rx);
+    rte_ring_free(end.tx);
+    rte_mempool_free(end.pool);
+  }
+}
+
+Simulator::time_point
+Simulator::step(time_point until) {
+  transmit(ends[kClient], links[kClient]);
+  transmit(ends[kServer], links[kServer]);
+#ifdef IDK_SIMULATED_CLOCK
+  time_point next = until;
+  for (const auto& link: links) {
+    if (const auto at = link.next_delivery(); at && *at < next) {
+      next = *at;
+    }
+  }
+  now_ = std::max(now_, next);
+  base::RdtscClock::set_simulated_now(now_);
+#else
+  std::ignore = until;
+  now_ = base::RdtscClock::now();
+#endif
+  links[kClient].deliver(now_, [this](base::ByteView frame) { receive(ends[kServer], frame); });
+  links[kServer].deliver(now_, [this](base::ByteView frame) { receive(ends[kClient], frame); });
+  return now_;
+}
+
+void
+Simulator::transmit(End& end, Link& link) {
+  std::array<rte_mbuf*, 32> mbufs;
+  unsigned count;
+  while ((count = rte_ring_dequeue_burst(end.tx, reinterpret_cast<void**>(mbufs.data()), mbufs.size(), nullptr)) > 0) {
+    for (unsigned i = 0; i < count; ++i) {
+      link.send({rte_pktmbuf_mtod(mbufs[i], const uint8_t*), mbufs[i]->pkt_len}, now_);
+    }
+    // The sender may still own references, e.g. segments kept for retransmission
+    rte_pktmbuf_free_bulk(mbufs.data(), count);
+  }
+}
+
+void
+Simulator::receive(End& end, base::ByteView frame) {
+  rte_mbuf* mbuf = rte_pktmbuf_alloc(end.pool);
+  REQUIRE(mbuf, "Simulator mbuf pool is exhausted");
+  std::memcpy(rte_pktmbuf_append(mbuf, frame.size()), frame.data(), frame.size());
+  if (rte_ring_enqueue_burst(end.rx, reinterpret_cast<void* const*>(&mbuf), 1, nullptr) == 0) {
+    rx_overflows_++;
+    rte_pktmbuf_free(mbuf);
+  }
+}
+
+} // namespace idk::net::sim
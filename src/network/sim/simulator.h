@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/type/default_constructor.h"
+#include "network/dpdk/device.h"
+#include "link.h"
+
+struct rte_ring;
+
+namespace idk::net::sim {
+
+// Two dpdk::Devices joined by a simulated link, for running the stack in process against a scripted peer. Each end
+// is a DPDK ring port (net_ring), so the devices and everything built on them are the production code; the simulator
+// moves the frames between the rings through a Link per direction. EAL is initialised on first use without hugepages
+// or PCI devices.
+//
+// Linked through network::network_sim, base::RdtscClock reads the simulator's virtual clock, which jumps from one event
+// to the next: a run is deterministic and takes no longer than the host needs to compute it. Otherwise the links follow
+// the real clock.
+class Simulator : base::NoCopy {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  enum Side : uint8_t { kClient = 0, kServer = 1 };
+
+  struct Config {
+    LinkConfig to_server;
+    LinkConfig to_client;
+  };
+
+  explicit Simulator(const Config& config);
+
+  // The sessions using the devices must be gone by then, their mbufs come from the simulator's pools
+  ~Simulator();
+
+  [[nodiscard]] dpdk::Device&
+  device(Side side) {
+    return *ends[side].device;
+  }
+
+  // Moves the frames both devices sent onto the links, then advances the clock to the next delivery but not past
+  // `until` and hands the frames due to the receiving devices. Returns the new time.
+  time_point
+  step(time_point until);
+
+  [[nodiscard]] time_point
+  now() const {
+    return now_;
+  }
+
+  // Link carrying the frames sent by `side`
+  [[nodiscard]] const Link&
+  link(Side side) const {
+    return links[side];
+  }
+
+  // Frames dropped because the receiving device did not poll its queue
+  [[nodiscard]] uint64_t
+  rx_overflows() const {
+    return rx_overflows_;
+  }
+
+private:
+  static constexpr unsigned kRingSize = 1024;
+  static constexpr unsigned kPoolSize = 8191;
+
+  struct End {
+    rte_ring* rx{nullptr};
+    rte_ring* tx{nullptr};
+    rte_mempool* pool{nullptr};
+    uint16_t port_id{0};
+    std::optional<dpdk::Device> device;
+  };
+
+  void
+  open(End& end, uint32_t id, Side side);
+
+  // Frames sent by `end` go into `link`
+  void
+  transmit(End& end, Link& link);
+
+  // Frame delivered to `end`
+  void
+  receive(End& end, base::ByteView frame);
+
+  std::array<End, 2> ends;
+  std::array<Link, 2> links;
+  time_point now_;
+  uint64_t rx_overflows_{0};
+};
+
+} // namespace idk::net::sim
@@ -0,0 +1,126 @@
+#include "tls_server.h"
+
+#include <openssl/err.h>
+#include <openssl/x509.h>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+#include "network/tls12/openssl.h"
+
+namespace idk::net::sim {
+
+namespace {
+
+constexpr long kCertificateValidity = 24 * 60 * 60;
+
+tls12::X509Ptr
+self_signed_certificate(const std::string& host, EVP_PKEY* key) {
+  auto certificate = tls12::make_x509(X509_new());
+  REQUIRE(certificate, "X509_new failed");
+  X509_set_version(certificate.get(), X509_VERSION_3);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+  X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(certificate.get()), kCertificateValidity);
+  X509_set_pubkey(certificate.get(), key);
+  X509_NAME* name = X509_get_subject_name(certificate.get());
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(host.c_str()), -1, -1,
+                             0);
+  X509_set_issuer_name(certificate.get(), name);
+  REQUIRE_GT(X509_sign(certificate.get(), key, EVP_sha256()), 0, "Failed to sign the certificate");
+  return certificate;
+}
+
+// Generating a key takes long enough to stall a run on the real clock, the servers of a process share one
+EVP_PKEY*
+shared_key() {
+  static const auto key = tls12::make_evp_key(EVP_RSA_gen(2048));
+  REQUIRE(key, "Failed to generate the rsa key");
+  return key.get();
+}
+
+} // namespace
+
+void
+SslCtxDeleter::operator()(SSL_CTX* ptr) const noexcept {
+  SSL_CTX_free(ptr);
+}
+
+void
+SslDeleter::operator()(SSL* ptr) const noexcept {
+  SSL_free(ptr);
+}
+
+TlsServer::TlsServer(const std::string& host, tcp::Client tcp) : tcp_(std::move(tcp)) {
+  EVP_PKEY* key = shared_key();
+  const auto certificate = self_signed_certificate(host, key);
+
+  ctx.reset(SSL_CTX_new(TLS_server_method()));
+  REQUIRE(ctx, "SSL_CTX_new failed");
+  SSL_CTX_set_min_proto_version(ctx.get(), TLS1_2_VERSION);
+  SSL_CTX_set_max_proto_version(ctx.get(), TLS1_2_VERSION);
+  REQUIRE_EQ(SSL_CTX_set_cipher_list(ctx.get(), "ECDHE-RSA-AES128-GCM-SHA256"), 1, "No usable cipher");
+  REQUIRE_EQ(SSL_CTX_set1_groups_list(ctx.get(), "X25519"), 1, "No usable group");
+  REQUIRE_EQ(SSL_CTX_use_certificate(ctx.get(), certificate.get()), 1, "Failed to use the certificate");
+  REQUIRE_EQ(SSL_CTX_use_PrivateKey(ctx.get(), key), 1, "Failed to use the key");
+
+  ssl.reset(SSL_new(ctx.get()));
+  REQUIRE(ssl, "SSL_new failed");
+  input = BIO_new(BIO_s_mem());
+  output = BIO_new(BIO_s_mem());
+  SSL_set_bio(ssl.get(), input, output);
+  SSL_set_accept_state(ssl.get());
+}
+
+void
+TlsServer::feed(base::ByteView bytes) {
+  REQUIRE_EQ(BIO_write(input, bytes.data(), static_cast<int>(bytes.size())), static_cast<int>(bytes.size()),
+             "BIO_write failed");
+}
+
+base::ByteView
+TlsServer::drain() {
+  plaintext.clear();
+  if (!SSL_is_init_finished(ssl.get())) {
+    const int ret = SSL_do_handshake(ssl.get());
+    if (ret != 1) {
+      const int error = SSL_get_error(ssl.get(), ret);
+      REQUIRE(error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE, "Tls handshake failed: {}",
+              ERR_error_string(ERR_get_error(), nullptr));
+    } else {
+      DEBUG("Simulated tls server completed the handshake");
+    }
+  }
+  if (SSL_is_init_finished(ssl.get())) {
+    std::array<uint8_t, 16384> buffer;
+    int read;
+    while ((read = SSL_read(ssl.get(), buffer.data(), buffer.size())) > 0) {
+      plaintext.insert(plaintext.end(), buffer.begin(), buffer.begin() + read);
+    }
+  }
+  flush();
+  return {plaintext.data(), plaintext.size()};
+}
+
+void
+TlsServer::send(base::ByteView bytes) {
+  REQUIRE(is_handshake_complete(), "Tls handshake is not complete");
+  REQUIRE_EQ(SSL_write(ssl.get(), bytes.data(), static_cast<int>(bytes.size())), static_cast<int>(bytes.size()),
+             "SSL_write failed");
+  flush();
+}
+
+bool
+TlsServer::is_handshake_complete() const {
+  return SSL_is_init_finished(ssl.get());
+}
+
+void
+TlsServer::flush() {
+  std::array<uint8_t, 16384> buffer;
+  int read;
+  while ((read = BIO_read(output, buffer.data(), buffer.size())) > 0) {
+    tcp_.write({buffer.data(), static_cast<size_t>(read)});
+  }
+}
+
+} // namespace idk::net::sim
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <openssl/ssl.h>
+
+#include "base/type/default_constructor.h"
+#include "base/type/span.h"
+#include "network/dpdk/packet.h"
+#include "network/tcp/client.h"
+
+namespace idk::net::sim {
+
+struct SslCtxDeleter {
+  void
+  operator()(SSL_CTX* ptr) const noexcept;
+};
+
+struct SslDeleter {
+  void
+  operator()(SSL* ptr) const noexcept;
+};
+
+// Scripted tls 1.2 peer for the simulator. OpenSSL runs the server side of the handshake and the records over memory
+// BIOs, on top of a tcp connection accepted by tcp::Listener. The certificate is self-signed, tls12::Client does not
+// verify it. Offers only what tls12::Client speaks: ECDHE-RSA-AES128-GCM-SHA256 over X25519.
+class TlsServer : base::NoCopy {
+public:
+  TlsServer(const std::string& host, tcp::Client tcp);
+
+  // Passes a segment of the connection through tcp and OpenSSL, `on_data(bytes)` gets the decrypted application data
+  template<typename F>
+  void
+  process_packet(const dpdk::RxPacket& packet, F&& on_data) {
+    tcp_.set_receive_space(kReceiveSpace);
+    tcp_.process_packet(packet, [this](base::ByteView bytes, const dpdk::RxPacket&) { feed(bytes); });
+    const auto plaintext = drain();
+    if (!plaintext.empty()) {
+      on_data(plaintext);
+    }
+  }
+
+  // Encrypts `bytes` into records, they go out as the tcp windows allow
+  void
+  send(base::ByteView bytes);
+
+  [[nodiscard]] bool
+  is_handshake_complete() const;
+
+  void
+  on_burst_end() {
+    tcp_.on_burst_end();
+  }
+
+  [[nodiscard]] tcp::Client&
+  tcp() {
+    return tcp_;
+  }
+
+private:
+  static constexpr size_t kReceiveSpace = 1 << 20;
+
+  void
+  feed(base::ByteView bytes);
+
+  // Advances the handshake and decrypts what arrived, returns the plaintext
+  base::ByteView
+  drain();
+
+  // Hands what OpenSSL wrote to tcp
+  void
+  flush();
+
+  tcp::Client tcp_;
+  std::unique_ptr<SSL_CTX, SslCtxDeleter> ctx;
+  std::unique_ptr<SSL, SslDeleter> ssl;
+  // Owned by `ssl`
+  BIO* input{nullptr};
+  BIO* output{nullptr};
+  std::vector<uint8_t> plaintext;
+};
+
+} // namespace idk::net::sim
@@ -9,11 +9,13 @@
 #include <time.h>
 
 #include "packet_view.h"
+#include "timestamp_clock.h"
 
 namespace idk::net::tcp {
 
-Client::Client(Connection connection,  dpdk::Sender sender) :
-    connection(connection), sender(sender), send_wnd(kWindowSize) {
+template<CongestionControl Congestion>
+BasicClient<Congestion>::BasicClient(Connection connection,  dpdk::Sender sender, base::TimerWheel& timers) :
+    connection(connection), sender(sender), send_wnd(kWindowSize), timers(&timers) {
   state = State::Offline;
   unacknowledged_bytes = 0;
 
@@ -29,54 +31,491 @@ Client::Client(Connection connection,  dpdk::Sender sender) :
   peer_window_scale = 0;
 }
 
-Client::SendBuffer
-Client::get_send_buffer(Flags flags, bool include_options) {
+template<CongestionControl Congestion>
+BasicClient<Congestion>::BasicClient(const Accepted& accepted, dpdk::Sender sender, base::TimerWheel& timers) :
+    BasicClient(accepted.connection, sender, timers) {
+  state = State::Connected;
+  seq = accepted.iss + 1;
+  last_ack_number = seq;
+  ack = accepted.irs + 1;
+  last_ack_sent = ack;
+  establish(accepted.options);
+  send_wnd = uint32_t{accepted.window} << peer_window_scale;
+  prediction.set_window(accepted.window);
+  DEBUG("Connection {} accepted, mss: {}, sack: {}, timestamps: {}", connection, mss, sack_permitted, timestamps);
+}
+
+template<CongestionControl Congestion>
+BasicClient<Congestion>::BasicClient(BasicClient&& rhs) :
+    sender(std::move(rhs.sender)),
+    neighbours(rhs.neighbours),
+    next_hop(rhs.next_hop),
+    peer_window_scale(rhs.peer_window_scale),
+    receive_window(std::move(rhs.receive_window)),
+    sack_permitted(rhs.sack_permitted),
+    timestamps(rhs.timestamps),
+    ts_recent(rhs.ts_recent),
+    last_ack_sent(rhs.last_ack_sent),
+    unacknowledged_bytes(rhs.unacknowledged_bytes),
+    send_wnd(rhs.send_wnd),
+    last_ack_number(rhs.last_ack_number),
+    seq(rhs.seq),
+    ack(rhs.ack),
+    ip_id(rhs.ip_id),
+    state(std::exchange(rhs.state, State::Offline)),
+    connection(rhs.connection),
+    mss(rhs.mss),
+    reassembly(std::move(rhs.reassembly)),
+    send_queue(std::move(rhs.send_queue)),
+    retransmission(std::move(rhs.retransmission)),
+    rto(rhs.rto),
+    timers(rhs.timers),
+    persist_interval(rhs.persist_interval),
+    ack_policy(rhs.ack_policy),
+    ack_owed(rhs.ack_owed),
+    segments_to_ack(rhs.segments_to_ack),
+    corked(rhs.corked),
+    duplicate_acks(rhs.duplicate_acks),
+    retransmissions(rhs.retransmissions),
+    prediction(rhs.prediction),
+    header_prediction(rhs.header_prediction),
+    peer_window_closed(rhs.peer_window_closed),
+    stats_(rhs.stats_),
+    published(std::move(rhs.published)),
+    congestion(std::move(rhs.congestion)),
+    in_recovery(rhs.in_recovery),
+    recover(rhs.recover) {
+  // The timers are bound to the address of their client, they can't move along with the rest
+  take_timer<&BasicClient::on_rto_timeout>(rto_timer, rhs.rto_timer);
+  take_timer<&BasicClient::on_persist_timeout>(persist_timer, rhs.persist_timer);
+  take_timer<&BasicClient::on_delayed_ack_timeout>(delayed_ack_timer, rhs.delayed_ack_timer);
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::establish(const PeerOptions& options) {
+  if (options.window_scale.has_value()) {
+    peer_window_scale = options.window_scale.value();
+    // Scaling is in effect only if both sides sent the option (RFC 7323)
+    receive_window.enable_scaling();
+  }
+  mss = std::clamp(options.mss, kMinMss, kDefaultMss);
+  congestion = Congestion(mss);
+  sack_permitted = options.sack_permitted;
+  timestamps = options.timestamp.has_value();
+  if (timestamps) {
+    ts_recent = options.timestamp.value();
+  }
+  if (header_prediction) {
+    prediction.enable(timestamps);
+  }
+}
+
+template<CongestionControl Congestion>
+typename BasicClient<Congestion>::SendBuffer
+BasicClient<Congestion>::get_send_buffer(Flags flags, bool include_options) {
+  if (next_hop && next_hop->is_resolved()) {
+    connection.session.dst.mac = next_hop->mac;
+  }
   auto tx = sender->get_send_buffer();
   auto tcp = PacketView{tx.view()};
-  tcp.init(connection, flags, seq, ack, include_options);
+  std::optional<Timestamp> timestamp;
+  // The SYN always offers timestamps
+  if (timestamps || include_options) {
+    timestamp = Timestamp{.value = timestamp_clock(base::RdtscClock::now()), .echo = ts_recent};
+  }
+  tcp.init(connection, flags, seq, ack, include_options, timestamp);
+  if (include_options) {
+    tcp.syn_options().window_scale.shift = receive_window.offered_scale();
+  }
   tcp.ip().header().id = ip_id;
+  if (sack_permitted && !reassembly.empty()) [[unlikely]] {
+    append_sack(tcp);
+  }
   return {.tcp = tcp, .tx = std::move(tx)};
 }
 
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::append_sack(PacketView& tcp) const {
+  const size_t space = sizeof(Header) + kMaxOptionsSize - tcp.header().data_offset() - sizeof(SackOptionHeader);
+  std::array<SackBlock, kMaxSackBlocks> blocks;
+  const auto available = std::span(blocks).first(std::min(space / sizeof(SackBlock), blocks.size()));
+  tcp.append_sack(std::span(blocks).first(reassembly.sack_blocks(available)));
+}
+
+template<CongestionControl Congestion>
 void
-Client::send(SendBuffer packet, size_t payload_len) {
-  REQUIRE(unacknowledged_bytes + payload_len <= send_wnd, "window is full");
+BasicClient<Congestion>::send(SendBuffer packet, size_t payload_len) {
+  if (payload_len > 0 && (state != State::Connected || corked > 0 || !send_queue.empty() ||
+                          payload_len > max_payload(packet.tcp) || retransmission.full() ||
+                          unacknowledged_bytes + payload_len > send_window())) [[unlikely]] {
+    TRACE("Queueing {} bytes, {} in flight, window {}", payload_len, unacknowledged_bytes, send_window());
+    write(packet.tcp.payload().first(payload_len));
+    return;
+  }
+  send_segment(std::move(packet), payload_len);
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::write(base::ByteView bytes) {
+  if (send_queue.available_suffix_bytes() < bytes.size()) {
+    send_queue.shift();
+    if (send_queue.available_suffix_bytes() < bytes.size()) [[unlikely]] {
+      WARN("Send queue grows to {} bytes, the peer is not reading", send_queue.size() + bytes.size());
+      send_queue.reserve(std::max(send_queue.capacity() * 2, send_queue.size() + bytes.size()));
+    }
+  }
+  send_queue.push_bytes(bytes);
+  push_queued();
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::push_queued() {
+  while (!send_queue.empty() && state == State::Connected) {
+    const uint32_t window = send_window();
+    // A full retransmission queue closes the window like the peer would, small segments can fill it first
+    if (unacknowledged_bytes >= window || retransmission.full()) {
+      break;
+    }
+    auto packet = get_send_buffer(Flags::ACK);
+    const size_t len = std::min({send_queue.size(), max_payload(packet.tcp), size_t{window - unacknowledged_bytes}});
+    // Sender side silly window avoidance (RFC 1122 4.2.3.4): no tiny segment while the window is what limits it
+    if (len < send_queue.size() && len < max_payload(packet.tcp) && unacknowledged_bytes > 0) {
+      break;
+    }
+    // Corked, only full segments
+    if (corked > 0 && len < max_payload(packet.tcp)) {
+      break;
+    }
+    if (len == send_queue.size()) {
+      packet.tcp.header().flags = Flags::PSH_ACK;
+    }
+    std::ranges::copy(send_queue.pop(len).value(), packet.tcp.payload().begin());
+    send_segment(std::move(packet), len);
+  }
+  update_persist_timer();
+}
 
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::update_persist_timer() {
+  if (send_wnd > 0 || unacknowledged_bytes > 0 || send_queue.empty() || state != State::Connected) {
+    persist_timer.cancel();
+    return;
+  }
+  if (!persist_timer.is_armed()) {
+    persist_interval = rto.rto();
+    timers->arm<&BasicClient::on_persist_timeout>(
+        persist_timer, base::RdtscClock::now() + base::RdtscDuration(persist_interval), this);
+  }
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::on_persist_timeout() {
+  stats_.window_probes++;
+  DEBUG("Probing the closed window of {}, next probe in {}ns", connection, persist_interval.count());
+  // A segment below the window, which the peer has to acknowledge with its current window. It takes no sequence
+  // space, so the probes never time out the connection, the peer is alive as long as it answers.
+  auto packet = get_send_buffer(Flags::ACK);
+  packet.tcp.header().seq = seq - 1;
+  send_segment(std::move(packet), 0);
+  persist_interval = std::min<std::chrono::nanoseconds>(persist_interval * 2, RtoEstimator::kMaxRto);
+  timers->arm<&BasicClient::on_persist_timeout>(
+      persist_timer, base::RdtscClock::now() + base::RdtscDuration(persist_interval), this);
+  published->store(stats());
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::send_segment(SendBuffer packet, size_t payload_len) {
   auto tcp = packet.tcp;
+  // Every segment acknowledges everything received so far, so an owed ACK rides along with the data
+  tcp.header().ack = ack;
+  tcp.header().window = receive_window.advertised();
+  last_ack_sent = ack;
+  ack_owed = false;
+  segments_to_ack = 0;
+  delayed_ack_timer.cancel();
   tcp.resize_payload(payload_len);
   tcp.update_checksum();
   tcp.ip().update_checksum();
 
+  const auto flags = tcp.header().flags;
+  const uint32_t seq_length = payload_len + (has_flag(flags, Flags::SYN) || has_flag(flags, Flags::FIN) ? 1 : 0);
+  if (seq_length > 0) {
+    const auto now = base::RdtscClock::now();
+    retransmission.push(seq, seq_length, packet.tx.share(), now);
+    if (!rto_timer.is_armed()) {
+      restart_rto_timer(now);
+    }
+  }
+
   ip_id++;
   seq += payload_len;
   unacknowledged_bytes += payload_len;
+  stats_.segments_out++;
+  stats_.bytes_out += payload_len;
 
-  sender->send_raw(std::move(packet.tx), tcp.eth().raw_bytes().size());
+  transmit(std::move(packet.tx), tcp.eth().raw_bytes().size());
 }
 
+template<CongestionControl Congestion>
 void
-Client::process_packet(PacketView tcp_packet) {
-  REQUIRE(tcp_packet.is_valid(), "Tcp packet is not valid");
-  auto& hdr = tcp_packet.header();
-  REQUIRE(!has_flag(hdr.flags, Flags::RST), "rst received");
+BasicClient<Congestion>::uncork() {
+  REQUIRE_GT(corked, 0, "Connection is not corked");
+  if (--corked > 0) {
+    return;
+  }
+  push_queued();
+  // The ACK held back while corked, unless the data carried it
+  if ((ack_policy == AckPolicy::Coalesced || ack_policy == AckPolicy::Deferred) && ack_owed) {
+    send_ack();
+  }
+}
 
-  auto received_seq = hdr.seq.value();
-  auto received_ack = hdr.ack.value();
-  if (received_seq < ack && ack != 0) [[unlikely]] {
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::transmit(dpdk::TxPacket packet, size_t size) {
+  if (next_hop && !next_hop->is_resolved()) [[unlikely]] {
+    TRACE("Next hop {} is not resolved, holding the segment", next_hop->ip);
+    neighbours->hold(*next_hop, std::move(packet), size);
     return;
   }
-  REQUIRE(received_seq == ack || ack == 0, "Misses are not supported");
+  sender->send_raw(std::move(packet), size);
+}
 
-  uint32_t peer_rwnd = hdr.window.value() << peer_window_scale;
-  if (peer_rwnd > 0) {
-    send_wnd = peer_rwnd;
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::restart_rto_timer(base::RdtscClock::time_point now) {
+  timers->arm<&BasicClient::on_rto_timeout>(rto_timer, now + base::RdtscDuration(rto.rto()), this);
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::on_rto_timeout() {
+  if (retransmissions >= kMaxRetransmissions) [[unlikely]] {
+    // Not thrown, the timer wheel can not tell whose connection failed. The owner finds it Offline.
+    ERROR("Connection {} timed out, {} retransmissions without an ack", connection, retransmissions);
+    send_rst();
+    return;
+  }
+  stats_.rto_timeouts++;
+  if (retransmissions == 0) {
+    // Repeated timeouts of the same segment reduce the window only once
+    congestion.on_timeout(unacknowledged_bytes);
+    in_recovery = false;
+    recover = seq;
   }
+  retransmission.reset_holes();
+  retransmissions++;
+  rto.back_off();
+  DEBUG("Retransmission timeout, retransmitting {}, next rto {}ns", retransmission.front().seq,
+        rto.rto().count());
+  retransmit(retransmission.front());
+  restart_rto_timer(base::RdtscClock::now());
+  published->store(stats());
+}
 
-  REQUIRE_LE(last_ack_number, received_ack, "ack is not expected to decrease");
-  uint32_t bytes_acked = received_ack - last_ack_number;
-  REQUIRE_LE(bytes_acked, unacknowledged_bytes, "Unexpected bytes got acknowledged");
-  unacknowledged_bytes -= bytes_acked;
-  last_ack_number = received_ack;
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::schedule_ack(bool urgent) {
+  ack_owed = true;
+  segments_to_ack++;
+  switch (ack_policy) {
+    case AckPolicy::Immediate:
+      send_ack();
+      break;
+    case AckPolicy::Coalesced:
+      if (urgent) {
+        send_ack();
+      }
+      break;
+    case AckPolicy::Delayed:
+      if (urgent || segments_to_ack >= kDelayedAckSegments) {
+        send_ack();
+      } else if (!delayed_ack_timer.is_armed()) {
+        timers->arm<&BasicClient::on_delayed_ack_timeout>(
+            delayed_ack_timer, base::RdtscClock::now() + base::RdtscDuration(kDelayedAckTimeout), this);
+      }
+      break;
+    case AckPolicy::Deferred:
+      break;
+  }
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::send_ack() {
+  send(get_send_buffer(Flags::ACK));
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::on_delayed_ack_timeout() {
+  if (ack_owed) {
+    send_ack();
+  }
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::on_ack(SeqNumber received_ack, uint32_t bytes_acked, base::RdtscClock::time_point now,
+                                std::optional<uint32_t> echo) {
+  duplicate_acks = 0;
+  retransmissions = 0;
+  const auto rtt = retransmission.acknowledge(received_ack, now);
+  if (echo) {
+    // The echoed timestamp tells which transmission is acknowledged, so retransmissions are sampled too
+    rto.on_sample(std::chrono::microseconds(timestamp_clock(now) - echo.value()));
+    TRACE("rtt sample from timestamp: {}us, srtt: {}ns, rto: {}ns", timestamp_clock(now) - echo.value(),
+          rto.srtt().count(), rto.rto().count());
+  } else if (rtt) {
+    rto.on_sample(std::chrono::nanoseconds(rtt.value()));
+    TRACE("rtt sample: {}ns, srtt: {}ns, rto: {}ns", std::chrono::nanoseconds(rtt.value()).count(),
+          rto.srtt().count(), rto.rto().count());
+  }
+  if (!in_recovery) [[likely]] {
+    congestion.on_ack(bytes_acked, now, rto.srtt());
+  } else if (received_ack >= recover) {
+    DEBUG("Recovery complete at {}, cwnd {}", received_ack, congestion.cwnd());
+    in_recovery = false;
+  } else if (!retransmission.empty() && !retransmission.front().sacked) {
+    // Partial ack, the segment after the acknowledged data was lost as well (RFC 6582)
+    retransmit(retransmission.front());
+  }
+  if (retransmission.empty()) {
+    rto_timer.cancel();
+  } else {
+    restart_rto_timer(now);
+  }
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::on_duplicate_ack() {
+  stats_.duplicate_acks++;
+  if (++duplicate_acks < kDuplicateAckThreshold) {
+    return;
+  }
+  if (!in_recovery) {
+    stats_.fast_retransmits++;
+    in_recovery = true;
+    recover = seq;
+    congestion.on_loss(unacknowledged_bytes, base::RdtscClock::now());
+    retransmission.reset_holes();
+  }
+  if (retransmission.has_sacked()) {
+    // Only the ranges the peer reported missing go out, every duplicate ACK may uncover more of them
+    retransmission.for_each_hole([&](RetransmissionQueue::Segment& segment) {
+      DEBUG("Retransmitting sack hole {}, {} bytes", segment.seq, segment.length);
+      retransmit(segment);
+    });
+    return;
+  }
+  if (duplicate_acks == kDuplicateAckThreshold) {
+    DEBUG("Fast retransmit of {}", retransmission.front().seq);
+    retransmit(retransmission.front());
+  }
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::retransmit(RetransmissionQueue::Segment& segment) {
+  // The original mbuf may still be in the tx ring, so the refreshed segment goes out in a copy
+  auto copy = segment.packet.copy();
+  const auto size = copy.size();
+  PacketView tcp(copy.view());
+  tcp.header().ack = ack;
+  tcp.header().window = receive_window.advertised();
+  if (timestamps && !has_flag(tcp.header().flags, Flags::SYN)) {
+    auto& timestamp = tcp.fixed_timestamp();
+    timestamp.value = timestamp_clock(base::RdtscClock::now());
+    timestamp.echo = ts_recent;
+  }
+  tcp.header().checksum = 0;
+  tcp.update_checksum();
+  segment.retransmitted = true;
+  segment.hole_filled = true;
+  stats_.retransmitted_segments++;
+  stats_.segments_out++;
+  transmit(std::move(copy), size);
+}
+
+template<CongestionControl Congestion>
+base::ByteView
+BasicClient<Congestion>::process_segment(const dpdk::RxPacket& packet) {
+  stats_.segments_in++;
+  if (const auto payload = process_predicted(packet.bytes())) [[likely]] {
+    stats_.predicted++;
+    return payload.value();
+  }
+  PacketView tcp_packet(packet.bytes());
+  REQUIRE(tcp_packet.is_valid(), "Tcp packet is not valid");
+  auto& hdr = tcp_packet.header();
+  if (has_flag(hdr.flags, Flags::RST)) [[unlikely]] {
+    // Offline first, so the reset is not answered with one of ours when the client is destroyed
+    close();
+    REQUIRE(false, "rst received");
+  }
+
+  const SeqNumber received_seq = hdr.seq.value();
+  const SeqNumber received_ack = hdr.ack.value();
+  const auto options = hdr.data_offset() > sizeof(Header) ? tcp_packet.parse_options() : PacketView::Options{};
+
+  if (timestamps && options.timestamp) {
+    const uint32_t value = options.timestamp->value;
+    // PAWS, a segment older than the last one in sequence is a duplicate from a previous wrap of the sequence space
+    if (static_cast<int32_t>(value - ts_recent) < 0) [[unlikely]] {
+      DEBUG("PAWS: dropping segment {}, timestamp {} is older than {}", received_seq, value, ts_recent);
+      stats_.paws_drops++;
+      send_ack();
+      return {};
+    }
+    if (received_seq <= last_ack_sent) {
+      ts_recent = value;
+    }
+  }
+
+  // A reordered segment may carry an older ack, it must not move the window back
+  if (received_ack >= last_ack_number) {
+    prediction.set_window(hdr.window.value());
+    send_wnd = hdr.window.value() << peer_window_scale;
+    if (send_wnd > 0) {
+      peer_window_closed = false;
+    } else {
+      if (!peer_window_closed && (unacknowledged_bytes > 0 || !send_queue.empty())) {
+        peer_window_closed = true;
+        stats_.zero_window_stalls++;
+      }
+      // The peer answers, segments beyond its closed window are not lost to a dead connection
+      retransmissions = 0;
+    }
+
+    uint32_t bytes_acked = received_ack - last_ack_number;
+    REQUIRE_LE(bytes_acked, unacknowledged_bytes, "Unexpected bytes got acknowledged");
+    unacknowledged_bytes -= bytes_acked;
+    last_ack_number = received_ack;
+
+    for (const auto& block: options.sack()) {
+      retransmission.on_sack(block.left.value(), block.right.value());
+    }
+    if (bytes_acked > 0) {
+      std::optional<uint32_t> echo;
+      if (timestamps && options.timestamp && options.timestamp->echo != 0) {
+        echo = options.timestamp->echo;
+      }
+      on_ack(received_ack, bytes_acked, base::RdtscClock::now(), echo);
+    } else if (!retransmission.empty() && tcp_packet.payload().empty() && !has_flag(hdr.flags, Flags::SYN)) {
+      on_duplicate_ack();
+    }
+    if (!send_queue.empty()) [[unlikely]] {
+      push_queued();
+    }
+  }
 
   if (state == State::Connecting && hdr.flags == Flags::SYN_ACK) [[unlikely]] {
     DEBUG("State::CONNECTED");
@@ -85,22 +524,110 @@ Client::process_packet(PacketView tcp_packet) {
     seq += 1;
     last_ack_number = received_ack;
 
-    auto options = tcp_packet.parse_options();
-    if (options.window_scale.has_value()) {
-      peer_window_scale = options.window_scale.value();
-      DEBUG("Window scale received from server: {}", peer_window_scale);
+    PeerOptions peer{.window_scale = options.window_scale, .sack_permitted = options.sack_permitted};
+    // Without the option the peer accepts 536 bytes (RFC 9293 3.7.1)
+    peer.mss = options.mss.value_or(kDefaultIpv4Mss);
+    if (options.timestamp) {
+      peer.timestamp = options.timestamp->value;
     }
+    establish(peer);
+    DEBUG("Mss: {}, window scale: {}, ours: {}, sack permitted by server: {}, timestamps: {}", mss, peer_window_scale,
+          receive_window.offered_scale(), sack_permitted, timestamps);
     send(get_send_buffer(Flags::ACK));
-    return;
+    push_queued();
+    return {};
+  }
+  if (state != State::Connected) [[unlikely]] {
+    return {};
+  }
+  if (has_flag(hdr.flags, Flags::SYN)) [[unlikely]] {
+    // Retransmitted SYN-ACK, our ACK was lost
+    send(get_send_buffer(Flags::ACK));
+    return {};
   }
-  if (state == State::Connected && !tcp_packet.payload().empty()) {
-    ack = received_seq + tcp_packet.payload().size();
+
+  base::ByteView payload = tcp_packet.payload();
+  if (payload.empty()) {
+    // A segment before the window is a window probe or a keepalive, the answer carries our window (RFC 9293 3.10.7.4)
+    if (received_seq < ack) [[unlikely]] {
+      send(get_send_buffer(Flags::ACK));
+    }
+    return {};
+  }
+  if (received_seq > ack) [[unlikely]] {
+    TRACE("Out of order segment {}, expected {}", received_seq, ack);
+    reassembly.insert(received_seq, payload, packet.share());
+    stats_.out_of_order++;
     send(get_send_buffer(Flags::ACK));
+    return {};
   }
+  const uint32_t already_received = ack - received_seq;
+  if (already_received >= payload.size()) [[unlikely]] {
+    TRACE("Retransmitted segment {}, expected {}", received_seq, ack);
+    stats_.duplicate_segments++;
+    send(get_send_buffer(Flags::ACK));
+    return {};
+  }
+  payload = payload.subspan(already_received);
+  ack += payload.size();
+  return payload;
 }
 
+template<CongestionControl Congestion>
+std::optional<base::ByteView>
+BasicClient<Congestion>::process_predicted(base::ByteView frame) {
+  const auto segment = prediction.classify(frame, ack, last_ack_number, seq);
+  if (segment.kind == HeaderPrediction::Kind::Miss) {
+    return {};
+  }
+  std::optional<uint32_t> echo;
+  if (timestamps) {
+    // PAWS failures take the general path, which drops the segment
+    if (static_cast<int32_t>(segment.timestamp.value - ts_recent) < 0) [[unlikely]] {
+      return {};
+    }
+    // The segment starts at `ack`
+    if (ack <= last_ack_sent) {
+      ts_recent = segment.timestamp.value;
+    }
+    if (segment.timestamp.echo != 0) {
+      echo = segment.timestamp.echo;
+    }
+  }
+  if (segment.kind == HeaderPrediction::Kind::Data) {
+    ack += segment.payload.size();
+    return segment.payload;
+  }
+  const SeqNumber received_ack = segment.ack;
+  const uint32_t bytes_acked = received_ack - last_ack_number;
+  unacknowledged_bytes -= bytes_acked;
+  last_ack_number = received_ack;
+  on_ack(received_ack, bytes_acked, base::RdtscClock::now(), echo);
+  if (!send_queue.empty()) [[unlikely]] {
+    push_queued();
+  }
+  return base::ByteView{};
+}
+
+template<CongestionControl Congestion>
+ClientStats
+BasicClient<Congestion>::stats() const {
+  ClientStats current = stats_;
+  current.cwnd = congestion.cwnd();
+  current.ssthresh = congestion.ssthresh();
+  current.send_window = send_window();
+  current.flight_size = unacknowledged_bytes;
+  current.queued_bytes = send_queue.size();
+  current.receive_window = receive_window.space_bytes();
+  current.srtt_ns = rto.srtt().count();
+  current.rttvar_ns = rto.rttvar().count();
+  current.rto_ns = rto.rto().count();
+  return current;
+}
+
+template<CongestionControl Congestion>
 void
-Client::connect() {
+BasicClient<Congestion>::connect() {
   auto packet = sender->get_send_buffer();
   state = State::Connecting;
   send(get_send_buffer(Flags::SYN, true), 0);
@@ -108,12 +635,33 @@ Client::connect() {
   DEBUG("syn sent");
 }
 
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::set_next_hop(arp::NeighbourTable& table, Ip next_hop_ip) {
+  neighbours = &table;
+  next_hop = &table.track(next_hop_ip);
+}
+
+template<CongestionControl Congestion>
 void
-Client::send_rst() {
+BasicClient<Congestion>::send_rst() {
   auto packet = sender->get_send_buffer();
   DEBUG("Sending RST");
   send(get_send_buffer(Flags::RST));
+  close();
+}
+
+template<CongestionControl Congestion>
+void
+BasicClient<Congestion>::close() {
   state = State::Offline;
+  prediction.disable();
+  rto_timer.cancel();
+  persist_timer.cancel();
+  delayed_ack_timer.cancel();
 }
 
+template class BasicClient<NewReno>;
+template class BasicClient<Cubic>;
+
 } // namespace idk::base
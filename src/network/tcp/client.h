@@ -1,33 +1,80 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <utility>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
 #include "../../base/stream/stream.h"
+#include "base/thread/seqlock.h"
+#include "base/timer/timer_wheel.h"
+#include "base/type/default_constructor.h"
+#include "congestion_control.h"
 #include "flags.h"
+#include "handshake.h"
+#include "header_prediction.h"
+#include "network/arp/neighbour_table.h"
 #include "network/dpdk/sender.h"
 #include "network/type/ip.h"
 #include "network/type/mac.h"
 #include "packet_view.h"
+#include "reassembly_queue.h"
+#include "receive_window.h"
+#include "retransmission_queue.h"
+#include "rto_estimator.h"
 #include "seq_number.h"
+#include "stats.h"
 
 namespace idk::net::tcp {
 
-class Client {
+enum class AckPolicy : uint8_t {
+  // Every data segment is acknowledged right away
+  Immediate,
+  // One cumulative ACK for all the data of an rx burst, sent from `on_burst_end`
+  Coalesced,
+  // RFC 1122 delayed ACK: every second segment or after kDelayedAckTimeout
+  Delayed,
+  // The ACK is only recorded while the packet is processed and sent from `on_data_consumed`, so building it is off
+  // the path between the NIC and the application
+  Deferred,
+};
+
+// Tcp client connection. `Congestion` is the congestion control algorithm, a template parameter so that the calls on
+// every ack are dispatched statically. Use the `Client` alias below unless a specific algorithm is needed.
+template<CongestionControl Congestion>
+class BasicClient {
 public:
   static constexpr int kWindowSize = 65535;
+  static constexpr uint16_t kDefaultMss = 1460;
+  static constexpr uint16_t kDefaultIpv4Mss = 536;
+  // A smaller peer mss is raised to it, it would leave next to no room for payload beside the options
+  static constexpr uint16_t kMinMss = 128;
+  // The client stops being writable once this much data waits in the send queue
+  static constexpr size_t kSendQueueSize = 256 * 1024;
+  static constexpr size_t kInitialReceiveBuffer = 64 * 1024;
+  static constexpr size_t kMaxReceiveBuffer = 4 * 1024 * 1024;
+  static constexpr uint8_t kDuplicateAckThreshold = 3;
+  static constexpr uint8_t kMaxRetransmissions = 15;
+  static constexpr uint8_t kDelayedAckSegments = 2;
+  static constexpr std::chrono::milliseconds kDelayedAckTimeout{40};
   enum class State {
     Offline,
     Connecting,
     Connected,
   };
 
-  Client(Connection connection, dpdk::Sender sender);
+  // Retransmission and the other tcp timers run on `timers`, which must outlive the client
+  BasicClient(Connection connection, dpdk::Sender sender, base::TimerWheel& timers);
 
-  Client(Client&&) = default;
+  // Connection established by a passive open, it starts in State::Connected
+  BasicClient(const Accepted& accepted, dpdk::Sender sender, base::TimerWheel& timers);
 
-  ~Client() {
+  // The connection and its armed timers go to the new client, the moved-from one is left Offline
+  BasicClient(BasicClient&& rhs);
+
+  ~BasicClient() {
     if (get_state() == State::Connected) {
       DEBUG("Sending RST packet");
       send_rst();
@@ -42,18 +89,131 @@ public:
   [[nodiscard]] SendBuffer
   get_send_buffer(Flags flags, bool include_options = false);
 
+  // Sends the segment built in `packet`. A payload which can't go out as it is, because the windows are full, it is
+  // larger than the peer's mss or queued data is ahead of it, is moved to the send queue instead.
   void
   send(SendBuffer packet, size_t payload_len = 0);
 
+  // Queues `bytes`, they go out in segments of the peer's mss as the send and congestion windows open. The queue
+  // grows past kSendQueueSize when needed, the application should stop writing while the client is not `writable`.
+  void
+  write(base::ByteView bytes);
+
+  [[nodiscard]] bool
+  writable() const {
+    return send_queue.size() < kSendQueueSize;
+  }
+
+  [[nodiscard]] size_t
+  queued_bytes() const {
+    return send_queue.size();
+  }
+
+  // Batches small writes (TCP_CORK). While corked, payload is queued and only full mss segments go out; the rest and
+  // a coalesced or deferred ACK follow on `uncork`, so messages sent in one go share segments. Calls nest, see Cork.
   void
-  process_packet(PacketView tcp_packet);
+  cork() {
+    corked++;
+  }
+
+  void
+  uncork();
+
+  [[nodiscard]] bool
+  is_corked() const {
+    return corked > 0;
+  }
+
+  // Payload the segment from `get_send_buffer` can carry, the peer's mss includes the tcp options (RFC 6691)
+  [[nodiscard]] size_t
+  max_payload(PacketView& tcp) const {
+    return std::min<size_t>(mss - (tcp.header().data_offset() - sizeof(Header)), tcp.payload().size());
+  }
+
+  // Calls `on_data(bytes, packet)` for every chunk of in-order payload, including queued segments the packet made
+  // contiguous. `bytes` point into `packet`, so the receiver may keep a reference to the mbuf instead of copying.
+  // Out-of-order segments are queued without a copy and answered with a duplicate ACK. In-order data is acknowledged
+  // according to the ack policy.
+  template<typename F>
+  void
+  process_packet(const dpdk::RxPacket& packet, F&& on_data) {
+    const SeqNumber expected = ack;
+    const auto payload = process_segment(packet);
+    if (payload.empty()) {
+      return;
+    }
+    on_data(payload, packet);
+    bool filled_gap = false;
+    if (!reassembly.empty()) [[unlikely]] {
+      const auto next = reassembly.drain(ack, on_data);
+      filled_gap = next != ack;
+      ack = next;
+    }
+    stats_.bytes_in += ack - expected;
+    receive_window.on_delivered(ack - expected, base::RdtscClock::now(), rto.srtt());
+    // A segment which fills a gap is acknowledged at once, the peer is likely in fast retransmit
+    schedule_ack(filled_gap);
+  }
+
+  // Free space of the buffer the data is pushed into, the advertised window follows it. Must be updated before every
+  // packet, delivered data is subtracted until then.
+  void
+  set_receive_space(size_t free_bytes) {
+    receive_window.set_space(free_bytes);
+  }
+
+  // Size the receive buffer should grow to, autotuned from the delivery rate
+  [[nodiscard]] size_t
+  receive_buffer_target() const {
+    return receive_window.buffer_target();
+  }
+
+  void
+  set_ack_policy(AckPolicy policy) {
+    ack_policy = policy;
+  }
+
+  // On by default. Without it every segment takes the general processing, e.g. to measure what the prediction saves.
+  void
+  set_header_prediction(bool enabled) {
+    header_prediction = enabled;
+    if (!enabled) {
+      prediction.disable();
+    } else if (state == State::Connected) {
+      prediction.enable(timestamps);
+    }
+  }
+
+  // Called once the application has handled the data of a packet
+  void
+  on_data_consumed() {
+    if (ack_policy == AckPolicy::Deferred && ack_owed && corked == 0) {
+      send_ack();
+    }
+  }
+
+  // Sends the ACK coalesced over the rx burst, or a deferred one still owed. Called once the whole burst is processed.
+  void
+  on_burst_end() {
+    if ((ack_policy == AckPolicy::Coalesced || ack_policy == AckPolicy::Deferred) && ack_owed && corked == 0) {
+      send_ack();
+    }
+    published->store(stats());
+  }
 
   void
   connect();
 
+  // Resolves the destination mac through `neighbours` instead of using the one from the connection. Segments sent
+  // before `next_hop_ip` is resolved are parked in the table and go out once the reply arrives.
+  void
+  set_next_hop(arp::NeighbourTable& neighbours, Ip next_hop_ip);
+
+  // Aborts the connection, it goes Offline
   void
   send_rst();
 
+  // Offline once the connection is reset by either side or times out, owners poll it to notice a dead connection
   State
   get_state() const {
     return state;
@@ -63,10 +223,112 @@ public:
   get_connection() const {
     return connection;
   }
+
+  // Current stats, owner thread only
+  [[nodiscard]] ClientStats
+  stats() const;
+
+  // Stats as of the end of the last rx burst, readable from any thread. The lock stays in place when the client is
+  // moved.
+  [[nodiscard]] const base::SeqLock<ClientStats>&
+  published_stats() const {
+    return *published;
+  }
 private:
+  // Handles the header and returns the part of the payload which continues the byte stream
+  base::ByteView
+  process_segment(const dpdk::RxPacket& packet);
+
+  // Fast path for the segments matching the header prediction, nullopt if the general processing is needed
+  std::optional<base::ByteView>
+  process_predicted(base::ByteView frame);
+
+  // Applies the options negotiated in the handshake
+  void
+  establish(const PeerOptions& options);
+
+  // Goes Offline and stops the timers, nothing is sent anymore
+  void
+  close();
+
+  // `echo` is the timestamp echoed by the peer, if any
+  void
+  on_ack(SeqNumber received_ack, uint32_t bytes_acked, base::RdtscClock::time_point now,
+         std::optional<uint32_t> echo);
+
+  void
+  on_duplicate_ack();
+
+  // Retransmits the oldest unacknowledged segment
+  void
+  on_rto_timeout();
+
+  // Probes the closed window of the peer (RFC 9293 3.8.6.1)
+  void
+  on_persist_timeout();
+
+  // The persist timer runs while data waits for a closed window and nothing is in flight, which would arm the
+  // retransmission timer. Without it a lost window update would stall the connection for good.
+  void
+  update_persist_timer();
+
+  void
+  schedule_ack(bool urgent);
+
+  void
+  send_ack();
+
+  void
+  on_delayed_ack_timeout();
+
+  void
+  restart_rto_timer(base::RdtscClock::time_point now);
+
+  // Arms `timer` of this client where the armed `from` of a moved client would fire, and cancels `from`
+  template<void (BasicClient::*Method)()>
+  void
+  take_timer(base::Timer& timer, base::Timer& from) {
+    if (from.is_armed()) {
+      timers->arm<Method>(timer, from.deadline(), this);
+      from.cancel();
+    }
+  }
+
+  void
+  retransmit(RetransmissionQueue::Segment& segment);
+
+  // Reports the out-of-order queue to the peer
+  void
+  append_sack(PacketView& tcp) const;
+
+  void
+  send_segment(SendBuffer packet, size_t payload_len);
+
+  // Cuts segments off the send queue while the windows allow
+  void
+  push_queued();
+
+  // Data in flight is bounded by both the peer's window and the congestion window
+  [[nodiscard]] uint32_t
+  send_window() const {
+    return std::min(send_wnd, congestion.cwnd());
+  }
+
+  // Sends the packet or parks it until the next hop is resolved
+  void
+  transmit(dpdk::TxPacket packet, size_t size);
+
   std::optional<dpdk::Sender> sender;
+  arp::NeighbourTable* neighbours{nullptr};
+  const arp::Neighbour* next_hop{nullptr};
 
   uint8_t peer_window_scale;
+  ReceiveWindow receive_window{kInitialReceiveBuffer, kMaxReceiveBuffer};
+  bool sack_permitted{false};
+  // RFC 7323 timestamps are negotiated. `ts_recent` is the peer timestamp to echo.
+  bool timestamps{false};
+  uint32_t ts_recent{0};
+  SeqNumber last_ack_sent;
   uint32_t unacknowledged_bytes;
   uint32_t send_wnd;
   SeqNumber last_ack_number;
@@ -76,7 +338,73 @@ private:
 
   State state;
   Connection connection;
-  uint16_t mss;
+  uint16_t mss{kDefaultMss};
+  ReassemblyQueue reassembly;
+
+  base::Stream send_queue{kSendQueueSize};
+  RetransmissionQueue retransmission;
+  RtoEstimator rto;
+  base::TimerWheel* timers;
+  base::Timer rto_timer;
+  base::Timer persist_timer;
+  // Interval of the next window probe, backed off like the rto
+  std::chrono::nanoseconds persist_interval{0};
+
+  AckPolicy ack_policy{AckPolicy::Immediate};
+  // Data was received and no segment carried the ACK for it yet
+  bool ack_owed{false};
+  uint8_t segments_to_ack{0};
+  base::Timer delayed_ack_timer;
+  // Depth of the nested `cork` calls
+  uint8_t corked{0};
+  uint8_t duplicate_acks{0};
+  uint8_t retransmissions{0};
+  HeaderPrediction prediction;
+  bool header_prediction{true};
+  bool peer_window_closed{false};
+
+  ClientStats stats_;
+  std::unique_ptr<base::SeqLock<ClientStats>> published{std::make_unique<base::SeqLock<ClientStats>>()};
+
+  Congestion congestion{kDefaultMss};
+  // RFC 6582 fast recovery lasts until everything sent before it started, up to `recover`, is acknowledged
+  bool in_recovery{false};
+  SeqNumber recover;
+};
+
+extern template class BasicClient<NewReno>;
+extern template class BasicClient<Cubic>;
+
+// The congestion control of every connection, chosen at compile time
+using Client = BasicClient<Cubic>;
+
+// Keeps `session` (a tcp, tls or wss client) corked for the lifetime of the scope. Uncorking sends, so it can throw:
+// call `uncork` at the end of the scope to see the error, the destructor only logs it.
+template<typename Session>
+class Cork : base::NoCopy {
+public:
+  explicit Cork(Session& session) : session(&session) {
+    session.cork();
+  }
+
+  ~Cork() {
+    if (session == nullptr) {
+      return;
+    }
+    try {
+      session->uncork();
+    } catch (const std::exception& e) {
+      ERROR("Uncorking at the end of the scope failed: {}", e.what());
+    }
+  }
+
+  void
+  uncork() {
+    std::exchange(session, nullptr)->uncork();
+  }
+
+private:
+  Session* session;
 };
 
 
@@ -0,0 +1,97 @@
+#include "congestion_control.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logger/macros.h"
+
+namespace idk::net::tcp {
+
+NewReno::NewReno(uint32_t mss) : mss(mss), cwnd_(kInitialWindowSegments * mss) {}
+
+void
+NewReno::on_ack(uint32_t acked, time_point, std::chrono::nanoseconds) {
+  if (cwnd_ < ssthresh_) {
+    cwnd_ += std::min(acked, kSlowStartLimitSegments * mss);
+    return;
+  }
+  // One segment per window of acknowledged data
+  bytes_acked += acked;
+  if (bytes_acked >= cwnd_) {
+    bytes_acked -= cwnd_;
+    cwnd_ += mss;
+  }
+}
+
+void
+NewReno::on_loss(uint32_t flight_size, time_point) {
+  // The window is not inflated by the duplicate acks, it drops to ssthresh right away
+  ssthresh_ = std::max(flight_size / 2, 2 * mss);
+  cwnd_ = ssthresh_;
+  bytes_acked = 0;
+  DEBUG("NewReno loss, cwnd {}, ssthresh {}", cwnd_, ssthresh_);
+}
+
+void
+NewReno::on_timeout(uint32_t flight_size) {
+  ssthresh_ = std::max(flight_size / 2, 2 * mss);
+  cwnd_ = mss;
+  bytes_acked = 0;
+}
+
+Cubic::Cubic(uint32_t mss) : mss(mss), segments(NewReno::kInitialWindowSegments) {}
+
+void
+Cubic::on_ack(uint32_t bytes_acked, time_point now, std::chrono::nanoseconds srtt) {
+  const double acked = static_cast<double>(bytes_acked) / mss;
+  if (cwnd() < ssthresh_) {
+    segments += std::min<double>(acked, NewReno::kSlowStartLimitSegments);
+    return;
+  }
+  if (!epoch) {
+    epoch = now;
+    if (segments < w_max) {
+      k = std::cbrt((w_max - segments) / kC);
+    } else {
+      k = 0;
+      w_max = segments;
+    }
+    w_est = segments;
+  }
+  const std::chrono::nanoseconds elapsed = now - *epoch;
+  const double t = std::chrono::duration<double>(elapsed).count();
+  const double rtt = std::chrono::duration<double>(srtt).count();
+
+  w_est += kAlpha * acked / segments;
+  if (kC * std::pow(t - k, 3) + w_max < w_est) {
+    // Reno-friendly region
+    segments = w_est;
+    return;
+  }
+  // The window aims at the value the cubic function reaches one rtt later
+  const double target = std::clamp(kC * std::pow(t + rtt - k, 3) + w_max, segments, 1.5 * segments);
+  segments += (target - segments) / segments * acked;
+}
+
+void
+Cubic::reduce() {
+  epoch.reset();
+  // Fast convergence: a flow losing below its previous maximum releases bandwidth to the newer flows
+  w_max = segments < w_max ? segments * (1 + kBeta) / 2 : segments;
+  segments = std::max(segments * kBeta, 2.0);
+  ssthresh_ = cwnd();
+}
+
+void
+Cubic::on_loss(uint32_t, time_point) {
+  reduce();
+  DEBUG("Cubic loss, cwnd {}, ssthresh {}, w_max {:.1f} segments", cwnd(), ssthresh_, w_max);
+}
+
+void
+Cubic::on_timeout(uint32_t) {
+  reduce();
+  segments = 1;
+}
+
+} // namespace idk::net::tcp
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+
+#include "base/clock/rdtsc_clock.h"
+
+namespace idk::net::tcp {
+
+// Congestion control policy of tcp::BasicClient. The policy is a template parameter, so the calls on every ack are
+// resolved at compile time. Windows are in bytes, `flight_size` is the amount of data sent and not acknowledged yet.
+template<typename T>
+concept CongestionControl =
+    std::constructible_from<T, uint32_t> &&
+    requires(T cc, uint32_t bytes, base::RdtscClock::time_point now, std::chrono::nanoseconds srtt) {
+      // New data is cumulatively acknowledged outside of loss recovery
+      cc.on_ack(bytes, now, srtt);
+      // Fast retransmit, once per recovery episode
+      cc.on_loss(bytes, now);
+      cc.on_timeout(bytes);
+      { cc.cwnd() } -> std::same_as<uint32_t>;
+      { cc.ssthresh() } -> std::same_as<uint32_t>;
+    };
+
+// RFC 5681 slow start and congestion avoidance with the recovery of RFC 6582, which is driven by the client. The
+// window grows by the bytes acknowledged (RFC 3465, L = 2) rather than by the number of acks, the peer acks a whole
+// burst at once.
+class NewReno {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  // RFC 6928
+  static constexpr uint32_t kInitialWindowSegments = 10;
+  static constexpr uint32_t kSlowStartLimitSegments = 2;
+
+  explicit NewReno(uint32_t mss);
+
+  void
+  on_ack(uint32_t bytes_acked, time_point now, std::chrono::nanoseconds srtt);
+
+  void
+  on_loss(uint32_t flight_size, time_point now);
+
+  void
+  on_timeout(uint32_t flight_size);
+
+  [[nodiscard]] uint32_t
+  cwnd() const {
+    return cwnd_;
+  }
+
+  [[nodiscard]] uint32_t
+  ssthresh() const {
+    return ssthresh_;
+  }
+
+private:
+  uint32_t mss;
+  uint32_t cwnd_;
+  uint32_t ssthresh_{UINT32_MAX};
+  // Bytes acknowledged in congestion avoidance since the window last grew
+  uint32_t bytes_acked{0};
+};
+
+// RFC 9438. The window follows a cubic function of the time since the last loss, centered on the window the loss
+// happened at, so it recovers fast after a reduction and probes carefully around the previous maximum. Below the
+// estimate of a Reno flow it grows like Reno. Slow start is the one of NewReno.
+class Cubic {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  static constexpr double kC = 0.4;
+  static constexpr double kBeta = 0.7;
+  // Reno-friendly additive increase for kBeta
+  static constexpr double kAlpha = 3 * (1 - kBeta) / (1 + kBeta);
+
+  explicit Cubic(uint32_t mss);
+
+  void
+  on_ack(uint32_t bytes_acked, time_point now, std::chrono::nanoseconds srtt);
+
+  void
+  on_loss(uint32_t flight_size, time_point now);
+
+  void
+  on_timeout(uint32_t flight_size);
+
+  [[nodiscard]] uint32_t
+  cwnd() const {
+    return static_cast<uint32_t>(segments * mss);
+  }
+
+  [[nodiscard]] uint32_t
+  ssthresh() const {
+    return ssthresh_;
+  }
+
+private:
+  // Multiplicative decrease with fast convergence, shared by loss and timeout
+  void
+  reduce();
+
+  uint32_t mss;
+  // The window is kept in segments, the cubic function is defined on them
+  double segments;
+  uint32_t ssthresh_{UINT32_MAX};
+  // Window before the last reduction, the plateau of the cubic function
+  double w_max{0};
+  // Time for the window to climb back to `w_max`, in seconds
+  double k{0};
+  // Window of a Reno flow started at the same epoch
+  double w_est{0};
+  // Start of the current congestion avoidance period
+  std::optional<time_point> epoch;
+};
+
+static_assert(CongestionControl<NewReno>);
+static_assert(CongestionControl<Cubic>);
+
+} // namespace idk::net::tcp
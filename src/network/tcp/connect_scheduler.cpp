@@ -0,0 +1,37 @@
+#include "connect_scheduler.h"
+
+#include <algorithm>
+
+#include "base/macros/require.h"
+
+namespace idk::net::tcp {
+
+ConnectScheduler::ConnectScheduler(Config config) : config(config) {
+  REQUIRE_GT(config.syn_rate, 0, "syn_rate must be positive");
+  REQUIRE_GT(config.syn_burst, 0, "syn_burst must be positive");
+  REQUIRE_GT(config.max_in_flight, 0, "max_in_flight must be positive");
+  syn_interval = std::chrono::nanoseconds(std::chrono::seconds(1)) / config.syn_rate;
+  burst_allowance = syn_interval * (config.syn_burst - 1);
+}
+
+void
+ConnectScheduler::request(uint32_t key, time_point not_before) {
+  attempts.push({.not_before = not_before, .order = requested++, .key = key});
+}
+
+void
+ConnectScheduler::finished() {
+  REQUIRE_GT(in_flight_, 0, "No attempt in flight");
+  in_flight_--;
+}
+
+base::RdtscDuration
+ConnectScheduler::backoff(uint32_t failures) const {
+  if (failures == 0) {
+    return {};
+  }
+  const uint32_t doublings = std::min<uint32_t>(failures - 1, 16);
+  return std::min(config.retry_backoff * (1 << doublings), config.max_retry_backoff);
+}
+
+} // namespace idk::net::tcp
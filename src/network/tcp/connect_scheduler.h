@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+
+namespace idk::net::tcp {
+
+// Decides when connection attempts start, so that many connections come up together from one poll loop without
+// flooding the peer with SYNs. Attempts start at most `syn_rate` per second, `syn_burst` of them back to back after a
+// quiet period (generic cell rate algorithm), at most `max_in_flight` handshakes run at once and a retried attempt
+// waits a backoff which doubles with every failure. Attempts are identified by a key of the owner's choosing.
+class ConnectScheduler {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  struct Config {
+    uint32_t syn_rate{100};
+    uint32_t syn_burst{8};
+    uint32_t max_in_flight{32};
+    // After the first failure, doubled for each further one up to `max_retry_backoff`
+    std::chrono::milliseconds retry_backoff{100};
+    std::chrono::milliseconds max_retry_backoff{10000};
+  };
+
+  explicit ConnectScheduler(Config config);
+
+  // Queues an attempt for `key` which starts no earlier than `not_before`. Attempts due at the same time start in the
+  // order they were requested.
+  void
+  request(uint32_t key, time_point not_before);
+
+  // The key of an attempt which may start at `now`, it counts as in flight until `finished`
+  [[nodiscard]] std::optional<uint32_t>
+  next(time_point now) {
+    if (attempts.empty() || in_flight_ >= config.max_in_flight || attempts.top().not_before > now) [[likely]] {
+      return {};
+    }
+    if (now + burst_allowance < theoretical_arrival) {
+      return {};
+    }
+    theoretical_arrival = std::max(theoretical_arrival, now) + syn_interval;
+    const uint32_t key = attempts.top().key;
+    attempts.pop();
+    in_flight_++;
+    return key;
+  }
+
+  // The handshake of an attempt returned by `next` completed or failed
+  void
+  finished();
+
+  // Delay of the attempt following `failures` consecutive failed ones
+  [[nodiscard]] base::RdtscDuration
+  backoff(uint32_t failures) const;
+
+  [[nodiscard]] size_t
+  queued() const {
+    return attempts.size();
+  }
+
+  [[nodiscard]] uint32_t
+  in_flight() const {
+    return in_flight_;
+  }
+
+private:
+  struct Attempt {
+    time_point not_before;
+    uint64_t order;
+    uint32_t key;
+
+    bool
+    operator>(const Attempt& rhs) const {
+      return not_before != rhs.not_before ? not_before > rhs.not_before : order > rhs.order;
+    }
+  };
+
+  Config config;
+  base::RdtscDuration syn_interval;
+  // How far ahead of the steady rate the SYNs of a burst may go
+  base::RdtscDuration burst_allowance;
+  std::priority_queue<Attempt, std::vector<Attempt>, std::greater<>> attempts;
+  // When the next SYN is due at the steady rate
+  time_point theoretical_arrival{};
+  uint64_t requested{0};
+  uint32_t in_flight_{0};
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,33 @@
+#include "connection_manager.h"
+
+#include "base/logger/macros.h"
+
+namespace idk::net::tcp {
+
+void
+send_reset(dpdk::Sender& sender, const dpdk::RxPacket& packet) {
+  PacketView segment(packet.bytes());
+  const auto& header = segment.header();
+  if (has_flag(header.flags, Flags::RST)) {
+    return;
+  }
+  const Connection reply = segment.reply_connection();
+  TRACE("Resetting unknown flow {}", reply);
+
+  auto tx = sender.get_send_buffer();
+  PacketView rst(tx.view());
+  if (has_flag(header.flags, Flags::ACK)) {
+    rst.init(reply, Flags::RST, header.ack.value(), 0);
+  } else {
+    const uint32_t length = segment.payload().size() + (has_flag(header.flags, Flags::SYN) ? 1 : 0) +
+                            (has_flag(header.flags, Flags::FIN) ? 1 : 0);
+    rst.init(reply, Flags::RST_ACK, 0, header.seq.value() + length);
+  }
+  rst.header().window = 0;
+  rst.resize_payload(0);
+  rst.update_checksum();
+  rst.ip().update_checksum();
+  sender.send_raw(std::move(tx), rst.eth().raw_bytes().size());
+}
+
+} // namespace idk::net::tcp
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <bitset>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "base/macros/require.h"
+#include "base/type/default_constructor.h"
+#include "network/dispatch/dispatcher.h"
+#include "network/dispatch/flow_table.h"
+#include "network/dpdk/sender.h"
+#include "listener.h"
+#include "packet_view.h"
+
+namespace idk::net::tcp {
+
+// Answers a segment of an unknown flow with a RST (RFC 793, reset generation). RSTs are not answered.
+void
+send_reset(dpdk::Sender& sender, const dpdk::RxPacket& segment);
+
+// Owns the tcp sessions of a worker (tcp::Client or anything built on top of it, e.g. wss::Client) and
+// demultiplexes segments to them by 4-tuple. Segments of unknown flows are reset, unless they go to a listening port.
+template<typename Session>
+class ConnectionManager : base::NoCopy {
+public:
+  static constexpr size_t kMaxConnections = 1024;
+
+  explicit ConnectionManager(dpdk::Sender sender) : sender(sender), flows(2 * kMaxConnections) {
+    sessions.reserve(kMaxConnections);
+    keys.reserve(kMaxConnections);
+    touched_sessions.reserve(kMaxConnections);
+  }
+
+  // Constructs a session in place, `connection` is its local view. Sessions are never moved, their timers point to
+  // them.
+  template<typename... Args>
+  Session&
+  add(const Connection& connection, Args&&... args) {
+    uint32_t idx = sessions.size();
+    if (!free_slots.empty()) {
+      idx = free_slots.back();
+    } else {
+      REQUIRE_LT(sessions.size(), kMaxConnections, "Too many connections");
+    }
+    const auto key = dispatch::FlowKey::incoming(connection);
+    REQUIRE(flows.insert(key, idx), "Connection {} already exists", connection);
+    auto session = std::make_unique<Session>(std::forward<Args>(args)...);
+    if (idx == sessions.size()) {
+      sessions.push_back(std::move(session));
+      keys.push_back(key);
+    } else {
+      free_slots.pop_back();
+      sessions[idx] = std::move(session);
+      keys[idx] = key;
+    }
+    DEBUG("Connection {} added, {} in total", connection, size());
+    return *sessions[idx];
+  }
+
+  // Destroys the session of `connection`, its later segments are reset as any unknown flow. May be called from
+  // `on_packet`, also for the session being processed once it is done with it.
+  void
+  remove(const Connection& connection) {
+    const uint32_t idx = flows.find(dispatch::FlowKey::incoming(connection));
+    REQUIRE_NE(idx, dispatch::FlowTable::kNotFound, "Connection {} does not exist", connection);
+    erase(idx);
+    DEBUG("Connection {} removed, {} left", connection, size());
+  }
+
+  // A session whose `on_packet` or `on_burst_end` threw goes to `on_failure(session, error)`, the rest of the burst is
+  // processed still. The callback may `remove` the session. Without one the session is removed at once.
+  void
+  on_failure(std::function<void(Session&, const std::exception&)> callback) {
+    on_failure_ = std::move(callback);
+  }
+
+  // Segments of unknown flows to `listener.port()` go to `listener`, which must outlive the manager. Once a handshake
+  // completes `on_accept` is called and is expected to `add` the session, the final ACK is then processed by it.
+  void
+  listen(Listener& listener, std::function<void(const Accepted&)> on_accept) {
+    listener_ = &listener;
+    on_accept_ = std::move(on_accept);
+  }
+
+  // Routes the tcp segments without a route of their own in `dispatcher` here, see `process`
+  template<typename F>
+  void
+  attach(dispatch::Dispatcher& dispatcher, F on_packet) {
+    dispatcher.on_unknown_tcp([this, on_packet = std::move(on_packet)](std::span<dpdk::RxPacket> packets,
+                                                                      std::span<const uint32_t> flow_hashes) mutable {
+      process(packets, on_packet, flow_hashes);
+    });
+  }
+
+  // Calls `on_packet(session, packet)` for every segment of a known flow. Every session which got a segment is told
+  // that the burst is over afterwards. A session which throws fails alone, see `on_failure`. `flow_hashes` are the
+  // `dispatch::flow_hash` of the packets if they are known already, otherwise they are computed here.
+  template<typename F>
+  void
+  process(std::span<dpdk::RxPacket> packets, F&& on_packet, std::span<const uint32_t> flow_hashes = {}) {
+    // Left over by the previous burst, also if accepting a session threw
+    for (const uint32_t idx: touched_sessions) {
+      touched.reset(idx);
+    }
+    touched_sessions.clear();
+    for (size_t i = 0; i < packets.size(); ++i) {
+      auto& packet = packets[i];
+      const auto key = key_of(packet);
+      const uint32_t hash = flow_hashes.empty() ? key.hash() : flow_hashes[i];
+      uint32_t idx = flows.find(key, hash);
+      if (idx == dispatch::FlowTable::kNotFound) [[unlikely]] {
+        idx = accept(packet, key, hash);
+        if (idx == dispatch::FlowTable::kNotFound) {
+          continue;
+        }
+      }
+      try {
+        on_packet(*sessions[idx], packet);
+      } catch (const std::exception& e) {
+        fail(idx, e);
+      }
+      if (!touched.test(idx)) {
+        touched.set(idx);
+        touched_sessions.push_back(idx);
+      }
+    }
+    // Only the sessions of the burst are visited, not all of them
+    for (const uint32_t idx: touched_sessions) {
+      if (sessions[idx] != nullptr) {
+        try {
+          sessions[idx]->on_burst_end();
+        } catch (const std::exception& e) {
+          fail(idx, e);
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] size_t
+  size() const {
+    return sessions.size() - free_slots.size();
+  }
+
+  // In the order of `add` as long as nothing was removed
+  Session&
+  operator[](size_t idx) {
+    return *sessions[idx];
+  }
+
+  // Segments of unknown flows
+  [[nodiscard]] uint64_t
+  unknown() const {
+    return unknown_;
+  }
+
+private:
+  void
+  erase(uint32_t idx) {
+    flows.erase(keys[idx]);
+    sessions[idx].reset();
+    free_slots.push_back(idx);
+  }
+
+  // May be called for a slot emptied earlier in the burst
+  void
+  fail(uint32_t idx, const std::exception& e) {
+    if (sessions[idx] == nullptr) {
+      return;
+    }
+    if (on_failure_) {
+      on_failure_(*sessions[idx], e);
+      return;
+    }
+    ERROR("Session failed, removing it: {}", e.what());
+    erase(idx);
+  }
+
+  // Index of the session the listener established for `packet`, if any
+  uint32_t
+  accept(const dpdk::RxPacket& packet, const dispatch::FlowKey& key, uint32_t hash) {
+    if (listener_ == nullptr || PacketView(packet.bytes()).header().dst_port != listener_->port()) {
+      unknown_++;
+      send_reset(sender, packet);
+      return dispatch::FlowTable::kNotFound;
+    }
+    const auto accepted = listener_->process_packet(packet);
+    if (!accepted.has_value()) {
+      return dispatch::FlowTable::kNotFound;
+    }
+    on_accept_(accepted.value());
+    return flows.find(key, hash);
+  }
+
+  static dispatch::FlowKey
+  key_of(const dpdk::RxPacket& packet) {
+    const PacketView segment(packet.bytes());
+    const auto& ip = segment.ip().header();
+    const auto& header = segment.header();
+    return {
+        .src_ip = ip.src_addr.data(),
+        .dst_ip = ip.dst_addr.data(),
+        .ports = header.src_port.as_big_endian() | (uint32_t{header.dst_port.as_big_endian()} << 16),
+    };
+  }
+
+  dpdk::Sender sender;
+  dispatch::FlowTable flows;
+  // Slots of removed sessions are empty until `add` reuses them
+  std::vector<std::unique_ptr<Session>> sessions;
+  // Flow of every slot
+  std::vector<dispatch::FlowKey> keys;
+  std::vector<uint32_t> free_slots;
+  // Sessions which got a segment of the current burst, as a set and in order
+  std::bitset<kMaxConnections> touched;
+  std::vector<uint32_t> touched_sessions;
+  Listener* listener_{nullptr};
+  std::function<void(const Accepted&)> on_accept_;
+  std::function<void(Session&, const std::exception&)> on_failure_;
+  uint64_t unknown_{0};
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "network/type/endpoint.h"
+#include "seq_number.h"
+
+namespace idk::net::tcp {
+
+// Options the peer sent during the three-way handshake
+struct PeerOptions {
+  // RFC 9293 default when the option is missing
+  uint16_t mss{536};
+  // Window scaling is on if both sides sent the option
+  std::optional<uint8_t> window_scale;
+  bool sack_permitted{false};
+  // Last timestamp of the peer, timestamps are on if set
+  std::optional<uint32_t> timestamp;
+};
+
+// Connection established by a passive open, see tcp::Listener
+struct Accepted {
+  // Local view: src is this host
+  Connection connection;
+  // Our initial sequence number and the peer's one
+  SeqNumber iss;
+  SeqNumber irs;
+  // Raw window field of the segment which completed the handshake
+  uint16_t window;
+  PeerOptions options;
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "base/type/span.h"
+#include "base/type/start_lifetime_as.h"
+#include "network/eth_ip/ethernet.h"
+#include "network/eth_ip/ip.h"
+#include "flags.h"
+#include "model.h"
+#include "seq_number.h"
+
+namespace idk::net::tcp {
+
+// Van Jacobson header prediction (TCP/IP Illustrated vol. 2, 28.4). Once a connection is established nearly every
+// segment is either the next in-order data acknowledging nothing new, or a pure ack of new data, and it carries the
+// same flags, window and options layout as the previous one. Such segments are recognised on the raw frame with a few
+// compares at fixed offsets and skip the general processing.
+class HeaderPrediction {
+public:
+  static constexpr size_t kTcpOffset = sizeof(EthernetHeader) + sizeof(IpHeader);
+
+  enum class Kind : uint8_t {
+    // Needs the general processing
+    Miss,
+    // The next in-order data, nothing new is acknowledged
+    Data,
+    // No data, new data is acknowledged
+    Ack,
+  };
+
+  struct Segment {
+    Kind kind{Kind::Miss};
+    SeqNumber ack;
+    base::ByteView payload;
+    // Valid if the connection uses timestamps
+    Timestamp timestamp{};
+  };
+
+  // Segments are predicted from now on. `timestamps` tells whether every segment carries the RFC 7323 appendix A
+  // layout, otherwise segments have no options.
+  void
+  enable(bool timestamps) {
+    timestamps_ = timestamps;
+    data_offset = sizeof(Header) + (timestamps ? sizeof(TimestampBlock) : 0);
+  }
+
+  void
+  disable() {
+    data_offset = 0;
+  }
+
+  // Raw window of the last processed segment
+  void
+  set_window(uint16_t window) {
+    window_ = window;
+  }
+
+  // `rcv_nxt` is the next sequence number expected, `snd_una` the oldest unacknowledged and `snd_nxt` the next one
+  // to send
+  [[nodiscard]] Segment
+  classify(base::ByteView frame, SeqNumber rcv_nxt, SeqNumber snd_una, SeqNumber snd_nxt) const {
+    if (frame.size() < kTcpOffset + data_offset) [[unlikely]] {
+      return {};
+    }
+    const auto& ip = *base::start_lifetime_as<IpHeader>(frame.data() + sizeof(EthernetHeader));
+    const auto& hdr = *base::start_lifetime_as<Header>(frame.data() + kTcpOffset);
+    const size_t ip_size = ip.total_length.value();
+    if (ip.ihl != sizeof(IpHeader) / 4 || hdr.data_offset_scaled * 4 != data_offset ||
+        (hdr.flags & ~Flags::PSH) != Flags::ACK || hdr.window.value() != window_ || hdr.seq.value() != rcv_nxt ||
+        ip_size < sizeof(IpHeader) + data_offset || sizeof(EthernetHeader) + ip_size > frame.size()) {
+      return {};
+    }
+    Segment segment{.ack = hdr.ack.value(),
+                    .payload = frame.subspan(kTcpOffset + data_offset, ip_size - sizeof(IpHeader) - data_offset)};
+    if (!segment.payload.empty()) {
+      segment.kind = segment.ack == snd_una ? Kind::Data : Kind::Miss;
+    } else {
+      segment.kind = segment.ack > snd_una && segment.ack <= snd_nxt ? Kind::Ack : Kind::Miss;
+    }
+    if (timestamps_ && segment.kind != Kind::Miss) {
+      const auto& block = *base::start_lifetime_as<TimestampBlock>(frame.data() + kTcpOffset + sizeof(Header));
+      // NOP, NOP, kind and length in one compare
+      if (std::memcmp(&block, &kDefaultTimestampBlock, sizeof(OptionHeader) + block.padding.size()) != 0) {
+        return {};
+      }
+      segment.timestamp = {.value = block.option.value.value(), .echo = block.option.echo.value()};
+    }
+    return segment;
+  }
+
+private:
+  // Zero never matches, the prediction is off until `enable`
+  size_t data_offset{0};
+  uint16_t window_{0};
+  bool timestamps_{false};
+};
+
+} // namespace idk::net::tcp
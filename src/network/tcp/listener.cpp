@@ -0,0 +1,106 @@
+#include "listener.h"
+
+#include <cstring>
+
+#include "base/logger/macros.h"
+#include "client.h"
+#include "connection_manager.h"
+#include "timestamp_clock.h"
+
+namespace idk::net::tcp {
+
+Listener::Listener(Port port, dpdk::Sender sender) :
+    port_(port), sender(sender),
+    window_scale(ReceiveWindow(Client::kInitialReceiveBuffer, Client::kMaxReceiveBuffer).offered_scale()) {}
+
+std::optional<Accepted>
+Listener::process_packet(const dpdk::RxPacket& packet) {
+  PacketView segment(packet.bytes());
+  const auto& header = segment.header();
+  if (has_flag(header.flags, Flags::RST)) {
+    return std::nullopt;
+  }
+  const Connection connection = segment.reply_connection();
+  const auto now = base::RdtscClock::now();
+  if ((header.flags & Flags::SYN_ACK) == Flags::SYN) {
+    stats_.syns++;
+    send_syn_ack(segment, connection, now);
+    return std::nullopt;
+  }
+  if (has_flag(header.flags, Flags::SYN) || !has_flag(header.flags, Flags::ACK)) {
+    reset(packet);
+    return std::nullopt;
+  }
+
+  const SeqNumber irs{header.seq.value().value() - 1};
+  const SeqNumber iss{header.ack.value().value() - 1};
+  const auto mss = cookies.decode(connection, irs, iss, now);
+  if (!mss.has_value()) {
+    TRACE("Invalid cookie from {}", connection);
+    stats_.bad_cookies++;
+    reset(packet);
+    return std::nullopt;
+  }
+
+  Accepted accepted{
+      .connection = connection,
+      .iss = iss,
+      .irs = irs,
+      .window = header.window.value(),
+      .options = {.mss = mss.value()},
+  };
+  // The SYN-ACK timestamp carried the options the SYN offered, the peer echoes it
+  if (const auto timestamp = segment.parse_options().timestamp) {
+    const auto options = SynCookies::decode_options(timestamp->echo);
+    accepted.options.window_scale = options.window_scale;
+    accepted.options.sack_permitted = options.sack_permitted;
+    accepted.options.timestamp = timestamp->value;
+  }
+  stats_.accepted++;
+  DEBUG("Accepted {}, mss: {}", connection, accepted.options.mss);
+  return accepted;
+}
+
+void
+Listener::send_syn_ack(PacketView& syn, const Connection& connection, SynCookies::time_point now) {
+  const auto& header = syn.header();
+  const auto options = syn.parse_options();
+  const SeqNumber peer_isn = header.seq.value();
+  const SeqNumber cookie = cookies.encode(connection, peer_isn, options.mss.value_or(Client::kDefaultIpv4Mss), now);
+
+  // Without timestamps there is nowhere to keep the window scale and SACK, they are not offered
+  std::optional<Timestamp> timestamp;
+  if (options.timestamp.has_value()) {
+    const SynCookies::Options offered{.window_scale = options.window_scale, .sack_permitted = options.sack_permitted};
+    timestamp = Timestamp{.value = SynCookies::encode_options(timestamp_clock(now), offered),
+                          .echo = options.timestamp->value};
+  }
+
+  auto tx = sender.get_send_buffer();
+  PacketView reply(tx.view());
+  reply.init(connection, Flags::SYN_ACK, cookie, peer_isn + 1, true, timestamp);
+  auto& block = reply.syn_options();
+  block.window_scale.shift = window_scale;
+  if (!timestamp.has_value()) {
+    std::memset(&block.timestamp, OptionsBlock::kNoOperationByte, sizeof(block.timestamp));
+  }
+  if (!timestamp.has_value() || !options.sack_permitted) {
+    std::memset(&block.sack_permitted, OptionsBlock::kNoOperationByte, sizeof(block.sack_permitted));
+  }
+  if (!timestamp.has_value() || !options.window_scale.has_value()) {
+    std::memset(&block.window_scale, OptionsBlock::kNoOperationByte, sizeof(block.window_scale));
+  }
+  reply.resize_payload(0);
+  reply.update_checksum();
+  reply.ip().update_checksum();
+  TRACE("Sending SYN-ACK to {}, cookie: {}", connection, cookie);
+  sender.send_raw(std::move(tx), reply.eth().raw_bytes().size());
+}
+
+void
+Listener::reset(const dpdk::RxPacket& packet) {
+  stats_.resets++;
+  send_reset(sender, packet);
+}
+
+} // namespace idk::net::tcp
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "base/type/default_constructor.h"
+#include "network/dpdk/sender.h"
+#include "network/type/port.h"
+#include "handshake.h"
+#include "packet_view.h"
+#include "syn_cookie.h"
+
+namespace idk::net::tcp {
+
+// Passive open on a local port. SYNs are answered with a SYN cookie and forgotten, so a SYN flood costs no memory; the
+// connection exists only once the final ACK returns a valid cookie. The application then constructs a tcp::Client
+// (or anything built on top of it) from the Accepted and drives it like an actively opened one, see
+// ConnectionManager::listen.
+class Listener : base::NoCopy {
+public:
+  struct Stats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t syns{0};
+    uint64_t accepted{0};
+    // Final ACKs with a forged or expired cookie
+    uint64_t bad_cookies{0};
+    uint64_t resets{0};
+  };
+
+  Listener(Port port, dpdk::Sender sender);
+
+  // Handles a segment of an unknown flow to `port()`. Returns the connection once the handshake completes, the
+  // segment must then be passed to the new session too, as the final ACK may carry data.
+  [[nodiscard]] std::optional<Accepted>
+  process_packet(const dpdk::RxPacket& packet);
+
+  [[nodiscard]] Port
+  port() const {
+    return port_;
+  }
+
+  [[nodiscard]] const Stats&
+  stats() const {
+    return stats_;
+  }
+
+private:
+  void
+  send_syn_ack(PacketView& syn, const Connection& connection, SynCookies::time_point now);
+
+  void
+  reset(const dpdk::RxPacket& packet);
+
+  Port port_;
+  dpdk::Sender sender;
+  SynCookies cookies;
+  // Shift offered in the SYN-ACK, the one the accepted client will scale its windows with
+  uint8_t window_scale;
+  Stats stats_;
+};
+
+} // namespace idk::net::tcp
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "network/tcp/flags.h"
 #include "network/type/big_endian.h"
 #include "network/type/port.h"
@@ -65,22 +67,59 @@ struct WindowScaleOption {
   uint8_t shift;
 };
 
+struct TimestampOption {
+  OptionHeader header;
+  BE<uint32_t> value;
+  BE<uint32_t> echo;
+};
+
+// Options of the SYN
 struct OptionsBlock {
   static constexpr uint8_t kNoOperationByte = 1;
   static constexpr uint8_t kTerminationByte = 0;
   MssOption mss;
   SackPermittedOption sack_permitted;
+  TimestampOption timestamp;
+  uint8_t no_operation{kNoOperationByte};
   WindowScaleOption window_scale;
-  std::array<uint8_t, 3> term_and_padding_{kTerminationByte};
 };
 
-static_assert(sizeof(OptionsBlock) == 12);
+static_assert(sizeof(OptionsBlock) == 20);
+
+// Options of every other segment once timestamps are negotiated, laid out as in RFC 7323 appendix A. The header is
+// always 32 bytes, so the timestamp sits at a fixed offset.
+struct TimestampBlock {
+  std::array<uint8_t, 2> padding{OptionsBlock::kNoOperationByte, OptionsBlock::kNoOperationByte};
+  TimestampOption option;
+};
+
+static_assert(sizeof(TimestampBlock) == 12);
+
+struct SackBlock {
+  BE<SeqNumber> left;
+  // First sequence number after the block
+  BE<SeqNumber> right;
+};
+
+// Padded with two NOPs, so the blocks are 4 byte aligned
+struct SackOptionHeader {
+  std::array<uint8_t, 2> padding{OptionsBlock::kNoOperationByte, OptionsBlock::kNoOperationByte};
+  OptionHeader header;
+};
+
+static_assert(sizeof(SackOptionHeader) == 4);
 
 #pragma pack(pop)
 
 constexpr OptionHeader kMssOptionHeader = {.kind = 2, .length = 4};
 constexpr OptionHeader kSackPermittedOptionHeader = {.kind = 4, .length = 2};
 constexpr OptionHeader kWindowScaleOptionHeader = {.kind = 3, .length = 3};
+constexpr OptionHeader kSackOptionHeader = {.kind = 5, .length = 2};
+constexpr OptionHeader kTimestampOptionHeader = {.kind = 8, .length = 10};
+
+constexpr size_t kMaxOptionsSize = 40;
+// Options are limited to 40 bytes, which leaves room for 4 blocks
+constexpr size_t kMaxSackBlocks = 4;
 
 constexpr MssOption kDefaultMssOption = {.header = kMssOptionHeader, .mss = 1460};
 constexpr SackPermittedOption kSackPermittedOption = {.header = kSackPermittedOptionHeader};
@@ -89,9 +128,17 @@ constexpr WindowScaleOption kDefaultWindowScaleOption = {.header = kWindowScaleO
 constexpr OptionsBlock kDefaultOptionsBlock = {
   .mss = kDefaultMssOption,
   .sack_permitted = kSackPermittedOption,
+  .timestamp = {.header = kTimestampOptionHeader},
   .window_scale = kDefaultWindowScaleOption
 };
 
+constexpr TimestampBlock kDefaultTimestampBlock = {.option = {.header = kTimestampOptionHeader}};
+
+struct Timestamp {
+  uint32_t value;
+  uint32_t echo;
+};
+
 constexpr int kDefaultWindowSize = 65535;
 
 } // namespace idk::net
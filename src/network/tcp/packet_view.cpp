@@ -2,6 +2,9 @@
 #include "packet_view.h"
 #include <rte_ip.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace idk::net::tcp {
 
 HeaderReflection
@@ -14,8 +17,9 @@ Header::data_offset() const {
   return data_offset_scaled * 4;
 }
 
-size_t PacketView::predict_size(size_t payload_size, bool options) {
-  return IPPacketView::predict_size(sizeof(Header) + (options ? 12 : 0) + payload_size);
+size_t PacketView::predict_size(size_t payload_size, bool options, bool timestamp) {
+  const size_t options_size = options ? sizeof(OptionsBlock) : (timestamp ? sizeof(TimestampBlock) : 0);
+  return IPPacketView::predict_size(sizeof(Header) + options_size + payload_size);
 }
 
 void
@@ -24,7 +28,8 @@ PacketView::resize_payload(size_t payload_size) {
 }
 
 void
-PacketView::init(Connection connection, Flags flags, SeqNumber seq, SeqNumber ack_seq, bool options) {
+PacketView::init(Connection connection, Flags flags, SeqNumber seq, SeqNumber ack_seq, bool options,
+                 std::optional<Timestamp> timestamp) {
   ip_packet_view.init(connection.session, IpProtocol::Tcp);
 
   Header& hdr = header();
@@ -41,10 +46,45 @@ PacketView::init(Connection connection, Flags flags, SeqNumber seq, SeqNumber ac
 
   if (options) {
     hdr.data_offset_scaled += sizeof(OptionsBlock) / 4;
-    *base::start_lifetime_as<OptionsBlock>((uint8_t*)(&hdr + 1)) = kDefaultOptionsBlock;
+    auto& block = *base::start_lifetime_as<OptionsBlock>((uint8_t*)(&hdr + 1));
+    block = kDefaultOptionsBlock;
+    if (timestamp) {
+      block.timestamp.value = timestamp->value;
+      block.timestamp.echo = timestamp->echo;
+    }
+  } else if (timestamp) {
+    hdr.data_offset_scaled += sizeof(TimestampBlock) / 4;
+    auto& block = *base::start_lifetime_as<TimestampBlock>((uint8_t*)(&hdr + 1));
+    block = kDefaultTimestampBlock;
+    block.option.value = timestamp->value;
+    block.option.echo = timestamp->echo;
   }
 }
 
+OptionsBlock&
+PacketView::syn_options() {
+  return *base::start_lifetime_as<OptionsBlock>((uint8_t*)(&header() + 1));
+}
+
+TimestampOption&
+PacketView::fixed_timestamp() {
+  return base::start_lifetime_as<TimestampBlock>((uint8_t*)(&header() + 1))->option;
+}
+
+void
+PacketView::append_sack(std::span<const SackBlock> blocks) {
+  Header& hdr = header();
+  const size_t length = sizeof(SackOptionHeader) + blocks.size() * sizeof(SackBlock);
+  REQUIRE(!blocks.empty() && hdr.data_offset() + length <= sizeof(Header) + kMaxOptionsSize,
+          "No space for {} sack blocks", blocks.size());
+  auto* option = reinterpret_cast<uint8_t*>(&hdr) + hdr.data_offset();
+  const auto option_length = static_cast<uint8_t>(sizeof(OptionHeader) + blocks.size() * sizeof(SackBlock));
+  *base::start_lifetime_as<SackOptionHeader>(option) =
+      SackOptionHeader{.header = {.kind = kSackOptionHeader.kind, .length = option_length}};
+  std::memcpy(option + sizeof(SackOptionHeader), blocks.data(), blocks.size() * sizeof(SackBlock));
+  hdr.data_offset_scaled += length / 4;
+}
+
 BE<uint16_t> PacketView::calc_checksum() const {
   auto& tcp_hdr = const_cast<Header&>(header());
   uint16_t cksum = rte_ipv4_udptcp_cksum(
@@ -87,6 +127,18 @@ PacketView::ip() const {
   return ip_packet_view;
 }
 
+Connection
+PacketView::reply_connection() {
+  const auto& ip = ip_packet_view.header();
+  const auto& eth = ip_packet_view.eth().header();
+  const Header& hdr = header();
+  return {
+      .session = {.src = {.mac = eth.dst_mac, .ip = ip.dst_addr}, .dst = {.mac = eth.src_mac, .ip = ip.src_addr}},
+      .src_port = hdr.dst_port,
+      .dst_port = hdr.src_port,
+  };
+}
+
 Header&
 PacketView::header() {
   return *base::start_lifetime_as<Header>(ip_packet_view.payload().data());
@@ -106,6 +158,16 @@ PacketView::parse_options() const {
   const size_t options_length = tcp_header.data_offset() - sizeof(Header);
   size_t offset = 0;
 
+  // Nearly every segment of a connection with timestamps carries the RFC 7323 appendix A layout and nothing else
+  if (options_length == sizeof(TimestampBlock)) [[likely]] {
+    const auto& block = *base::start_lifetime_as<TimestampBlock>(options_data);
+    if (block.padding == kDefaultTimestampBlock.padding && block.option.header.kind == kTimestampOptionHeader.kind &&
+        block.option.header.length == kTimestampOptionHeader.length) {
+      options.timestamp = Timestamp{.value = block.option.value.value(), .echo = block.option.echo.value()};
+      return options;
+    }
+  }
+
   while (offset < options_length) {
     const uint8_t option_kind = options_data[offset];
 
@@ -121,6 +183,13 @@ PacketView::parse_options() const {
     REQUIRE(option_hdr->length >= sizeof(OptionHeader) && offset + option_hdr->length <= options_length, "Invalid length field");
 
     switch (option_kind) {
+      case kMssOptionHeader.kind:
+        if (option_hdr->length == sizeof(MssOption)) {
+          const auto* mss_option = reinterpret_cast<const MssOption*>(option_hdr);
+          options.mss = mss_option->mss.value();
+        }
+        break;
+
       case kWindowScaleOptionHeader.kind:
         if (option_hdr->length == sizeof(WindowScaleOption)) {
           const auto* ws_option = reinterpret_cast<const WindowScaleOption*>(option_hdr);
@@ -128,6 +197,25 @@ PacketView::parse_options() const {
         }
         break;
 
+      case kTimestampOptionHeader.kind:
+        if (option_hdr->length == sizeof(TimestampOption)) {
+          const auto* ts_option = reinterpret_cast<const TimestampOption*>(option_hdr);
+          options.timestamp = Timestamp{.value = ts_option->value.value(), .echo = ts_option->echo.value()};
+        }
+        break;
+
+      case kSackPermittedOptionHeader.kind:
+        options.sack_permitted = true;
+        break;
+
+      case kSackOptionHeader.kind: {
+        const size_t blocks = std::min<size_t>((option_hdr->length - sizeof(OptionHeader)) / sizeof(SackBlock),
+                                               kMaxSackBlocks);
+        std::memcpy(options.sack_blocks.data(), option_hdr + 1, blocks * sizeof(SackBlock));
+        options.sack_blocks_size = blocks;
+        break;
+      }
+
       default:
         break;
     }
@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <span>
 #include "base/stream/mutable_byte_view_stream.h"
 #include "network/tcp/flags.h"
 #include "network/type/big_endian.h"
@@ -18,8 +19,11 @@ public:
 
   explicit PacketView(IPPacketView bytes) : ip_packet_view(bytes) {}
 
+  // `options` writes the SYN options. `timestamp` goes into the SYN options or, for other segments, into a fixed
+  // TimestampBlock right after the header.
   void
-  init(Connection connection, Flags flags, SeqNumber seq, SeqNumber ack_seq, bool options = false);
+  init(Connection connection, Flags flags, SeqNumber seq, SeqNumber ack_seq, bool options = false,
+       std::optional<Timestamp> timestamp = std::nullopt);
 
   void
   update_checksum();
@@ -28,7 +32,7 @@ public:
   calc_checksum() const;
 
   static size_t
-  predict_size(size_t payload_size, bool options);
+  predict_size(size_t payload_size, bool options, bool timestamp = false);
 
   void
   resize_payload(size_t payload_size);
@@ -53,14 +57,40 @@ public:
   [[nodiscard]] IPPacketView
   ip() const;
 
+  // Local view of the connection of a received segment: src is this host
+  [[nodiscard]] Connection
+  reply_connection();
+
   Header&
   header();
 
   [[nodiscard]] const Header&
   header() const;
 
+  // Appends a SACK option after the options written by `init`. Must be called before the payload is written.
+  void
+  append_sack(std::span<const SackBlock> blocks);
+
+  // Options written by `init` with `options`
+  OptionsBlock&
+  syn_options();
+
+  // Timestamp option of a segment laid out by `init` with a timestamp, the segment must not be a SYN
+  TimestampOption&
+  fixed_timestamp();
+
   struct Options {
+    std::optional<uint16_t> mss;
     std::optional<uint8_t> window_scale;
+    std::optional<Timestamp> timestamp;
+    bool sack_permitted{false};
+    std::array<SackBlock, kMaxSackBlocks> sack_blocks;
+    uint8_t sack_blocks_size{0};
+
+    [[nodiscard]] std::span<const SackBlock>
+    sack() const {
+      return {sack_blocks.data(), sack_blocks_size};
+    }
   };
   [[nodiscard]] Options
   parse_options() const;
@@ -0,0 +1,29 @@
+#include "port_allocator.h"
+
+#include "base/macros/require.h"
+
+namespace idk::net::tcp {
+
+std::optional<Port>
+PortAllocator::allocate(Ip local, const Endpoint& remote, uint16_t queue) {
+  constexpr uint32_t kRange = kLastPort - kFirstPort + 1;
+  for (uint32_t i = 0; i < kRange; ++i) {
+    const auto candidate = static_cast<uint16_t>(kFirstPort + (next - kFirstPort + i) % kRange);
+    if (used.test(candidate) || rss.queue(remote.ip, local, remote.port, Port(candidate)) != queue) {
+      continue;
+    }
+    used.set(candidate);
+    next = candidate == kLastPort ? kFirstPort : candidate + 1;
+    return Port(candidate);
+  }
+  return std::nullopt;
+}
+
+uint16_t
+PortAllocator::reserve(Ip local, const Endpoint& remote, Port port) {
+  REQUIRE(!used.test(port.value()), "Port {} is already in use", port.value());
+  used.set(port.value());
+  return rss.queue(remote.ip, local, remote.port, port);
+}
+
+} // namespace idk::net::tcp
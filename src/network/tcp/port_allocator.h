@@ -0,0 +1,46 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <optional>
+
+#include "network/dpdk/rss.h"
+#include "network/type/endpoint.h"
+
+namespace idk::net::tcp {
+
+// Hands out local ports so that the replies of each connection hash to a chosen rx queue, the one polled by the worker
+// which owns the connection. Ports come from the Linux ephemeral range.
+class PortAllocator {
+public:
+  static constexpr uint16_t kFirstPort = 32768;
+  static constexpr uint16_t kLastPort = 60999;
+
+  explicit PortAllocator(dpdk::Rss rss) : rss(std::move(rss)) {}
+
+  // A free port for a connection from `local` to `remote` whose replies arrive on `queue`, nullopt if none is left
+  [[nodiscard]] std::optional<Port>
+  allocate(Ip local, const Endpoint& remote, uint16_t queue);
+
+  // Takes a port chosen elsewhere, e.g. configured, and returns the queue its replies arrive on
+  uint16_t
+  reserve(Ip local, const Endpoint& remote, Port port);
+
+  void
+  release(Port port) {
+    used.reset(port.value());
+  }
+
+  [[nodiscard]] const dpdk::Rss&
+  rss_model() const {
+    return rss;
+  }
+
+private:
+  dpdk::Rss rss;
+  std::bitset<65536> used;
+  // The search starts after the last allocated port, so released ports are not reused at once
+  uint16_t next{kFirstPort};
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,66 @@
+#include "reassembly_queue.h"
+
+#include <algorithm>
+#include <array>
+
+#include "base/logger/macros.h"
+
+namespace idk::net::tcp {
+
+ReassemblyQueue::ReassemblyQueue() {
+  segments.reserve(kMaxSegments);
+}
+
+bool
+ReassemblyQueue::insert(SeqNumber seq, base::ByteView data, dpdk::RxPacket packet) {
+  const auto end = seq + data.size();
+  inserts++;
+  auto it = std::ranges::upper_bound(segments, seq, {}, &Segment::seq);
+  // Retransmission of data which is already queued, its block is the most recent one again
+  if (it != segments.begin() && std::prev(it)->seq <= seq && std::prev(it)->end() >= end) {
+    TRACE("Segment {} is already queued", seq);
+    std::prev(it)->received = inserts;
+    return true;
+  }
+  if (segments.size() == kMaxSegments || bytes + data.size() > kMaxBytes) [[unlikely]] {
+    WARN("Reassembly queue is full, dropping segment {} of {} bytes", seq, data.size());
+    return false;
+  }
+  segments.insert(it, Segment{.seq = seq, .data = data, .packet = std::move(packet), .received = inserts});
+  bytes += data.size();
+  return true;
+}
+
+size_t
+ReassemblyQueue::sack_blocks(std::span<SackBlock> out) const {
+  // The contiguous ranges of the queue go into `out` by the latest insert into them, the oldest fall off the end
+  std::array<uint64_t, kMaxSackBlocks> received;
+  const size_t capacity = std::min(out.size(), received.size());
+  size_t size = 0;
+  for (size_t i = 0; i < segments.size();) {
+    const SeqNumber left = segments[i].seq;
+    SeqNumber right = segments[i].end();
+    uint64_t latest = segments[i].received;
+    for (++i; i < segments.size() && segments[i].seq <= right; ++i) {
+      right = std::max(right, segments[i].end());
+      latest = std::max(latest, segments[i].received);
+    }
+    size_t pos = size;
+    while (pos > 0 && received[pos - 1] < latest) {
+      --pos;
+    }
+    if (pos == capacity) {
+      continue;
+    }
+    size = std::min(size + 1, capacity);
+    for (size_t j = size - 1; j > pos; --j) {
+      out[j] = out[j - 1];
+      received[j] = received[j - 1];
+    }
+    out[pos] = {.left = left, .right = right};
+    received[pos] = latest;
+  }
+  return size;
+}
+
+} // namespace idk::net::tcp
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "base/type/default_constructor.h"
+#include "base/type/span.h"
+#include "network/dpdk/packet.h"
+#include "model.h"
+#include "seq_number.h"
+
+namespace idk::net::tcp {
+
+// Out-of-order segments waiting for a hole to be filled. The payload is not copied, every segment keeps a reference
+// to its mbuf. Segments are ordered by sequence number and may overlap, overlaps are trimmed when the data is drained.
+class ReassemblyQueue : base::NoCopy {
+public:
+  static constexpr size_t kMaxSegments = 128;
+  static constexpr size_t kMaxBytes = 256 * 1024;
+
+  ReassemblyQueue();
+
+  // Returns false if the segment was not queued because the queue is full
+  bool
+  insert(SeqNumber seq, base::ByteView data, dpdk::RxPacket packet);
+
+  // Calls `f(bytes, packet)` for the queued data which continues `next` and returns the sequence number after it
+  template<typename F>
+  SeqNumber
+  drain(SeqNumber next, F&& f) {
+    size_t consumed = 0;
+    for (; consumed < segments.size(); ++consumed) {
+      const auto& segment = segments[consumed];
+      if (segment.seq > next) {
+        break;
+      }
+      const uint32_t overlap = next - segment.seq;
+      if (overlap < segment.data.size()) {
+        const auto data = segment.data.subspan(overlap);
+        f(data, segment.packet);
+        next += data.size();
+      }
+      bytes -= segment.data.size();
+    }
+    segments.erase(segments.begin(), segments.begin() + consumed);
+    return next;
+  }
+
+  // Fills `out` with the ranges held by the queue, the one with the most recently received segment first and the others
+  // by the time they last changed (RFC 2018), so the blocks reported before are repeated. Returns the number of blocks.
+  size_t
+  sack_blocks(std::span<SackBlock> out) const;
+
+  [[nodiscard]] bool
+  empty() const {
+    return segments.empty();
+  }
+
+  [[nodiscard]] size_t
+  size() const {
+    return segments.size();
+  }
+
+  [[nodiscard]] size_t
+  size_bytes() const {
+    return bytes;
+  }
+
+private:
+  struct Segment {
+    SeqNumber seq;
+    base::ByteView data;
+    dpdk::RxPacket packet;
+    // Number of the insert which brought or repeated the segment
+    uint64_t received;
+
+    [[nodiscard]] SeqNumber
+    end() const {
+      return seq + data.size();
+    }
+  };
+
+  std::vector<Segment> segments;
+  size_t bytes{0};
+  uint64_t inserts{0};
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,91 @@
+#include "receive_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+
+namespace idk::net::tcp {
+
+ReceiveBuffer::ReceiveBuffer() : scratch(kScratchSize) {
+  segments.reserve(64);
+}
+
+void
+ReceiveBuffer::push(const dpdk::RxPacket& packet, base::ByteView bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  const auto frame = packet.bytes();
+  const size_t position = bytes.data() - frame.data();
+  REQUIRE_LE(position + bytes.size(), frame.size(), "Bytes are not inside the packet");
+  segments.push_back({.packet = packet.share(), .data = frame.subspan(position, bytes.size())});
+  size_ += bytes.size();
+}
+
+void
+ReceiveBuffer::push_borrowed(base::MutableByteView bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  segments.push_back({.packet = std::nullopt, .data = bytes});
+  size_ += bytes.size();
+}
+
+bool
+ReceiveBuffer::copy(size_t skip, base::MutableByteView out) const {
+  if (skip + out.size() > size_) {
+    return false;
+  }
+  size_t idx = front;
+  size_t position = offset + skip;
+  while (position >= segments[idx].data.size()) {
+    position -= segments[idx].data.size();
+    idx++;
+  }
+  for (size_t copied = 0; copied < out.size(); idx++, position = 0) {
+    const auto chunk = segments[idx].data.subspan(position);
+    const size_t n = std::min(chunk.size(), out.size() - copied);
+    std::memcpy(out.data() + copied, chunk.data(), n);
+    copied += n;
+  }
+  return true;
+}
+
+std::optional<base::MutableByteView>
+ReceiveBuffer::linearise(size_t n) {
+  if (n > size_) {
+    return std::nullopt;
+  }
+  if (n == 0) {
+    return base::MutableByteView{};
+  }
+  const auto& segment = segments[front];
+  if (offset + n <= segment.data.size()) [[likely]] {
+    return segment.data.subspan(offset, n);
+  }
+  REQUIRE_LE(n, scratch.size(), "{} bytes do not fit the scratch buffer", n);
+  TRACE("Linearising {} bytes over segment boundary", n);
+  copy(0, {scratch.data(), n});
+  return base::MutableByteView{scratch.data(), n};
+}
+
+void
+ReceiveBuffer::consume(size_t n) {
+  REQUIRE_LE(n, size_, "Consuming more than buffered");
+  size_ -= n;
+  offset += n;
+  while (front < segments.size() && offset >= segments[front].data.size()) {
+    offset -= segments[front].data.size();
+    front++;
+  }
+}
+
+void
+ReceiveBuffer::release() {
+  segments.erase(segments.begin(), segments.begin() + front);
+  front = 0;
+}
+
+} // namespace idk::net::tcp
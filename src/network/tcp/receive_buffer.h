@@ -0,0 +1,87 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "base/type/default_constructor.h"
+#include "base/type/span.h"
+#include "network/dpdk/packet.h"
+
+namespace idk::net::tcp {
+
+// In-order payload kept in the mbufs it arrived in, so the byte stream is never copied on the way in. It is parsed
+// through a cursor, only data which straddles two segments is linearised into a scratch buffer.
+class ReceiveBuffer : base::NoCopy {
+public:
+  // Fits the largest tls record
+  static constexpr size_t kScratchSize = 18 * 1024;
+
+  ReceiveBuffer();
+
+  // Appends `bytes`, which point into `packet`. The buffer keeps its own reference to the mbuf.
+  void
+  push(const dpdk::RxPacket& packet, base::ByteView bytes);
+
+  // Appends bytes owned by the caller, they must stay valid until they are released
+  void
+  push_borrowed(base::MutableByteView bytes);
+
+  // Bytes after the cursor
+  [[nodiscard]] size_t
+  size() const {
+    return size_;
+  }
+
+  [[nodiscard]] bool
+  empty() const {
+    return size_ == 0;
+  }
+
+  // Copies `out.size()` bytes starting `offset` bytes after the cursor. Returns false if not enough is buffered.
+  bool
+  copy(size_t offset, base::MutableByteView out) const;
+
+  template<typename Object>
+  [[nodiscard]] std::optional<Object>
+  peek(size_t offset = 0) const {
+    Object object;
+    if (!copy(offset, {reinterpret_cast<uint8_t*>(&object), sizeof(Object)})) {
+      return std::nullopt;
+    }
+    return object;
+  }
+
+  // Writable view of the `n` bytes after the cursor. It points into the mbuf if they lie in one segment, otherwise the
+  // bytes are copied into the scratch buffer. The view stays valid until the next `linearise` or `release`.
+  std::optional<base::MutableByteView>
+  linearise(size_t n);
+
+  // Moves the cursor forward. Segments are kept until `release`, so views returned before stay valid.
+  void
+  consume(size_t n);
+
+  // Frees the segments before the cursor
+  void
+  release();
+
+  [[nodiscard]] size_t
+  segments_size() const {
+    return segments.size();
+  }
+
+private:
+  struct Segment {
+    // Empty for borrowed bytes
+    std::optional<dpdk::RxPacket> packet;
+    base::MutableByteView data;
+  };
+
+  std::vector<Segment> segments;
+  // Position of the cursor
+  size_t front{0};
+  size_t offset{0};
+  size_t size_{0};
+  std::vector<uint8_t> scratch;
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,40 @@
+#include "receive_window.h"
+
+#include <algorithm>
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+
+namespace idk::net::tcp {
+
+ReceiveWindow::ReceiveWindow(size_t initial_buffer, size_t max_buffer) :
+    max_buffer(max_buffer), target(initial_buffer), space(initial_buffer) {
+  REQUIRE_LE(initial_buffer, max_buffer, "Initial receive buffer is above the maximum");
+  while (offered_scale_ < kMaxScale && (max_buffer >> offered_scale_) > kMaxUnscaledWindow) {
+    offered_scale_++;
+  }
+}
+
+void
+ReceiveWindow::on_delivered(size_t bytes, time_point now, std::chrono::nanoseconds rtt) {
+  space -= std::min(bytes, space);
+  delivered += bytes;
+  if (rtt.count() == 0 || now - measure_start < base::RdtscDuration(rtt)) {
+    return;
+  }
+  const size_t wanted = std::min(max_buffer, 2 * delivered);
+  if (wanted > target) {
+    DEBUG("Receive buffer grows from {} to {} bytes, {} bytes delivered in {}ns", target, wanted, delivered,
+          rtt.count());
+    target = wanted;
+  }
+  delivered = 0;
+  measure_start = now;
+}
+
+uint16_t
+ReceiveWindow::advertised() const {
+  return std::min<size_t>(space >> scale, kMaxUnscaledWindow);
+}
+
+} // namespace idk::net::tcp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "base/clock/rdtsc_clock.h"
+
+namespace idk::net::tcp {
+
+// Receive side flow control. The advertised window is the free space of the buffer the upper layer pushes the byte
+// stream into, so the peer never sends more than can be absorbed. The buffer is autotuned like Linux does it
+// (dynamic right sizing): once per rtt the target grows to twice the data delivered during the last rtt, which lets
+// the peer keep doubling its congestion window.
+class ReceiveWindow {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  static constexpr uint32_t kMaxUnscaledWindow = 65535;
+  static constexpr uint8_t kMaxScale = 14;
+
+  // `max_buffer` bounds the autotuning and defines the window scale offered in the SYN
+  ReceiveWindow(size_t initial_buffer, size_t max_buffer);
+
+  // Shift to offer in the SYN
+  [[nodiscard]] uint8_t
+  offered_scale() const {
+    return offered_scale_;
+  }
+
+  // The peer answered with a window scale option, our windows are scaled from now on
+  void
+  enable_scaling() {
+    scale = offered_scale_;
+  }
+
+  // Free space reported by the upper layer
+  void
+  set_space(size_t free_bytes) {
+    space = free_bytes;
+  }
+
+  // Accounts in-order data handed to the upper layer
+  void
+  on_delivered(size_t bytes, time_point now, std::chrono::nanoseconds rtt);
+
+  // Value for the window field of the header
+  [[nodiscard]] uint16_t
+  advertised() const;
+
+  // Size the upper layer buffer should have
+  [[nodiscard]] size_t
+  buffer_target() const {
+    return target;
+  }
+
+  [[nodiscard]] size_t
+  space_bytes() const {
+    return space;
+  }
+
+private:
+  size_t max_buffer;
+  size_t target;
+  size_t space;
+  uint8_t offered_scale_{0};
+  uint8_t scale{0};
+
+  size_t delivered{0};
+  time_point measure_start{};
+};
+
+} // namespace idk::net::tcp
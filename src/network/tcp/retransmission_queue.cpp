@@ -0,0 +1,52 @@
+#include "retransmission_queue.h"
+
+#include "base/macros/require.h"
+
+namespace idk::net::tcp {
+
+RetransmissionQueue::RetransmissionQueue() {
+  segments.reserve(kMaxSegments);
+}
+
+void
+RetransmissionQueue::push(SeqNumber seq, uint32_t length, dpdk::TxPacket packet, time_point now) {
+  REQUIRE_LT(segments.size(), kMaxSegments, "Retransmission queue is full");
+  segments.push_back({.seq = seq, .length = length, .packet = std::move(packet), .sent_at = now});
+}
+
+std::optional<base::RdtscDuration>
+RetransmissionQueue::acknowledge(SeqNumber ack, time_point now) {
+  size_t acked = 0;
+  bool retransmitted = false;
+  for (; acked < segments.size() && segments[acked].end() <= ack; ++acked) {
+    retransmitted |= segments[acked].retransmitted;
+    sacked -= segments[acked].sacked;
+  }
+  if (acked == 0) {
+    return std::nullopt;
+  }
+  std::optional<base::RdtscDuration> rtt;
+  if (!retransmitted) {
+    rtt = now - segments[acked - 1].sent_at;
+  }
+  segments.erase(segments.begin(), segments.begin() + acked);
+  return rtt;
+}
+
+bool
+RetransmissionQueue::on_sack(SeqNumber left, SeqNumber right) {
+  bool marked = false;
+  for (auto& segment: segments) {
+    if (segment.seq >= right) {
+      break;
+    }
+    if (!segment.sacked && segment.seq >= left && segment.end() <= right) {
+      segment.sacked = true;
+      sacked++;
+      marked = true;
+    }
+  }
+  return marked;
+}
+
+} // namespace idk::net::tcp
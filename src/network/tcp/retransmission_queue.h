@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/type/default_constructor.h"
+#include "network/dpdk/packet.h"
+#include "seq_number.h"
+
+namespace idk::net::tcp {
+
+// Sent segments waiting for an ACK. Every segment holds a reference to the mbuf handed to the NIC, so nothing is
+// copied unless the segment has to be retransmitted.
+class RetransmissionQueue : base::NoCopy {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  static constexpr size_t kMaxSegments = 256;
+
+  struct Segment {
+    [[nodiscard]] SeqNumber
+    end() const {
+      return seq + length;
+    }
+
+    SeqNumber seq;
+    // Sequence space of the segment, SYN and FIN count as one
+    uint32_t length;
+    dpdk::TxPacket packet;
+    time_point sent_at;
+    bool retransmitted{false};
+    // Reported received by the peer in a SACK block, it is not retransmitted
+    bool sacked{false};
+    // Retransmitted in the current recovery episode, `for_each_hole` skips it
+    bool hole_filled{false};
+  };
+
+  RetransmissionQueue();
+
+  void
+  push(SeqNumber seq, uint32_t length, dpdk::TxPacket packet, time_point now);
+
+  // Drops the segments covered by `ack`. Returns the rtt of the newest of them, unless any of them was retransmitted
+  // (Karn's algorithm).
+  std::optional<base::RdtscDuration>
+  acknowledge(SeqNumber ack, time_point now);
+
+  // Marks the segments inside [left, right) as received. Returns true if any segment was newly marked.
+  bool
+  on_sack(SeqNumber left, SeqNumber right);
+
+  // Calls `f(segment)` for every segment which is not sacked and lies below the highest sacked one. These are the holes
+  // the peer is missing, each is passed once per recovery episode.
+  template<typename F>
+  void
+  for_each_hole(F&& f) {
+    const auto highest = std::find_if(segments.rbegin(), segments.rend(), [](const Segment& el) { return el.sacked; });
+    for (auto it = segments.begin(); it != highest.base(); ++it) {
+      if (!it->sacked && !it->hole_filled) {
+        it->hole_filled = true;
+        f(*it);
+      }
+    }
+  }
+
+  // Starts a recovery episode, or ends one with a timeout: the holes are passed by `for_each_hole` again, as their
+  // retransmissions may have been lost too
+  void
+  reset_holes() {
+    for (auto& segment: segments) {
+      segment.hole_filled = false;
+    }
+  }
+
+  [[nodiscard]] bool
+  has_sacked() const {
+    return sacked > 0;
+  }
+
+  [[nodiscard]] Segment&
+  front() {
+    return segments.front();
+  }
+
+  [[nodiscard]] bool
+  empty() const {
+    return segments.empty();
+  }
+
+  [[nodiscard]] size_t
+  size() const {
+    return segments.size();
+  }
+
+  // No more segments can be sent until some are acknowledged
+  [[nodiscard]] bool
+  full() const {
+    return segments.size() == kMaxSegments;
+  }
+
+private:
+  std::vector<Segment> segments;
+  size_t sacked{0};
+};
+
+} // namespace idk::net::tcp
@@ -0,0 +1,28 @@
+#include "rto_estimator.h"
+
+#include <algorithm>
+
+namespace idk::net::tcp {
+
+void
+RtoEstimator::on_sample(duration rtt) {
+  if (!has_sample) {
+    // 2.2
+    srtt_ = rtt;
+    rttvar_ = rtt / 2;
+    has_sample = true;
+  } else {
+    // 2.3, alpha = 1/8, beta = 1/4
+    const auto delta = srtt_ > rtt ? srtt_ - rtt : rtt - srtt_;
+    rttvar_ = (rttvar_ * 3 + delta) / 4;
+    srtt_ = (srtt_ * 7 + rtt) / 8;
+  }
+  rto_ = std::clamp(srtt_ + std::max(kClockGranularity, rttvar_ * 4), kMinRto, kMaxRto);
+}
+
+void
+RtoEstimator::back_off() {
+  rto_ = std::min(rto_ * 2, kMaxRto);
+}
+
+} // namespace idk::net::tcp
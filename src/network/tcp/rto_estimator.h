@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+namespace idk::net::tcp {
+
+// Retransmission timeout as in RFC 6298. The lower bound is 200ms instead of the RFC's 1s, the same as Linux uses,
+// a second of stall is far too long for a market data connection.
+class RtoEstimator {
+public:
+  using duration = std::chrono::nanoseconds;
+
+  static constexpr duration kInitialRto = std::chrono::seconds(1);
+  static constexpr duration kMinRto = std::chrono::milliseconds(200);
+  static constexpr duration kMaxRto = std::chrono::seconds(60);
+  static constexpr duration kClockGranularity = std::chrono::microseconds(1);
+
+  void
+  on_sample(duration rtt);
+
+  // Doubles the timeout after it has expired
+  void
+  back_off();
+
+  [[nodiscard]] duration
+  rto() const {
+    return rto_;
+  }
+
+  [[nodiscard]] duration
+  srtt() const {
+    return srtt_;
+  }
+
+  [[nodiscard]] duration
+  rttvar() const {
+    return rttvar_;
+  }
+
+private:
+  duration srtt_{0};
+  duration rttvar_{0};
+  duration rto_{kInitialRto};
+  bool has_sample{false};
+};
+
+} // namespace idk::net::tcp
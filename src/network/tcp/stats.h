@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace idk::net::tcp {
+
+// Counters and state of one connection. The owner thread updates them with plain stores on the hot path, other
+// threads read the snapshot the client publishes through a seqlock.
+struct ClientStats {
+  static constexpr bool kLoggable = true;
+
+  uint64_t segments_in{0};
+  uint64_t segments_out{0};
+  uint64_t bytes_in{0};
+  uint64_t bytes_out{0};
+  // Segments matched by the header prediction
+  uint64_t predicted{0};
+  // Segments queued in the reassembly queue
+  uint64_t out_of_order{0};
+  // Segments received again, all of their data was delivered already
+  uint64_t duplicate_segments{0};
+  uint64_t duplicate_acks{0};
+  uint64_t paws_drops{0};
+  uint64_t retransmitted_segments{0};
+  uint64_t fast_retransmits{0};
+  uint64_t rto_timeouts{0};
+  // Times the peer closed its window while we had data to send
+  uint64_t zero_window_stalls{0};
+  // Probes of a closed window sent by the persist timer
+  uint64_t window_probes{0};
+
+  uint32_t cwnd{0};
+  uint32_t ssthresh{0};
+  uint32_t send_window{0};
+  uint32_t flight_size{0};
+  uint32_t queued_bytes{0};
+  uint32_t receive_window{0};
+  int64_t srtt_ns{0};
+  int64_t rttvar_ns{0};
+  int64_t rto_ns{0};
+};
+
+} // namespace idk::net::tcp
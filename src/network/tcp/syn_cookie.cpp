@@ -0,0 +1,124 @@
+#include "syn_cookie.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+
+namespace idk::net::tcp {
+
+namespace {
+
+constexpr uint32_t kHashBits = 24;
+constexpr uint32_t kMssBits = 3;
+constexpr uint32_t kCounterMask = (1u << (32 - kHashBits - kMssBits)) - 1;
+constexpr uint8_t kNoWindowScale = 0xf;
+// RFC 7323 2.3
+constexpr uint8_t kMaxWindowScale = 14;
+
+// SipHash-2-4 of four words, a keyed PRF which is cheap enough to answer a SYN flood at line rate
+uint64_t
+siphash(const std::array<uint64_t, 2>& key, const std::array<uint64_t, 4>& words) {
+  uint64_t v0 = key[0] ^ 0x736f6d6570736575ULL;
+  uint64_t v1 = key[1] ^ 0x646f72616e646f6dULL;
+  uint64_t v2 = key[0] ^ 0x6c7967656e657261ULL;
+  uint64_t v3 = key[1] ^ 0x7465646279746573ULL;
+  const auto round = [&] {
+    v0 += v1;
+    v1 = std::rotl(v1, 13) ^ v0;
+    v0 = std::rotl(v0, 32);
+    v2 += v3;
+    v3 = std::rotl(v3, 16) ^ v2;
+    v0 += v3;
+    v3 = std::rotl(v3, 21) ^ v0;
+    v2 += v1;
+    v1 = std::rotl(v1, 17) ^ v2;
+    v2 = std::rotl(v2, 32);
+  };
+  const auto absorb = [&](uint64_t word) {
+    v3 ^= word;
+    round();
+    round();
+    v0 ^= word;
+  };
+  for (const uint64_t word: words) {
+    absorb(word);
+  }
+  absorb(uint64_t{sizeof(words)} << 56);
+  v2 ^= 0xff;
+  round();
+  round();
+  round();
+  round();
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+uint32_t
+period(SynCookies::time_point now) {
+  const std::chrono::seconds seconds = now.time_since_epoch();
+  return static_cast<uint32_t>(seconds.count() / SynCookies::kPeriodSeconds);
+}
+
+} // namespace
+
+SynCookies::SynCookies() {
+  std::random_device rd;
+  std::mt19937_64 gen((uint64_t{rd()} << 32) | rd());
+  secret = {gen(), gen()};
+}
+
+uint32_t
+SynCookies::hash(const Connection& connection, SeqNumber peer_isn, uint32_t counter) const {
+  const auto& session = connection.session;
+  const std::array<uint64_t, 4> words{
+      (uint64_t{session.src.ip.data()} << 32) | session.dst.ip.data(),
+      (uint64_t{connection.src_port.value()} << 16) | connection.dst_port.value(),
+      peer_isn.value(),
+      counter,
+  };
+  return static_cast<uint32_t>(siphash(secret, words)) & ((1u << kHashBits) - 1);
+}
+
+SeqNumber
+SynCookies::encode(const Connection& connection, SeqNumber peer_isn, uint16_t mss, time_point now) const {
+  const uint32_t counter = period(now);
+  // The largest entry not above the peer's mss, the first one as a floor
+  const auto it = std::ranges::upper_bound(kMssTable, mss);
+  const uint32_t mss_idx = it == kMssTable.begin() ? 0 : static_cast<uint32_t>(it - kMssTable.begin() - 1);
+  return ((counter & kCounterMask) << (kHashBits + kMssBits)) | (mss_idx << kHashBits) |
+         hash(connection, peer_isn, counter);
+}
+
+std::optional<uint16_t>
+SynCookies::decode(const Connection& connection, SeqNumber peer_isn, SeqNumber cookie, time_point now) const {
+  const uint32_t current = period(now);
+  const uint32_t bits = cookie.value() >> (kHashBits + kMssBits);
+  for (const uint32_t counter: {current, current - 1}) {
+    if ((counter & kCounterMask) == bits &&
+        hash(connection, peer_isn, counter) == (cookie.value() & ((1u << kHashBits) - 1))) {
+      return kMssTable[(cookie.value() >> kHashBits) & ((1u << kMssBits) - 1)];
+    }
+  }
+  return std::nullopt;
+}
+
+uint32_t
+SynCookies::encode_options(uint32_t value, const Options& options) {
+  const uint32_t scale =
+      options.window_scale ? std::min(options.window_scale.value(), kMaxWindowScale) : kNoWindowScale;
+  const uint32_t encoded = (value & ~((1u << kOptionBits) - 1)) | (scale << 1) | (options.sack_permitted ? 1 : 0);
+  // Later segments take the clock as is, their timestamps must not go backwards
+  return encoded > value ? encoded - (1u << kOptionBits) : encoded;
+}
+
+SynCookies::Options
+SynCookies::decode_options(uint32_t echo) {
+  Options options{.sack_permitted = (echo & 1) != 0};
+  const auto scale = static_cast<uint8_t>((echo >> 1) & 0xf);
+  if (scale != kNoWindowScale) {
+    options.window_scale = scale;
+  }
+  return options;
+}
+
+} // namespace idk::net::tcp
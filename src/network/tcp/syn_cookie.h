@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "base/clock/rdtsc_clock.h"
+#include "network/type/endpoint.h"
+#include "seq_number.h"
+
+namespace idk::net::tcp {
+
+// Stateless SYN cookies: the initial sequence number of the SYN-ACK carries everything the listener needs to finish
+// the handshake, so no state is kept until the final ACK arrives (RFC 4987 3.6). Layout of the cookie:
+//   [31:27] 64 second counter, [26:24] index of the mss in kMssTable, [23:0] keyed hash of the 4-tuple, the peer's
+//   initial sequence number and the counter.
+// A cookie is accepted during the period it was issued in and the next one. The window scale and SACK-permitted
+// options do not fit, they ride in the low bits of the SYN-ACK timestamp and come back as the echo, so they survive
+// only if the peer uses timestamps (like Linux does).
+class SynCookies {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  static constexpr std::array<uint16_t, 8> kMssTable{536, 1024, 1220, 1300, 1380, 1440, 1452, 1460};
+  static constexpr uint32_t kPeriodSeconds = 64;
+  static constexpr uint32_t kOptionBits = 5;
+
+  struct Options {
+    std::optional<uint8_t> window_scale;
+    bool sack_permitted{false};
+  };
+
+  // Random secret
+  SynCookies();
+
+  explicit SynCookies(std::array<uint64_t, 2> secret) : secret(secret) {}
+
+  // `connection` is the local view of the flow, `mss` is rounded down to the table
+  [[nodiscard]] SeqNumber
+  encode(const Connection& connection, SeqNumber peer_isn, uint16_t mss, time_point now) const;
+
+  // Mss encoded in `cookie`, if it is valid
+  [[nodiscard]] std::optional<uint16_t>
+  decode(const Connection& connection, SeqNumber peer_isn, SeqNumber cookie, time_point now) const;
+
+  // Replaces the low bits of the SYN-ACK timestamp `value` with the options
+  [[nodiscard]] static uint32_t
+  encode_options(uint32_t value, const Options& options);
+
+  [[nodiscard]] static Options
+  decode_options(uint32_t echo);
+
+private:
+  [[nodiscard]] uint32_t
+  hash(const Connection& connection, SeqNumber peer_isn, uint32_t counter) const;
+
+  std::array<uint64_t, 2> secret;
+};
+
+} // namespace idk::net::tcp
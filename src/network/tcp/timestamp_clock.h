@@ -0,0 +1,18 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "base/clock/rdtsc_clock.h"
+
+namespace idk::net::tcp {
+
+// The RFC 7323 timestamp clock ticks every microsecond (the RFC allows down to 59ns), fine enough for rtt samples in
+// the colocation
+inline uint32_t
+timestamp_clock(base::RdtscClock::time_point now) {
+  const std::chrono::microseconds us = now.time_since_epoch();
+  return static_cast<uint32_t>(us.count());
+}
+
+} // namespace idk::net::tcp
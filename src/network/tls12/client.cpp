@@ -19,32 +19,57 @@
 
 namespace idk::net::tls12 {
 
-Client::Client(const std::string& sni_hostname_, tcp::Client tcp_client) :
-    sni_hostname(sni_hostname_), tcp(std::move(tcp_client)) {
+// Every segment carries a record with some payload
+static_assert(tcp::Client::kMinMss > tcp::kMaxOptionsSize + sizeof(TLSRecord) + kGcmTagSize);
+
+Client::Client(const std::string& sni_hostname_, tcp::Client tcp_client, size_t max_held_mbufs) :
+    sni_hostname(sni_hostname_), tcp(std::move(tcp_client)), max_held_mbufs(max_held_mbufs) {
+  REQUIRE_GE(max_held_mbufs, kMinHeldMbufs, "{} mbufs can not hold a whole tls record", max_held_mbufs);
   tls_randoms.client.generate();
+  update_receive_space();
   tcp.connect();
 }
 
 void
 Client::flush() {
-  auto packet = tcp.get_send_buffer(tcp::Flags::PSH_ACK);
-
-  auto write_stream = packet.tcp.payload_write_stream();
-  auto& record = write_stream.push(kApplicationDataTlsRecord);
-  record.explicit_iv = write_sequence_number;
-
-  auto to_send = send_buffer.pop(send_buffer.size());
-  REQUIRE(to_send, "");
-  write_stream.push_bytes(to_send.value());
+  if (corked > 0) {
+    return;
+  }
+  // One record per segment, so every record is encrypted in place inside its mbuf
+  while (!send_buffer.empty()) {
+    auto packet = tcp.get_send_buffer(tcp::Flags::PSH_ACK);
+    const size_t record_capacity = tcp.max_payload(packet.tcp) - sizeof(TLSRecord) - kGcmTagSize;
+
+    auto write_stream = packet.tcp.payload_write_stream();
+    auto& record = write_stream.push(kApplicationDataTlsRecord);
+    record.explicit_iv = write_sequence_number;
+
+    auto to_send = send_buffer.pop(std::min(send_buffer.size(), record_capacity));
+    REQUIRE(to_send, "");
+    write_stream.push_bytes(to_send.value());
+
+    size_t encrypted_len = sizeof(write_sequence_number) +
+                           encrypt({record.payload().data(), to_send->size()}, ContentType::ApplicationData);
+    record.header.size = encrypted_len;
+    tcp.send(std::move(packet), sizeof(RecordHeader) + encrypted_len);
+  }
+}
 
-  size_t encrypted_len =
-      sizeof(write_sequence_number) + encrypt({record.payload().data(), to_send->size()}, ContentType::ApplicationData);
-  record.header.size = encrypted_len;
-  tcp.send(std::move(packet), sizeof(RecordHeader) + encrypted_len);
+void
+Client::uncork() {
+  REQUIRE_GT(corked, 0, "Connection is not corked");
+  if (--corked == 0) {
+    flush();
+  }
+  // Last, the records are queued in the still corked tcp connection and leave in full segments
+  tcp.uncork();
 }
 
 std::optional<base::MutableByteView>
 Client::receive() {
+  if (zero_copy) [[likely]] {
+    return receive_in_place();
+  }
   if (handshake_state == HandshakeState::ClientHelloToSend && stream.empty()) [[unlikely]] {
     send_client_hello();
     handshake_state = HandshakeState::ServerHello;
@@ -72,14 +97,63 @@ Client::receive() {
   return decrypt(ciphertext);
 }
 
+std::optional<base::MutableByteView>
+Client::receive_in_place() {
+  // The previous record was handed out already
+  segments.release();
+  ASSIGN_OR_RETURN(const auto header, segments.peek<RecordHeader>(), {});
+  REQUIRE_EQ(header.version, kTls12, "wrong protocol");
+  REQUIRE(header.content_type == ContentType::ApplicationData, "Expected application data after handshake");
+  const uint16_t record_size = header.size.value();
+  if (segments.size() < sizeof(RecordHeader) + record_size) {
+    return {};
+  }
+  segments.consume(sizeof(RecordHeader));
+  iv.explicit_iv = segments.peek<ExplicitIV>().value();
+  segments.consume(sizeof(ExplicitIV));
+  const size_t ciphertext_size = record_size - sizeof(ExplicitIV);
+  auto ciphertext = segments.linearise(ciphertext_size).value();
+  segments.consume(ciphertext_size);
+  return decrypt(ciphertext);
+}
+
 void
-Client::process_packet(tcp::PacketView tcp_packet) {
-  tcp.process_packet(tcp_packet);
+Client::process_packet(const dpdk::RxPacket& packet) {
+  if (zero_copy) [[likely]] {
+    update_receive_space();
+    tcp.process_packet(packet, [&](base::ByteView bytes, const dpdk::RxPacket& owner) { segments.push(owner, bytes); });
+    return;
+  }
+  if (is_handshake_complete()) {
+    // From here on records are decrypted inside the mbufs. The stream is not used anymore, so whatever is left in it
+    // is handed over without a copy.
+    zero_copy = true;
+    segments.push_borrowed(stream.pop(stream.size()).value_or(base::MutableByteView{}));
+    DEBUG("Tls handshake is complete, switching to zero-copy receive");
+    process_packet(packet);
+    return;
+  }
   stream.shift();
-  stream.push_bytes(tcp_packet.payload());
+  update_receive_space();
+  tcp.process_packet(packet, [&](base::ByteView bytes, const dpdk::RxPacket&) { stream.push_bytes(bytes); });
   TRACE("-------------------TCP PACKET--------------------");
 }
 
+void
+Client::update_receive_space() {
+  if (zero_copy) {
+    const size_t target = tcp.receive_buffer_target();
+    // Every held segment pins a whole mbuf, however little of it is payload. The window also covers no more full
+    // segments than the mbufs left, so a peer sending tiny segments can not drain the pool.
+    const size_t mbufs = max_held_mbufs - std::min(max_held_mbufs, segments.segments_size());
+    tcp.set_receive_space(std::min(target - std::min(target, segments.size()), mbufs * tcp::Client::kDefaultMss));
+    return;
+  }
+  // Nothing points into the stream between packets, so it can be grown here
+  stream.reserve(tcp.receive_buffer_target());
+  tcp.set_receive_space(stream.total_available_bytes());
+}
+
 void
 Client::process_handshake() {
   DEBUG("Connecting. state: {}", handshake_state);
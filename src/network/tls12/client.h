@@ -6,6 +6,7 @@
 #include "base/stream/stream.h"
 #include "base/type/span.h"
 #include "network/tcp/client.h"
+#include "network/tcp/receive_buffer.h"
 #include "openssl.h"
 
 #include "model.h"
@@ -14,10 +15,15 @@
 namespace idk::net::tls12 {
 
 struct Client : base::NoCopy {
-  Client(const std::string& sni_hostname, tcp::Client tcp_client);
+  // In zero-copy mode the connection holds at most `max_held_mbufs` received mbufs. The connections of a port share
+  // its rx pool, so this is their share of it.
+  Client(const std::string& sni_hostname, tcp::Client tcp_client, size_t max_held_mbufs);
 
   Client(Client&& other) = default;
 
+  // A record is decrypted once all of it arrived, fewer mbufs could not hold one of the largest size in full segments
+  static constexpr size_t kMinHeldMbufs = tcp::ReceiveBuffer::kScratchSize / tcp::Client::kDefaultMss + 1;
+
   enum class HandshakeState {
     ClientHelloToSend = 0,
     ServerHello,
@@ -51,14 +57,42 @@ struct Client : base::NoCopy {
     send_buffer.push_bytes(s);
   }
 
+  // Seals the pushed data into records, one per segment. Deferred while corked.
   void
   flush();
 
+  // The data flushed while corked goes into shared records on `uncork`, instead of a record and a segment per flush.
+  // The tcp connection is corked too, so it sends full segments only. Calls nest, see tcp::Cork.
+  void
+  cork() {
+    corked++;
+    tcp.cork();
+  }
+
+  void
+  uncork();
+
   std::optional<base::MutableByteView>
   receive();
 
   void
-  process_packet(tcp::PacketView tcp_packet);
+  process_packet(const dpdk::RxPacket& packet);
+
+  void
+  on_data_consumed() {
+    tcp.on_data_consumed();
+  }
+
+  void
+  on_burst_end() {
+    tcp.on_burst_end();
+  }
+
+  // False while the tcp send queue is backed up, flushed data is still accepted but only queued
+  bool
+  writable() const {
+    return tcp.writable();
+  }
 
   HandshakeState
   state() const {
@@ -75,6 +109,21 @@ struct Client : base::NoCopy {
     return tcp.get_connection();
   }
 
+  tcp::Client::State
+  tcp_state() const {
+    return tcp.get_state();
+  }
+
+  tcp::ClientStats
+  tcp_stats() const {
+    return tcp.stats();
+  }
+
+  const base::SeqLock<tcp::ClientStats>&
+  published_tcp_stats() const {
+    return tcp.published_stats();
+  }
+
 private:
   void
   process_handshake();
@@ -106,9 +155,22 @@ private:
   void
   send_client_certificate();
 
+  // Application data record decrypted inside the receive buffer
+  std::optional<base::MutableByteView>
+  receive_in_place();
+
+  // The tcp window is the free space of the receive buffer
+  void
+  update_receive_space();
+
   base::Stream send_buffer{20600};
   tcp::Client tcp;
+  // Handshake records are parsed from `stream`, application data from `segments`
   base::Stream stream{20600};
+  tcp::ReceiveBuffer segments;
+  size_t max_held_mbufs;
+  bool zero_copy{false};
+  uint8_t corked{0};
 
   struct TLSRandoms {
     TLSRandom server;
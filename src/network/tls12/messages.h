@@ -69,6 +69,7 @@ constexpr SHA256RSAExtension kSHA256RSAExtension = {
     .extension_type = TlsExtension::SIGNATURE_ALGORITHMS,
     .extension_size = sizeof(SHA256RSAExtension) - sizeof(TLSExtensionHeader)
   },
+  .size = sizeof(SHA256RSAExtension::algorithms),
   .algorithms = {{HashAlgo::SHA256, SignatureAlgo::RSA}}
 };
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "network/type/big_endian.h"
+#include "network/type/ip.h"
+
+namespace idk::net::udp {
+
+enum class IgmpVersion : uint8_t {
+  V2 = 2,
+  V3 = 3,
+};
+
+#pragma pack(push, 1)
+
+enum class IgmpType : uint8_t {
+  MembershipQuery = 0x11,
+  V2MembershipReport = 0x16,
+  V2LeaveGroup = 0x17,
+  V3MembershipReport = 0x22,
+};
+
+// RFC 2236
+struct IgmpV2Message {
+  IgmpType type;
+  uint8_t max_response_time;
+  BE<uint16_t> checksum;
+  Ip group;
+};
+
+static_assert(sizeof(IgmpV2Message) == 8);
+
+// RFC 3376 4.2.12
+enum class IgmpV3RecordType : uint8_t {
+  ModeIsInclude = 1,
+  ModeIsExclude = 2,
+  ChangeToIncludeMode = 3,
+  ChangeToExcludeMode = 4,
+};
+
+struct IgmpV3GroupRecord {
+  IgmpV3RecordType type;
+  uint8_t aux_data_len;
+  BE<uint16_t> sources;
+  Ip group;
+};
+
+// Report with a single any-source record, which is all we send
+struct IgmpV3Report {
+  IgmpType type;
+  uint8_t reserved;
+  BE<uint16_t> checksum;
+  BE<uint16_t> reserved2;
+  BE<uint16_t> records;
+  IgmpV3GroupRecord record;
+};
+
+static_assert(sizeof(IgmpV3Report) == 16);
+
+// Router Alert ip option (RFC 2113), required on every IGMP message
+struct RouterAlertOption {
+  uint8_t type{0x94};
+  uint8_t length{4};
+  BE<uint16_t> value{0};
+};
+
+static_assert(sizeof(RouterAlertOption) == 4);
+
+#pragma pack(pop)
+
+} // namespace idk::net::udp
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "network/type/big_endian.h"
+#include "network/type/port.h"
+
+namespace idk::net::udp {
+
+#pragma pack(push, 1)
+
+struct HeaderReflection {
+  Port src_port;
+  Port dst_port;
+  uint16_t length;
+  BE<uint16_t> checksum;
+};
+
+struct Header {
+  static constexpr bool kLoggable = true;
+
+  using ReflectionType = HeaderReflection;
+
+  [[nodiscard]] ReflectionType
+  reflection() const {
+    return {src_port, dst_port, length.value(), checksum};
+  }
+
+  Port src_port;
+  Port dst_port;
+  BE<uint16_t> length;
+  BE<uint16_t> checksum;
+};
+
+static_assert(sizeof(Header) == 8);
+
+#pragma pack(pop)
+
+} // namespace idk::net::udp
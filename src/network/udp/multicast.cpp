@@ -0,0 +1,153 @@
+#include "multicast.h"
+
+#include <algorithm>
+
+#include "base/macros/require.h"
+#include "network/eth_ip/checksum.h"
+#include "network/eth_ip/ip.h"
+
+namespace idk::net::udp {
+
+namespace {
+
+const Ip kAllRouters("224.0.0.2");
+const Ip kIgmpV3Routers("224.0.0.22");
+
+template<typename T>
+void
+set_checksum(T& message) {
+  message.checksum = 0;
+  const uint16_t checksum = ~checksum_fold(checksum_add(base::to_byte_view(message)));
+  message.checksum = BE<uint16_t>::from_big_endian(checksum);
+}
+
+} // namespace
+
+MulticastMembership::MulticastMembership(Host local_host, dpdk::Sender sender, IgmpVersion version) :
+    local_host(local_host), sender(sender), version(version), report_interval(kReportInterval) {
+  groups.reserve(kMaxGroups);
+}
+
+MulticastMembership::~MulticastMembership() {
+  for (auto group: groups) {
+    send_report(group, false);
+  }
+}
+
+void
+MulticastMembership::join(Ip group) {
+  REQUIRE(is_multicast(group), "{} is not a multicast group", group);
+  if (is_member(group)) {
+    return;
+  }
+  REQUIRE_LT(groups.size(), kMaxGroups, "Too many multicast groups");
+  groups.push_back(group);
+  update_filter();
+  send_report(group, true);
+  INFO("Joined multicast group {}", group);
+}
+
+void
+MulticastMembership::leave(Ip group) {
+  if (std::erase(groups, group) == 0) {
+    return;
+  }
+  send_report(group, false);
+  update_filter();
+  INFO("Left multicast group {}", group);
+}
+
+bool
+MulticastMembership::is_member(Ip group) const {
+  return std::ranges::find(groups, group) != groups.end();
+}
+
+void
+MulticastMembership::poll() {
+  const auto now = base::RdtscClock::now();
+  if (now < next_report) {
+    return;
+  }
+  next_report = now + report_interval;
+  for (auto group: groups) {
+    send_report(group, true);
+  }
+}
+
+Mac
+MulticastMembership::group_mac(Ip group) {
+  const auto* ip = reinterpret_cast<const uint8_t*>(&group.data());
+  Mac mac;
+  const uint8_t bytes[Mac::kSize] = {0x01, 0x00, 0x5e, static_cast<uint8_t>(ip[1] & 0x7f), ip[2], ip[3]};
+  std::copy(std::begin(bytes), std::end(bytes), mac.data());
+  return mac;
+}
+
+bool
+MulticastMembership::is_multicast(Ip ip) {
+  return (reinterpret_cast<const uint8_t*>(&ip.data())[0] & 0xf0) == 0xe0;
+}
+
+void
+MulticastMembership::send_report(Ip group, bool join) {
+  const size_t message_size = version == IgmpVersion::V2 ? sizeof(IgmpV2Message) : sizeof(IgmpV3Report);
+  Ip dst = group;
+  if (version == IgmpVersion::V3) {
+    dst = kIgmpV3Routers;
+  } else if (!join) {
+    dst = kAllRouters;
+  }
+
+  auto bytes = sender.send_raw(IPPacketView::predict_size(sizeof(RouterAlertOption) + message_size));
+  IPPacketView ip(bytes);
+  ip.init(Session{.src = local_host, .dst = {.mac = group_mac(dst), .ip = dst}}, IpProtocol::Igmp);
+  auto& header = ip.header();
+  header.ihl = (sizeof(IpHeader) + sizeof(RouterAlertOption)) / 4;
+  header.ttl = 1;
+  *base::start_lifetime_as<RouterAlertOption>(reinterpret_cast<uint8_t*>(&header) + sizeof(IpHeader)) = {};
+  ip.resize_payload(message_size);
+
+  if (version == IgmpVersion::V2) {
+    auto& message = *base::start_lifetime_as<IgmpV2Message>(ip.payload().data());
+    message = IgmpV2Message{
+        .type = join ? IgmpType::V2MembershipReport : IgmpType::V2LeaveGroup,
+        .max_response_time = 0,
+        .checksum = 0,
+        .group = group,
+    };
+    set_checksum(message);
+  } else {
+    auto& message = *base::start_lifetime_as<IgmpV3Report>(ip.payload().data());
+    message = IgmpV3Report{
+        .type = IgmpType::V3MembershipReport,
+        .reserved = 0,
+        .checksum = 0,
+        .reserved2 = 0,
+        .records = 1,
+        .record = {.type = join ? IgmpV3RecordType::ChangeToExcludeMode : IgmpV3RecordType::ChangeToIncludeMode,
+                   .aux_data_len = 0,
+                   .sources = 0,
+                   .group = group},
+    };
+    set_checksum(message);
+  }
+
+  header.check = 0;
+  const uint16_t ip_checksum = ~checksum_fold(checksum_add({reinterpret_cast<const uint8_t*>(&header), header.size()}));
+  header.check = BE<uint16_t>::from_big_endian(ip_checksum);
+
+  sender.flush();
+  TRACE("Sent IGMPv{} {} for {}", static_cast<int>(version), join ? "report" : "leave", group);
+}
+
+void
+MulticastMembership::update_filter() {
+  std::vector<Mac> macs;
+  macs.reserve(groups.size());
+  for (auto group: groups) {
+    macs.push_back(group_mac(group));
+  }
+  sender.set_multicast_filter(macs);
+}
+
+} // namespace idk::net::udp
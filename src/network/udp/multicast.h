@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/type/default_constructor.h"
+#include "igmp.h"
+#include "network/dpdk/sender.h"
+#include "network/type/endpoint.h"
+
+namespace idk::net::udp {
+
+// Multicast group membership of one interface. Joining a group programs the NIC mac filter and announces the group
+// with an IGMP report. Queries are not answered, instead reports are repeated from `poll` well within the group
+// membership interval, which keeps snooping switches and the querier forwarding the groups.
+class MulticastMembership : base::NoCopy {
+public:
+  static constexpr size_t kMaxGroups = 32;
+  static constexpr std::chrono::seconds kReportInterval{60};
+
+  MulticastMembership(Host local_host, dpdk::Sender sender, IgmpVersion version = IgmpVersion::V3);
+
+  ~MulticastMembership();
+
+  void
+  join(Ip group);
+
+  void
+  leave(Ip group);
+
+  [[nodiscard]] bool
+  is_member(Ip group) const;
+
+  void
+  poll();
+
+  // 01:00:5e followed by the low 23 bits of the group address (RFC 1112)
+  [[nodiscard]] static Mac
+  group_mac(Ip group);
+
+  [[nodiscard]] static bool
+  is_multicast(Ip ip);
+
+private:
+  void
+  send_report(Ip group, bool join);
+
+  void
+  update_filter();
+
+  Host local_host;
+  dpdk::Sender sender;
+  IgmpVersion version;
+  std::vector<Ip> groups;
+  base::RdtscDuration report_interval;
+  base::RdtscClock::time_point next_report;
+};
+
+} // namespace idk::net::udp
@@ -0,0 +1,83 @@
+#include "packet_view.h"
+
+#include <rte_ip.h>
+
+#include "base/logger/macros.h"
+
+namespace idk::net::udp {
+
+void
+PacketView::init(Connection connection) {
+  ip_packet_view.init(connection.session, IpProtocol::Udp);
+
+  Header& hdr = header();
+  hdr.src_port = connection.src_port;
+  hdr.dst_port = connection.dst_port;
+  hdr.length = sizeof(Header);
+  hdr.checksum = 0; // To be calculated later
+}
+
+void
+PacketView::update_checksum() {
+  header().checksum = 0;
+  const uint16_t cksum =
+      rte_ipv4_udptcp_cksum(reinterpret_cast<const rte_ipv4_hdr*>(&ip_packet_view.header()), &header());
+  header().checksum = BE<uint16_t>::from_big_endian(cksum);
+}
+
+size_t
+PacketView::predict_size(size_t payload_size) {
+  return IPPacketView::predict_size(sizeof(Header) + payload_size);
+}
+
+void
+PacketView::resize_payload(size_t payload_size) {
+  ip_packet_view.resize_payload(sizeof(Header) + payload_size);
+  header().length = sizeof(Header) + payload_size;
+}
+
+bool
+PacketView::is_valid() const {
+  if (!ip_packet_view.is_valid()) [[unlikely]] {
+    return false;
+  }
+  const auto ip_payload = ip_packet_view.payload();
+  const bool is_valid = ip_payload.size() >= sizeof(Header) && header().length.value() >= sizeof(Header) &&
+                        header().length.value() <= ip_payload.size();
+  if (!is_valid) [[unlikely]] {
+    TRACE_L2("ip payload size: {}, udp length: {}", ip_payload.size(), header().length.value());
+  }
+  return is_valid;
+}
+
+base::MutableByteView
+PacketView::payload() {
+  return {ip_packet_view.payload().data() + sizeof(Header), header().length.value() - sizeof(Header)};
+}
+
+base::ByteView
+PacketView::payload() const {
+  return {ip_packet_view.payload().data() + sizeof(Header), header().length.value() - sizeof(Header)};
+}
+
+EthernetPacketView
+PacketView::eth() {
+  return ip_packet_view.eth();
+}
+
+IPPacketView
+PacketView::ip() const {
+  return ip_packet_view;
+}
+
+Header&
+PacketView::header() {
+  return *base::start_lifetime_as<Header>(ip_packet_view.payload().data());
+}
+
+const Header&
+PacketView::header() const {
+  return *base::start_lifetime_as<Header>(ip_packet_view.payload().data());
+}
+
+} // namespace idk::net::udp
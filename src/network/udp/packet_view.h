@@ -0,0 +1,53 @@
+#pragma once
+
+#include "base/type/span.h"
+#include "model.h"
+#include "network/eth_ip/ip.h"
+#include "network/type/endpoint.h"
+
+namespace idk::net::udp {
+
+class PacketView {
+public:
+  explicit PacketView(base::MutableByteView bytes) : ip_packet_view(bytes) {}
+
+  explicit PacketView(IPPacketView bytes) : ip_packet_view(bytes) {}
+
+  void
+  init(Connection connection);
+
+  void
+  update_checksum();
+
+  static size_t
+  predict_size(size_t payload_size);
+
+  void
+  resize_payload(size_t payload_size);
+
+  [[nodiscard]] bool
+  is_valid() const;
+
+  [[nodiscard]] base::MutableByteView
+  payload();
+
+  [[nodiscard]] base::ByteView
+  payload() const;
+
+  EthernetPacketView
+  eth();
+
+  [[nodiscard]] IPPacketView
+  ip() const;
+
+  Header&
+  header();
+
+  [[nodiscard]] const Header&
+  header() const;
+
+private:
+  IPPacketView ip_packet_view;
+};
+
+} // namespace idk::net::udp
@@ -0,0 +1,61 @@
+#include "receiver.h"
+
+#include "base/logger/macros.h"
+#include "base/macros/require.h"
+
+namespace idk::net::udp {
+
+void
+Receiver::subscribe(Port dst_port, Callback callback) {
+  for (const auto& el: subscriptions) {
+    REQUIRE(el.dst_port != dst_port.value(), "Port {} already has a subscriber", dst_port);
+  }
+  subscriptions.push_back({.dst_port = dst_port.value(), .callback = std::move(callback)});
+}
+
+void
+Receiver::set_membership(const MulticastMembership& membership_) {
+  membership = &membership_;
+}
+
+void
+Receiver::attach(dispatch::Dispatcher& dispatcher) {
+  for (size_t i = 0; i < subscriptions.size(); ++i) {
+    dispatcher.on_udp(Port(subscriptions[i].dst_port), [this, i](std::span<dpdk::RxPacket> packets) {
+      for (auto& packet: packets) {
+        deliver(subscriptions[i], PacketView(packet.bytes()));
+      }
+    });
+  }
+}
+
+bool
+Receiver::process_packet(PacketView datagram) {
+  const auto dst_port = datagram.header().dst_port.value();
+  for (const auto& el: subscriptions) {
+    if (el.dst_port == dst_port) {
+      return deliver(el, datagram);
+    }
+  }
+  dropped_++;
+  return false;
+}
+
+bool
+Receiver::deliver(const Subscription& subscription, PacketView datagram) {
+  if (!datagram.is_valid()) [[unlikely]] {
+    TRACE("Dropping invalid datagram");
+    dropped_++;
+    return false;
+  }
+  const auto dst_ip = datagram.ip().header().dst_addr;
+  if (membership && MulticastMembership::is_multicast(dst_ip) && !membership->is_member(dst_ip)) {
+    TRACE("Dropping datagram to {}, the group is not joined", dst_ip);
+    dropped_++;
+    return false;
+  }
+  subscription.callback(datagram);
+  return true;
+}
+
+} // namespace idk::net::udp
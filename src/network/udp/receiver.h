@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "base/type/default_constructor.h"
+#include "multicast.h"
+#include "network/dispatch/dispatcher.h"
+#include "packet_view.h"
+
+namespace idk::net::udp {
+
+// Delivers datagrams to the callback subscribed to their dst port.
+class Receiver : base::NoCopy {
+public:
+  using Callback = std::function<void(const PacketView& datagram)>;
+
+  void
+  subscribe(Port dst_port, Callback callback);
+
+  // Datagrams sent to groups which are not joined are dropped. The NIC filter is not enough for that, the port runs
+  // in promiscuous mode when RSS is on.
+  void
+  set_membership(const MulticastMembership& membership);
+
+  // Routes every subscribed port of `dispatcher` here. Subscriptions made afterwards are not routed.
+  void
+  attach(dispatch::Dispatcher& dispatcher);
+
+  // Returns false if the datagram was dropped
+  bool
+  process_packet(PacketView datagram);
+
+  [[nodiscard]] uint64_t
+  dropped() const {
+    return dropped_;
+  }
+
+private:
+  struct Subscription {
+    uint16_t dst_port;
+    Callback callback;
+  };
+
+  bool
+  deliver(const Subscription& subscription, PacketView datagram);
+
+  std::vector<Subscription> subscriptions;
+  const MulticastMembership* membership{nullptr};
+  uint64_t dropped_{0};
+};
+
+} // namespace idk::net::udp
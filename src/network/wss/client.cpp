@@ -76,6 +76,34 @@ Client::accept_handshake() {
   return true;
 }
 
+void
+Client::send(OpCode code, base::ByteView payload) {
+  REQUIRE_EQ(state, State::Connected, "Not connected");
+  frame.clear();
+  frame.push_back(0x80 | uint8_t(code));
+  if (payload.size() < 126) {
+    frame.push_back(0x80 | uint8_t(payload.size()));
+  } else if (payload.size() <= UINT16_MAX) {
+    frame.push_back(0x80 | 126);
+    for (int shift = 8; shift >= 0; shift -= 8) {
+      frame.push_back(uint8_t(payload.size() >> shift));
+    }
+  } else {
+    frame.push_back(0x80 | 127);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      frame.push_back(uint8_t(uint64_t{payload.size()} >> shift));
+    }
+  }
+  const uint32_t key = mask_keys();
+  const auto mask = base::to_byte_view(key);
+  frame.insert(frame.end(), mask.begin(), mask.end());
+  for (size_t i = 0; i < payload.size(); ++i) {
+    frame.push_back(payload[i] ^ mask[i % mask.size()]);
+  }
+  tls->push_bytes(frame);
+  tls->flush();
+}
+
 std::optional<base::ByteView>
 Client::next_message() {
   auto tls_result = tls->receive();
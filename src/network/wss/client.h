@@ -1,6 +1,8 @@
 #pragma once
 
+#include <random>
 #include <utility>
+#include <vector>
 
 #include "base/logger/logger.h"
 #include "base/type/span.h"
@@ -20,8 +22,10 @@ public:
   };
   enum class State : uint8_t { Init = 0, HttpHandshake, Connected };
 
-  explicit Client(Config config_ws, tcp::Client tcp_client) : LoggableComponent("ws"), config(std::move(config_ws)) {
-    tls.emplace(config.host, std::move(tcp_client));
+  // See tls12::Client for `max_held_mbufs`
+  Client(Config config_ws, tcp::Client tcp_client, size_t max_held_mbufs) :
+      LoggableComponent("ws"), config(std::move(config_ws)) {
+    tls.emplace(config.host, std::move(tcp_client), max_held_mbufs);
   }
 
   Client(Client&&) = default;
@@ -40,13 +44,78 @@ public:
   accept_handshake();
 
   void
-  process_packet(tcp::PacketView tcp_packet) {
-    tls->process_packet(tcp_packet);
+  process_packet(const dpdk::RxPacket& packet) {
+    tls->process_packet(packet);
+  }
+
+  // Called once every message of the packet is handled
+  void
+  on_data_consumed() {
+    tls->on_data_consumed();
+  }
+
+  void
+  on_burst_end() {
+    tls->on_burst_end();
+  }
+
+  bool
+  writable() const {
+    return tls->writable();
+  }
+
+  void
+  cork() {
+    tls->cork();
+  }
+
+  void
+  uncork() {
+    tls->uncork();
+  }
+
+  tcp::ClientStats
+  tcp_stats() const {
+    return tls->tcp_stats();
+  }
+
+  const base::SeqLock<tcp::ClientStats>&
+  published_tcp_stats() const {
+    return tls->published_tcp_stats();
   }
 
   std::optional<base::ByteView>
   next_message();
 
+  // Sends one unfragmented frame, masked as every client frame must be (RFC 6455 5.3). Connected only.
+  void
+  send(OpCode code, base::ByteView payload);
+
+  void
+  send_text(std::string_view text) {
+    send(OpCode::Text, {reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+  }
+
+  bool
+  is_tls_handshake_complete() const {
+    return tls->is_handshake_complete();
+  }
+
+  // The upgrade is done, messages flow both ways
+  bool
+  is_connected() const {
+    return state == State::Connected;
+  }
+
+  tcp::Client::State
+  tcp_state() const {
+    return tls->tcp_state();
+  }
+
+  Connection
+  get_connection() const {
+    return tls->get_connection();
+  }
 
 private:
   std::optional<tls12::Client> tls;
@@ -56,6 +125,9 @@ private:
 
   std::optional<dpdk::Sender> sender;
   Config config;
+  // Masking keys, and the frame being masked
+  std::mt19937 mask_keys{std::random_device{}()};
+  std::vector<uint8_t> frame;
 };
 
 
@@ -0,0 +1,193 @@
+#include "connection_pool.h"
+
+#include <algorithm>
+
+#include "base/logger/macros.h"
+
+namespace idk::net::wss {
+
+void
+ConnectionPool::StageStats::add(std::chrono::nanoseconds duration) {
+  const int64_t ns = duration.count();
+  min_ns = count == 0 ? ns : std::min(min_ns, ns);
+  max_ns = std::max(max_ns, ns);
+  total_ns += ns;
+  count++;
+}
+
+ConnectionPool::ConnectionPool(Config config_, const Connection& connection, uint16_t queue, tcp::PortAllocator& ports,
+                               Connections& connections, TcpFactory make_tcp) :
+    LoggableComponent("ws_pool"), config(std::move(config_)), connection(connection), queue(queue), ports(ports),
+    connections(connections), make_tcp(std::move(make_tcp)), scheduler(config.connect) {
+  // E.g. the ACKs owed at the end of the burst could not be sent
+  connections.on_failure([this](Session& session, const std::exception& e) {
+    if (!session.failed) {
+      fail(session, e.what());
+    }
+  });
+}
+
+uint32_t
+ConnectionPool::add_stream(Client::Config ws, std::vector<std::string> subscriptions, std::optional<Port> src_port) {
+  const uint32_t id = streams_.size();
+  streams_.push_back({.ws = std::move(ws), .subscriptions = std::move(subscriptions), .src_port = src_port});
+  const auto now = base::RdtscClock::now();
+  for (size_t i = 0; i < config.standby + 1; ++i) {
+    scheduler.request(id, now);
+  }
+  return id;
+}
+
+void
+ConnectionPool::open(uint32_t id, time_point now) {
+  Stream& stream = streams_[id];
+  Connection next = connection;
+  if (stream.src_port) {
+    next.src_port = stream.src_port.value();
+    stream.src_port.reset();
+  } else {
+    const auto port = ports.allocate(connection.session.src.ip,
+                                     Endpoint{.ip = connection.session.dst.ip, .port = connection.dst_port}, queue);
+    if (!port) [[unlikely]] {
+      ERROR("No free source port hashes to queue {}", queue);
+      scheduler.finished();
+      scheduler.request(id, now + scheduler.backoff(++stream.failures));
+      return;
+    }
+    next.src_port = port.value();
+  }
+  if (!first_attempt) [[unlikely]] {
+    first_attempt = now;
+  }
+  // Every stream keeps its active connection and the standbys, a replacement is opened once the one it replaces is
+  // gone. Too many connections for the pool still get enough to hold a record, and overcommit it.
+  const size_t held_mbufs =
+      std::max(config.held_mbufs / (streams_.size() * (config.standby + 1)), tls12::Client::kMinHeldMbufs);
+  auto& session = connections.add(next, stream.ws, make_tcp(next), held_mbufs, id, now);
+  stream.sessions.push_back(&session);
+  sessions.push_back(&session);
+  stats_.opened++;
+  DEBUG("Connection {} of stream {} opened, {} in flight", next, id, scheduler.in_flight());
+}
+
+void
+ConnectionPool::advance(Session& session, time_point now) {
+  using Stage = Session::Stage;
+  auto& client = session.client;
+  if (session.stage == Stage::Tcp && client.tcp_state() == tcp::Client::State::Connected) {
+    stats_.tcp.add(now - session.stage_started);
+    session.stage = Stage::Tls;
+    session.stage_started = now;
+  }
+  if (session.stage == Stage::Tls && client.is_tls_handshake_complete()) {
+    stats_.tls.add(now - session.stage_started);
+    session.stage = Stage::Upgrade;
+    session.stage_started = now;
+  }
+  if (session.stage == Stage::Upgrade && client.is_connected()) {
+    stats_.upgrade.add(now - session.stage_started);
+    on_ready(session);
+  }
+}
+
+void
+ConnectionPool::on_ready(Session& session) {
+  Stream& stream = streams_[session.stream];
+  {
+    // The subscriptions leave in as few segments as possible
+    tcp::Cork cork(session.client);
+    for (const auto& subscription: stream.subscriptions) {
+      session.client.send_text(subscription);
+    }
+    cork.uncork();
+  }
+  session.stage = Session::Stage::Ready;
+  scheduler.finished();
+  stream.failures = 0;
+  stats_.ready++;
+  DEBUG("Connection {} of stream {} is ready", session.client.get_connection(), session.stream);
+  if (stream.active == nullptr && activate_standby(stream)) {
+    streams_up_++;
+    if (!all_up_logged && streams_up_ == streams_.size()) {
+      all_up_logged = true;
+      const std::chrono::milliseconds elapsed = base::RdtscClock::now() - first_attempt.value();
+      INFO("All {} streams are up {}ms after the first attempt, {}", streams_.size(), elapsed.count(), stats_);
+    }
+  }
+}
+
+void
+ConnectionPool::fail(Session& session, std::string_view reason) {
+  session.failed = true;
+  has_failed = true;
+  stats_.failed++;
+  WARN("Connection {} of stream {} failed: {}", session.client.get_connection(), session.stream, reason);
+
+  Stream& stream = streams_[session.stream];
+  if (session.stage != Session::Stage::Ready) {
+    // A failed attempt, the next one backs off
+    scheduler.finished();
+    stream.failures++;
+  }
+  scheduler.request(session.stream, base::RdtscClock::now() + scheduler.backoff(stream.failures));
+
+  if (stream.active == &session) {
+    stream.active = nullptr;
+    if (activate_standby(stream)) {
+      stats_.failovers++;
+    } else {
+      streams_up_--;
+      stats_.outages++;
+      ERROR("Stream {} has no standby connection ready", session.stream);
+    }
+  }
+}
+
+bool
+ConnectionPool::activate_standby(Stream& stream) {
+  for (auto* session: stream.sessions) {
+    if (session->stage == Session::Stage::Ready && !session->failed) {
+      stream.active = session;
+      INFO("Connection {} of stream {} is active", session->client.get_connection(), session->stream);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+ConnectionPool::check(time_point now) {
+  next_check = now + base::RdtscDuration(kCheckInterval);
+  for (auto* session: sessions) {
+    if (session->failed) {
+      continue;
+    }
+    if (session->client.tcp_state() == tcp::Client::State::Offline) [[unlikely]] {
+      fail(*session, "connection is offline");
+    } else if (session->stage != Session::Stage::Ready &&
+               session->started + base::RdtscDuration(config.setup_timeout) < now) [[unlikely]] {
+      stats_.timeouts++;
+      fail(*session, "not ready in time");
+    }
+  }
+}
+
+void
+ConnectionPool::remove_failed() {
+  has_failed = false;
+  for (size_t idx = 0; idx < sessions.size();) {
+    Session* session = sessions[idx];
+    if (!session->failed) {
+      ++idx;
+      continue;
+    }
+    std::erase(streams_[session->stream].sessions, session);
+    sessions[idx] = sessions.back();
+    sessions.pop_back();
+    const Connection failed = session->client.get_connection();
+    connections.remove(failed);
+    ports.release(failed.src_port);
+  }
+}
+
+} // namespace idk::net::wss
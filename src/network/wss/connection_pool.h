@@ -0,0 +1,240 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/clock/rdtsc_clock.h"
+#include "base/logger/logger.h"
+#include "network/tcp/connect_scheduler.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/port_allocator.h"
+
+#include "client.h"
+
+namespace idk::net::wss {
+
+// Websocket connections of a worker to one server, grouped in streams. Every stream has one active connection and
+// `standby` warm ones, each from its own source port and fully set up: tcp and tls handshakes, the upgrade and the
+// stream's subscriptions. Standbys receive the same messages, which are dropped. When the active connection fails (a
+// RST, a protocol error, a retransmission timeout) the oldest ready standby takes over at once, without a round trip,
+// and a replacement is built in the background from a fresh port whose replies land on the same rx queue.
+//
+// The handshakes of all connections run concurrently, driven by the segments they receive, and a
+// tcp::ConnectScheduler paces the attempts and the retries. The time spent in each handshake stage is measured.
+class ConnectionPool : public base::LoggableComponent, public base::NoCopy {
+public:
+  using time_point = base::RdtscClock::time_point;
+
+  struct Config {
+    // Ready connections kept per stream besides the active one
+    size_t standby{0};
+    // An attempt not ready by then is dropped and retried
+    std::chrono::milliseconds setup_timeout{5000};
+    // Received mbufs the connections of the pool may hold at once, split evenly among them. Half of the 16384 the dpdk
+    // master gives a port by default.
+    size_t held_mbufs{8192};
+    tcp::ConnectScheduler::Config connect;
+  };
+
+  // Durations of one handshake stage
+  struct StageStats {
+    static constexpr bool kLoggable = true;
+
+    void
+    add(std::chrono::nanoseconds duration);
+
+    uint64_t count{0};
+    int64_t min_ns{0};
+    int64_t max_ns{0};
+    int64_t total_ns{0};
+  };
+
+  struct Stats {
+    static constexpr bool kLoggable = true;
+
+    uint64_t opened{0};
+    uint64_t ready{0};
+    uint64_t failed{0};
+    // Failed attempts which were not ready within the setup timeout
+    uint64_t timeouts{0};
+    // A standby took over from the failed active connection
+    uint64_t failovers{0};
+    // The active connection failed with no standby ready, messages of the stream stop until one is
+    uint64_t outages{0};
+    // From the SYN to the tcp handshake done, from there to the tls handshake done, and from there to the upgrade
+    StageStats tcp;
+    StageStats tls;
+    StageStats upgrade;
+  };
+
+  // A connection of the pool, the session type of its ConnectionManager
+  struct Session : base::NoCopy {
+    enum class Stage : uint8_t { Tcp, Tls, Upgrade, Ready };
+
+    Session(Client::Config ws, tcp::Client tcp, size_t max_held_mbufs, uint32_t stream, time_point now) :
+        client(std::move(ws), std::move(tcp), max_held_mbufs), stream(stream), started(now), stage_started(now) {}
+
+    void
+    on_burst_end() {
+      client.on_burst_end();
+    }
+
+    Client client;
+    uint32_t stream;
+    Stage stage{Stage::Tcp};
+    // Removed on the next `poll`
+    bool failed{false};
+    time_point started;
+    time_point stage_started;
+  };
+
+  using Connections = tcp::ConnectionManager<Session>;
+
+  // The tcp client of `connection` with the ack policy, next hop etc. set, not connected yet
+  using TcpFactory = std::function<tcp::Client(const Connection& connection)>;
+
+  // Connections go from `connection.session.src` to the destination of `connection` from ports of `ports` whose
+  // replies arrive on `queue`. The sessions live in `connections`, both must outlive the pool. A session which throws
+  // in `connections` is failed like any other.
+  ConnectionPool(Config config, const Connection& connection, uint16_t queue, tcp::PortAllocator& ports,
+                 Connections& connections, TcpFactory make_tcp);
+
+  // Adds a stream of `ws.path` and queues the attempts of its connections, `subscriptions` are sent on each once it is
+  // upgraded. The first connection uses `src_port` if set, which the caller reserved in `ports`. Stream ids are dense
+  // from 0.
+  uint32_t
+  add_stream(Client::Config ws, std::vector<std::string> subscriptions, std::optional<Port> src_port = {});
+
+  // Handles a segment of one of the pool's sessions, call it from ConnectionManager::process. The messages of the
+  // active connections go to `on_message(stream, payload)`, an exception thrown by it counts as a failure of the
+  // connection too.
+  template<typename F>
+  void
+  process_packet(Session& session, const dpdk::RxPacket& packet, F&& on_message) {
+    if (session.failed) [[unlikely]] {
+      return;
+    }
+    try {
+      session.client.process_packet(packet);
+      const bool active = streams_[session.stream].active == &session;
+      auto message = session.client.next_message();
+      while (message) {
+        if (active) [[likely]] {
+          on_message(session.stream, message.value());
+        }
+        message = session.client.next_message();
+      }
+      session.client.on_data_consumed();
+      if (session.stage != Session::Stage::Ready) [[unlikely]] {
+        advance(session, base::RdtscClock::now());
+      }
+    } catch (const std::exception& e) {
+      fail(session, e.what());
+    }
+  }
+
+  // Starts the attempts the scheduler lets through and drops the failed connections. Checks every connection for a
+  // timeout once per `kCheckInterval`. Call it from the poll loop.
+  void
+  poll(time_point now) {
+    if (next_check <= now) [[unlikely]] {
+      check(now);
+    }
+    if (has_failed) [[unlikely]] {
+      remove_failed();
+    }
+    while (const auto stream = scheduler.next(now)) {
+      open(stream.value(), now);
+    }
+  }
+
+  // Nullptr until the first connection of `stream` is ready, and while none is after a failure
+  [[nodiscard]] Client*
+  active(uint32_t stream) const {
+    auto* session = streams_[stream].active;
+    return session != nullptr ? &session->client : nullptr;
+  }
+
+  [[nodiscard]] size_t
+  streams() const {
+    return streams_.size();
+  }
+
+  // Streams with an active connection
+  [[nodiscard]] size_t
+  streams_up() const {
+    return streams_up_;
+  }
+
+  [[nodiscard]] const Stats&
+  stats() const {
+    return stats_;
+  }
+
+  [[nodiscard]] const tcp::ConnectScheduler&
+  connect_scheduler() const {
+    return scheduler;
+  }
+
+private:
+  static constexpr std::chrono::milliseconds kCheckInterval{10};
+
+  struct Stream {
+    Client::Config ws;
+    std::vector<std::string> subscriptions;
+    std::optional<Port> src_port;
+    // In the order they were opened
+    std::vector<Session*> sessions;
+    Session* active{nullptr};
+    // Failed attempts since a connection of the stream was last ready, they delay the next one
+    uint32_t failures{0};
+  };
+
+  void
+  open(uint32_t stream, time_point now);
+
+  // Moves `session` through the handshake stages it completed
+  void
+  advance(Session& session, time_point now);
+
+  // Sends the subscriptions, a stream without an active connection gets this one
+  void
+  on_ready(Session& session);
+
+  void
+  fail(Session& session, std::string_view reason);
+
+  // The oldest ready connection of `stream` becomes the active one
+  bool
+  activate_standby(Stream& stream);
+
+  void
+  check(time_point now);
+
+  void
+  remove_failed();
+
+  Config config;
+  Connection connection;
+  uint16_t queue;
+  tcp::PortAllocator& ports;
+  Connections& connections;
+  TcpFactory make_tcp;
+  tcp::ConnectScheduler scheduler;
+
+  std::vector<Stream> streams_;
+  std::vector<Session*> sessions;
+  size_t streams_up_{0};
+  bool has_failed{false};
+  time_point next_check{};
+  // When the first attempt started, for the time it took all streams to come up
+  std::optional<time_point> first_attempt;
+  // The time to bring all streams up is logged once, not again when they recover from an outage
+  bool all_up_logged{false};
+  Stats stats_;
+};
+
+} // namespace idk::net::wss
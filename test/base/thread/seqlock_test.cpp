@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include "base/thread/seqlock.h"
+
+using namespace idk::base;
+
+TEST(SeqLockTest, StoreLoad) {
+  SeqLock<std::array<uint64_t, 4>> lock;
+  EXPECT_EQ(lock.load(), (std::array<uint64_t, 4>{}));
+  lock.store({1, 2, 3, 4});
+  EXPECT_EQ(lock.load(), (std::array<uint64_t, 4>{1, 2, 3, 4}));
+}
+
+TEST(SeqLockTest, ReaderNeverSeesTornValue) {
+  using Value = std::array<uint64_t, 16>;
+  SeqLock<Value> lock;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    Value value{};
+    for (uint64_t i = 1; i <= 200'000; ++i) {
+      value.fill(i);
+      lock.store(value);
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  bool torn = false;
+  bool backwards = false;
+  while (!done) {
+    const auto value = lock.load();
+    for (const auto field: value) {
+      torn |= field != value[0];
+    }
+    backwards |= value[0] < last;
+    last = value[0];
+  }
+  writer.join();
+  EXPECT_FALSE(torn);
+  EXPECT_FALSE(backwards);
+  EXPECT_EQ(lock.load()[0], 200'000);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/timer/timer_wheel.h"
+
+using namespace idk::base;
+
+namespace {
+
+RdtscClock::time_point
+at(uint64_t ticks) {
+  return RdtscClock::time_point(RdtscDuration(ticks));
+}
+
+struct Counter {
+  void
+  on_timer() {
+    fired.push_back(wheel->now().time_since_epoch().count());
+  }
+
+  TimerWheel* wheel;
+  std::vector<uint64_t> fired;
+};
+
+} // namespace
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+  // One wheel tick is 10 raw ticks, the virtual clock starts at 0
+  TimerWheel wheel{RdtscDuration(10), at(0)};
+  Counter counter{.wheel = &wheel};
+  Timer timer;
+};
+
+TEST_F(TimerWheelTest, FiresAtDeadline) {
+  wheel.arm<&Counter::on_timer>(timer, at(50), &counter);
+  EXPECT_TRUE(timer.is_armed());
+  EXPECT_EQ(wheel.advance(at(49)), 0);
+  EXPECT_EQ(wheel.advance(at(50)), 1);
+  EXPECT_FALSE(timer.is_armed());
+  EXPECT_EQ(counter.fired, std::vector<uint64_t>{50});
+  EXPECT_EQ(wheel.armed(), 0);
+}
+
+TEST_F(TimerWheelTest, NeverFiresEarly) {
+  wheel.arm<&Counter::on_timer>(timer, at(51), &counter);
+  EXPECT_EQ(wheel.advance(at(59)), 0);
+  EXPECT_EQ(wheel.advance(at(60)), 1);
+}
+
+TEST_F(TimerWheelTest, PastDeadlineFiresOnNextTick) {
+  wheel.advance(at(100));
+  wheel.arm<&Counter::on_timer>(timer, at(0), &counter);
+  EXPECT_EQ(wheel.advance(at(109)), 0);
+  EXPECT_EQ(wheel.advance(at(110)), 1);
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  wheel.arm<&Counter::on_timer>(timer, at(50), &counter);
+  timer.cancel();
+  EXPECT_FALSE(timer.is_armed());
+  EXPECT_EQ(wheel.armed(), 0);
+  EXPECT_EQ(wheel.advance(at(1000)), 0);
+}
+
+TEST_F(TimerWheelTest, RearmMovesDeadline) {
+  wheel.arm<&Counter::on_timer>(timer, at(50), &counter);
+  wheel.arm<&Counter::on_timer>(timer, at(80), &counter);
+  EXPECT_EQ(wheel.armed(), 1);
+  EXPECT_EQ(wheel.advance(at(70)), 0);
+  EXPECT_EQ(wheel.advance(at(80)), 1);
+}
+
+TEST_F(TimerWheelTest, DestructorCancels) {
+  {
+    Timer scoped;
+    wheel.arm<&Counter::on_timer>(scoped, at(50), &counter);
+    EXPECT_EQ(wheel.armed(), 1);
+  }
+  EXPECT_EQ(wheel.armed(), 0);
+  EXPECT_EQ(wheel.advance(at(100)), 0);
+}
+
+TEST_F(TimerWheelTest, CascadesFromUpperLevels) {
+  // Deadlines on every level of the wheel, in ticks: 300 = level 1, 70000 = level 2, 20'000'000 = level 3
+  std::vector<uint64_t> deadlines{3, 300, 70'000, 20'000'000};
+  std::vector<Timer> timers(deadlines.size());
+  for (size_t i = 0; i < deadlines.size(); ++i) {
+    wheel.arm<&Counter::on_timer>(timers[i], at(deadlines[i] * 10), &counter);
+  }
+  wheel.advance(at(deadlines.back() * 10));
+  ASSERT_EQ(counter.fired.size(), deadlines.size());
+  for (size_t i = 0; i < deadlines.size(); ++i) {
+    EXPECT_EQ(counter.fired[i], deadlines[i] * 10);
+  }
+}
+
+TEST_F(TimerWheelTest, BeyondSpan) {
+  const uint64_t deadline = (uint64_t{1} << 33) + 5;
+  wheel.arm<&Counter::on_timer>(timer, at(deadline * 10), &counter);
+  // Empty levels are skipped, so this does not walk 2^33 ticks
+  wheel.advance(at(deadline * 10 - 10));
+  EXPECT_TRUE(timer.is_armed());
+  wheel.advance(at(deadline * 10));
+  EXPECT_EQ(counter.fired, std::vector<uint64_t>{deadline * 10});
+}
+
+TEST_F(TimerWheelTest, CallbackCancelsSibling) {
+  Timer sibling;
+  struct Canceller {
+    void
+    on_timer() {
+      sibling->cancel();
+    }
+    Timer* sibling;
+  } canceller{&sibling};
+
+  wheel.arm<&Canceller::on_timer>(timer, at(50), &canceller);
+  wheel.arm<&Counter::on_timer>(sibling, at(50), &counter);
+  wheel.advance(at(50));
+  // Either order is fine, the sibling fires at most once and is not armed after
+  EXPECT_LE(counter.fired.size(), 1);
+  EXPECT_FALSE(sibling.is_armed());
+  EXPECT_EQ(wheel.armed(), 0);
+}
+
+TEST_F(TimerWheelTest, CallbackRearms) {
+  struct Periodic {
+    void
+    on_timer() {
+      if (++count < 3) {
+        wheel->arm<&Periodic::on_timer>(*timer, wheel->now() + RdtscDuration(100), this);
+      }
+    }
+    TimerWheel* wheel;
+    Timer* timer;
+    int count{0};
+  } periodic{&wheel, &timer};
+
+  wheel.arm<&Periodic::on_timer>(timer, at(100), &periodic);
+  EXPECT_EQ(wheel.advance(at(1000)), 3);
+  EXPECT_EQ(periodic.count, 3);
+  EXPECT_FALSE(timer.is_armed());
+}
+
+TEST_F(TimerWheelTest, ArmedTimerIsNotMoved) {
+  wheel.arm<&Counter::on_timer>(timer, at(50), &counter);
+  EXPECT_THROW(Timer moved(std::move(timer)), std::runtime_error);
+  Timer target;
+  EXPECT_THROW(target = std::move(timer), std::runtime_error);
+  EXPECT_TRUE(timer.is_armed());
+
+  // Idle timers move freely
+  timer.cancel();
+  Timer moved(std::move(timer));
+  target = std::move(moved);
+  EXPECT_FALSE(target.is_armed());
+}
+
+TEST_F(TimerWheelTest, DeadlineRearmsAnOwnerElsewhere) {
+  struct Owner {
+    void
+    on_timer() {
+      fired_on = this;
+    }
+    Timer timer;
+    Owner* fired_on{nullptr};
+  };
+
+  // Rounded up to the tick, arming again at the deadline keeps it
+  auto first = std::make_unique<Owner>();
+  wheel.arm<&Owner::on_timer>(first->timer, at(45), first.get());
+  EXPECT_EQ(first->timer.deadline(), at(50));
+  auto second = std::make_unique<Owner>();
+  wheel.arm<&Owner::on_timer>(second->timer, first->timer.deadline(), second.get());
+  first.reset();
+  EXPECT_EQ(wheel.advance(at(49)), 0);
+  EXPECT_EQ(wheel.advance(at(50)), 1);
+  EXPECT_EQ(second->fired_on, second.get());
+}
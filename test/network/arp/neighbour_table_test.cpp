@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "network/arp/arp_handler.h"
+#include "network/sim/simulator.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::arp;
+
+class NeighbourTableTest : public ::testing::Test {
+protected:
+  // Ips the table asks to probe at `at`
+  std::vector<Ip>
+  expire(base::RdtscClock::time_point at) {
+    std::vector<Ip> probed;
+    table.expire(at, [&](Ip ip) { probed.push_back(ip); });
+    return probed;
+  }
+
+  // Some time after `t0`
+  static base::RdtscClock::time_point
+  at(std::chrono::milliseconds offset) {
+    return t0 + base::RdtscDuration(offset);
+  }
+
+  static inline const Ip kGateway{"10.0.0.254"};
+  static inline const Mac kGatewayMac{"02:00:00:00:00:fe"};
+  static inline const base::RdtscClock::time_point t0 = base::RdtscClock::time_point{} +
+                                                        base::RdtscDuration(std::chrono::hours(1));
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  dpdk::Sender sender = simulator.device(sim::Simulator::kClient).get_sender();
+  NeighbourTable table;
+};
+
+using namespace std::chrono_literals;
+
+TEST_F(NeighbourTableTest, Track) {
+  EXPECT_EQ(table.find(kGateway), nullptr);
+  const auto& neighbour = table.track(kGateway);
+  EXPECT_EQ(neighbour.ip, kGateway);
+  EXPECT_EQ(neighbour.state, Neighbour::State::Incomplete);
+  EXPECT_FALSE(neighbour.is_resolved());
+  EXPECT_EQ(&table.track(kGateway), &neighbour);
+  EXPECT_EQ(table.find(kGateway), &neighbour);
+
+  // Only tracked neighbours are learned
+  EXPECT_FALSE(table.learn(Ip("10.0.0.7"), kGatewayMac, at(0ms)));
+  EXPECT_EQ(table.find(Ip("10.0.0.7")), nullptr);
+  EXPECT_TRUE(table.learn(kGateway, kGatewayMac, at(0ms)));
+  EXPECT_EQ(neighbour.state, Neighbour::State::Reachable);
+  EXPECT_EQ(neighbour.mac, kGatewayMac);
+  // Resolved already
+  EXPECT_FALSE(table.learn(kGateway, kGatewayMac, at(0ms)));
+}
+
+TEST_F(NeighbourTableTest, TableIsFull) {
+  for (size_t i = 0; i < NeighbourTable::kCapacity; ++i) {
+    std::ignore = table.track(Ip("10.0.1." + std::to_string(i)));
+  }
+  EXPECT_THROW(std::ignore = table.track(kGateway), std::runtime_error);
+}
+
+TEST_F(NeighbourTableTest, SeedIsUsableAndProbedRightAway) {
+  table.seed(kGateway, kGatewayMac);
+  const auto* neighbour = table.find(kGateway);
+  ASSERT_NE(neighbour, nullptr);
+  EXPECT_EQ(neighbour->state, Neighbour::State::Stale);
+  EXPECT_TRUE(neighbour->is_resolved());
+  EXPECT_EQ(neighbour->mac, kGatewayMac);
+  EXPECT_EQ(expire(at(0ms)), (std::vector<Ip>{kGateway}));
+
+  // A seeded mac which turns out wrong is replaced, but the entry was usable already
+  const Mac actual("02:00:00:00:00:aa");
+  EXPECT_FALSE(table.learn(kGateway, actual, at(10ms)));
+  EXPECT_EQ(neighbour->state, Neighbour::State::Reachable);
+  EXPECT_EQ(neighbour->mac, actual);
+}
+
+TEST_F(NeighbourTableTest, ReachableAgesToStale) {
+  const auto& neighbour = table.track(kGateway);
+  EXPECT_EQ(expire(at(0ms)), (std::vector<Ip>{kGateway}));
+  ASSERT_TRUE(table.learn(kGateway, kGatewayMac, at(0ms)));
+  EXPECT_TRUE(expire(at(NeighbourTable::kReachableTime - 1ms)).empty());
+
+  // Stale is still usable while it is re-probed
+  EXPECT_EQ(expire(at(NeighbourTable::kReachableTime)), (std::vector<Ip>{kGateway}));
+  EXPECT_EQ(neighbour.state, Neighbour::State::Stale);
+  EXPECT_TRUE(neighbour.is_resolved());
+
+  // The reply confirms it again
+  EXPECT_FALSE(table.learn(kGateway, kGatewayMac, at(NeighbourTable::kReachableTime + 1ms)));
+  EXPECT_EQ(neighbour.state, Neighbour::State::Reachable);
+  EXPECT_TRUE(expire(at(NeighbourTable::kReachableTime + NeighbourTable::kProbeInterval)).empty());
+}
+
+TEST_F(NeighbourTableTest, ProbesAreSpacedAndLimited) {
+  const auto& neighbour = table.track(kGateway);
+  EXPECT_EQ(expire(at(0ms)), (std::vector<Ip>{kGateway}));
+  EXPECT_TRUE(expire(at(NeighbourTable::kProbeInterval - 1ms)).empty());
+  EXPECT_EQ(expire(at(NeighbourTable::kProbeInterval)), (std::vector<Ip>{kGateway}));
+  EXPECT_EQ(expire(at(2 * NeighbourTable::kProbeInterval)), (std::vector<Ip>{kGateway}));
+  EXPECT_EQ(neighbour.probes, NeighbourTable::kMaxProbes);
+
+  // Held packets are dropped once the probes are exhausted, the resolution starts over
+  table.hold(neighbour, sender.get_send_buffer(), 60);
+  EXPECT_EQ(expire(at(3 * NeighbourTable::kProbeInterval)), (std::vector<Ip>{kGateway}));
+  EXPECT_EQ(table.pending_size(), 0);
+  EXPECT_EQ(neighbour.state, Neighbour::State::Incomplete);
+  EXPECT_EQ(neighbour.probes, 1);
+}
+
+TEST_F(NeighbourTableTest, StaleWithoutRepliesIsIncomplete) {
+  table.seed(kGateway, kGatewayMac);
+  for (size_t i = 0; i < NeighbourTable::kMaxProbes; ++i) {
+    EXPECT_EQ(expire(at(i * NeighbourTable::kProbeInterval)).size(), 1);
+  }
+  EXPECT_TRUE(table.find(kGateway)->is_resolved());
+  EXPECT_EQ(expire(at(NeighbourTable::kMaxProbes * NeighbourTable::kProbeInterval)).size(), 1);
+  EXPECT_EQ(table.find(kGateway)->state, Neighbour::State::Incomplete);
+  EXPECT_FALSE(table.find(kGateway)->is_resolved());
+}
+
+TEST_F(NeighbourTableTest, HoldAndRelease) {
+  const auto& gateway = table.track(kGateway);
+  const auto& other = table.track(Ip("10.0.0.7"));
+  table.hold(gateway, sender.get_send_buffer(), 60);
+  table.hold(other, sender.get_send_buffer(), 70);
+  table.hold(gateway, sender.get_send_buffer(), 80);
+  EXPECT_EQ(table.pending_size(), 3);
+
+  std::vector<size_t> released;
+  table.release_pending(gateway, [&](dpdk::TxPacket, size_t size) { released.push_back(size); });
+  EXPECT_EQ(released, (std::vector<size_t>{60, 80}));
+  EXPECT_EQ(table.pending_size(), 1);
+}
+
+TEST_F(NeighbourTableTest, PendingQueueIsBounded) {
+  const auto& neighbour = table.track(kGateway);
+  for (size_t i = 0; i < NeighbourTable::kMaxPendingPackets + 1; ++i) {
+    table.hold(neighbour, sender.get_send_buffer(), 60);
+  }
+  EXPECT_EQ(table.pending_size(), NeighbourTable::kMaxPendingPackets);
+}
+
+// The handler resolves through the simulator, the server side plays the gateway
+class ArpHandlerTest : public ::testing::Test {
+protected:
+  // ARP packets the handler sent
+  std::vector<Header>
+  requests() {
+    simulator.step(simulator.now());
+    std::vector<Header> headers;
+    auto burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      const auto bytes = burst.bytes(i);
+      std::vector<uint8_t> frame(bytes.begin(), bytes.end());
+      PacketView packet(base::MutableByteView{frame.data(), frame.size()});
+      EXPECT_TRUE(packet.is_valid());
+      EXPECT_EQ(packet.eth().header().dst_mac, Mac("ff:ff:ff:ff:ff:ff"));
+      headers.push_back(packet.header());
+    }
+    return headers;
+  }
+
+  // Frames other than ARP the gateway received
+  std::vector<std::vector<uint8_t>>
+  forwarded() {
+    simulator.step(simulator.now());
+    std::vector<std::vector<uint8_t>> frames;
+    auto burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      const auto bytes = burst.bytes(i);
+      frames.emplace_back(bytes.begin(), bytes.end());
+    }
+    return frames;
+  }
+
+  // The gateway answers a request of the handler
+  void
+  reply() {
+    std::vector<uint8_t> frame(PacketView::predict_size());
+    PacketView packet(base::MutableByteView{frame.data(), frame.size()});
+    packet.init_reply(kGatewayMac, kGateway, kLocalHost.mac, kLocalHost.ip);
+    handler.handle_packet({frame.data(), frame.size()});
+  }
+
+  // Holds a frame to the gateway carrying `tag`, the destination mac is filled in on resolution
+  void
+  hold(uint8_t tag) {
+    auto packet = sender.get_send_buffer();
+    EthernetPacketView eth(packet.view());
+    eth.init(Mac(), kLocalHost.mac, EthernetType::Ipv4);
+    eth.payload()[0] = tag;
+    const auto& neighbour = handler.neighbours().track(kGateway);
+    handler.neighbours().hold(neighbour, std::move(packet), 60);
+  }
+
+  // Moves the clock by `duration` and polls the handler
+  void
+  advance(std::chrono::milliseconds duration) {
+    simulator.step(simulator.now() + base::RdtscDuration(duration));
+    handler.poll();
+  }
+
+  static inline const Host kLocalHost{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+  static inline const Ip kGateway{"10.0.0.254"};
+  static inline const Mac kGatewayMac{"02:00:00:00:00:fe"};
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  dpdk::Sender sender = simulator.device(sim::Simulator::kClient).get_sender();
+  ArpHandler handler{kLocalHost, sender};
+};
+
+TEST_F(ArpHandlerTest, HeldPacketsAreFlushedOnResolution) {
+  hold(1);
+  hold(2);
+  handler.poll();
+  auto sent = requests();
+  ASSERT_EQ(sent.size(), 1);
+  EXPECT_EQ(sent[0].operation, Operation::Request);
+  EXPECT_EQ(sent[0].sender_ip, kLocalHost.ip);
+  EXPECT_EQ(sent[0].target_ip, kGateway);
+
+  reply();
+  EXPECT_TRUE(handler.neighbours().find(kGateway)->is_resolved());
+  EXPECT_EQ(handler.neighbours().pending_size(), 0);
+  sender.flush();
+  auto frames = forwarded();
+  ASSERT_EQ(frames.size(), 2);
+  for (uint8_t tag = 1; auto& frame: frames) {
+    EthernetPacketView eth(base::MutableByteView{frame.data(), frame.size()});
+    EXPECT_EQ(eth.header().dst_mac, kGatewayMac);
+    EXPECT_EQ(eth.payload()[0], tag++);
+  }
+
+  // A second reply changes nothing
+  reply();
+  sender.flush();
+  EXPECT_TRUE(forwarded().empty());
+}
+
+TEST_F(ArpHandlerTest, AnnounceIsGratuitous) {
+  handler.announce();
+  auto sent = requests();
+  ASSERT_EQ(sent.size(), 1);
+  EXPECT_EQ(sent[0].sender_ip, kLocalHost.ip);
+  EXPECT_EQ(sent[0].target_ip, kLocalHost.ip);
+  EXPECT_EQ(sent[0].sender_mac, kLocalHost.mac);
+}
+
+TEST_F(ArpHandlerTest, PollIsRateLimited) {
+  std::ignore = handler.neighbours().track(kGateway);
+  handler.poll();
+  EXPECT_EQ(requests().size(), 1);
+  // Neither the poll interval nor the probe interval passed
+  handler.poll();
+  EXPECT_TRUE(requests().empty());
+}
+
+TEST_F(ArpHandlerTest, AgedNeighbourIsRequestedAgain) {
+#ifndef IDK_SIMULATED_CLOCK
+  GTEST_SKIP() << "Needs the simulated clock";
+#else
+  std::ignore = handler.neighbours().track(kGateway);
+  handler.poll();
+  ASSERT_EQ(requests().size(), 1);
+  reply();
+
+  advance(NeighbourTable::kReachableTime - 1s);
+  EXPECT_TRUE(requests().empty());
+  // Past the reachable time, whatever the rounding of the tick conversions
+  advance(2s);
+  auto sent = requests();
+  ASSERT_EQ(sent.size(), 1);
+  EXPECT_EQ(sent[0].target_ip, kGateway);
+  EXPECT_EQ(handler.neighbours().find(kGateway)->state, Neighbour::State::Stale);
+
+  // Unanswered, the probes repeat every probe interval
+  advance(NeighbourTable::kProbeInterval);
+  EXPECT_EQ(requests().size(), 1);
+  reply();
+  EXPECT_EQ(handler.neighbours().find(kGateway)->state, Neighbour::State::Reachable);
+  advance(NeighbourTable::kProbeInterval);
+  EXPECT_TRUE(requests().empty());
+#endif
+}
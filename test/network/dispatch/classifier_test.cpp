@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "network/dispatch/classifier.h"
+
+using namespace idk::net::dispatch;
+
+class ClassifierTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  using Frame = std::array<uint8_t, 64>;
+
+  static Frame
+  make_ipv4(uint8_t protocol, uint16_t src_port, uint16_t dst_port, uint32_t src_ip = 0x0a000001,
+            uint32_t dst_ip = 0x0a000002) {
+    Frame frame{};
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+    frame[14] = 0x45;
+    frame[23] = protocol;
+    put_be32(frame, 26, src_ip);
+    put_be32(frame, 30, dst_ip);
+    frame[34] = src_port >> 8;
+    frame[35] = src_port & 0xff;
+    frame[36] = dst_port >> 8;
+    frame[37] = dst_port & 0xff;
+    return frame;
+  }
+
+  static Frame
+  make_arp() {
+    Frame frame{};
+    frame[12] = 0x08;
+    frame[13] = 0x06;
+    return frame;
+  }
+
+  static void
+  put_be32(Frame& frame, size_t offset, uint32_t value) {
+    frame[offset] = value >> 24;
+    frame[offset + 1] = (value >> 16) & 0xff;
+    frame[offset + 2] = (value >> 8) & 0xff;
+    frame[offset + 3] = value & 0xff;
+  }
+
+  static uint32_t
+  load32(const Frame& frame, size_t offset) {
+    uint32_t value;
+    std::memcpy(&value, frame.data() + offset, sizeof(value));
+    return value;
+  }
+
+  Classification
+  classify_frames(const std::vector<Frame>& frames) {
+    std::vector<const uint8_t*> packets;
+    for (const auto& frame: frames) {
+      packets.push_back(frame.data());
+    }
+    Classification out;
+    classify(packets, out);
+    return out;
+  }
+};
+
+TEST_F(ClassifierTest, Classes) {
+  auto fragment = make_ipv4(6, 443, 50000);
+  fragment[20] = 0x20; // more fragments
+  auto with_options = make_ipv4(6, 443, 50000);
+  with_options[14] = 0x46;
+  auto ipv6 = make_ipv4(6, 443, 50000);
+  ipv6[12] = 0x86;
+  ipv6[13] = 0xdd;
+  auto dont_fragment = make_ipv4(17, 1234, 5678);
+  dont_fragment[20] = 0x40;
+
+  const auto out = classify_frames(
+      {make_arp(), make_ipv4(6, 443, 50000), make_ipv4(17, 1234, 5678), make_ipv4(1, 0, 0), fragment, with_options,
+       ipv6, dont_fragment, make_arp()});
+
+  ASSERT_EQ(out.size, 9);
+  EXPECT_EQ(out.classes[0], PacketClass::Arp);
+  EXPECT_EQ(out.classes[1], PacketClass::Tcp);
+  EXPECT_EQ(out.classes[2], PacketClass::Udp);
+  EXPECT_EQ(out.classes[3], PacketClass::Drop);
+  EXPECT_EQ(out.classes[4], PacketClass::Drop);
+  EXPECT_EQ(out.classes[5], PacketClass::Drop);
+  EXPECT_EQ(out.classes[6], PacketClass::Drop);
+  EXPECT_EQ(out.classes[7], PacketClass::Udp);
+  EXPECT_EQ(out.classes[8], PacketClass::Arp);
+}
+
+TEST_F(ClassifierTest, FieldsMatchScalar) {
+  std::vector<Frame> frames;
+  for (uint16_t i = 0; i < 32; ++i) {
+    frames.push_back(make_ipv4(i % 2 ? 6 : 17, 1000 + i, 50000 - i * 7, 0xc0a80100 + i, 0x0d71fd0b - i * 3));
+  }
+  const auto out = classify_frames(frames);
+
+  ASSERT_EQ(out.size, frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const uint32_t src_ip = load32(frames[i], 26);
+    const uint32_t dst_ip = load32(frames[i], 30);
+    const uint32_t ports = load32(frames[i], 34);
+    EXPECT_EQ(out.src_ip[i], src_ip) << i;
+    EXPECT_EQ(out.dst_ip[i], dst_ip) << i;
+    EXPECT_EQ(out.ports[i], ports) << i;
+    EXPECT_EQ(out.dst_port[i], 50000 - i * 7) << i;
+    EXPECT_EQ(out.flow_hash[i], flow_hash(src_ip, dst_ip, ports)) << i;
+  }
+}
+
+TEST_F(ClassifierTest, Empty) {
+  const auto out = classify_frames({});
+  EXPECT_EQ(out.size, 0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "network/dispatch/flow_table.h"
+
+using namespace idk::net::dispatch;
+
+class FlowTableTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static FlowKey
+  key(uint32_t i) {
+    return {.src_ip = 0x0100000a + (i << 24), .dst_ip = 0x0200000a, .ports = 0xbb01 | (i << 16)};
+  }
+
+  FlowTable table{64};
+};
+
+TEST_F(FlowTableTest, InsertFind) {
+  for (uint32_t i = 0; i < 32; ++i) {
+    EXPECT_TRUE(table.insert(key(i), i));
+  }
+  EXPECT_EQ(table.size(), 32);
+  for (uint32_t i = 0; i < 32; ++i) {
+    EXPECT_EQ(table.find(key(i)), i);
+  }
+  EXPECT_EQ(table.find(key(100)), FlowTable::kNotFound);
+}
+
+TEST_F(FlowTableTest, DuplicateKey) {
+  EXPECT_TRUE(table.insert(key(1), 1));
+  EXPECT_FALSE(table.insert(key(1), 2));
+  EXPECT_EQ(table.find(key(1)), 1);
+}
+
+TEST_F(FlowTableTest, KeysDifferInOneField) {
+  auto a = key(1);
+  auto b = a;
+  b.ports ^= 1;
+  EXPECT_FALSE(a == b);
+  table.insert(a, 1);
+  EXPECT_EQ(table.find(b), FlowTable::kNotFound);
+}
+
+TEST_F(FlowTableTest, EraseKeepsProbeChain) {
+  // Erasing must not cut the probe chains of the other keys
+  for (uint32_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(table.insert(key(i), i));
+  }
+  EXPECT_TRUE(table.erase(key(3)));
+  EXPECT_FALSE(table.erase(key(3)));
+  EXPECT_EQ(table.find(key(3)), FlowTable::kNotFound);
+  for (uint32_t i = 0; i < 8; ++i) {
+    if (i != 3) {
+      EXPECT_EQ(table.find(key(i)), i);
+    }
+  }
+}
+
+TEST_F(FlowTableTest, ChurnDoesNotFill) {
+  for (uint32_t round = 0; round < 1000; ++round) {
+    ASSERT_TRUE(table.insert(key(round), round));
+    ASSERT_TRUE(table.erase(key(round)));
+  }
+  EXPECT_EQ(table.size(), 0);
+}
+
+TEST_F(FlowTableTest, Full) {
+  for (uint32_t i = 0; i < 32; ++i) {
+    table.insert(key(i), i);
+  }
+  EXPECT_ANY_THROW(table.insert(key(33), 33));
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "network/dpdk/rss.h"
+#include "network/tcp/port_allocator.h"
+
+using namespace idk::net;
+
+namespace {
+
+dpdk::Rss
+two_queues() {
+  return {{dpdk::Rss::kDefaultKey.begin(), dpdk::Rss::kDefaultKey.end()}, dpdk::Rss::spread(128, 2)};
+}
+
+} // namespace
+
+// Verification suite of the Microsoft RSS specification, ipv4 with tcp ports
+TEST(RssTest, ToeplitzVerificationSuite) {
+  const dpdk::Rss rss({dpdk::Rss::kDefaultKey.begin(), dpdk::Rss::kDefaultKey.end()}, {});
+  EXPECT_EQ(rss.hash(Ip("66.9.149.187"), Ip("161.142.100.80"), Port(2794), Port(1766)), 0x51ccc178);
+  EXPECT_EQ(rss.hash(Ip("199.92.111.2"), Ip("65.69.140.83"), Port(14230), Port(4739)), 0xc626b0ea);
+  EXPECT_EQ(rss.hash(Ip("24.19.198.95"), Ip("12.22.207.184"), Port(12898), Port(38024)), 0x5c2b394a);
+}
+
+TEST(RssTest, PortsLandOnTheChosenQueue) {
+  tcp::PortAllocator ports(two_queues());
+  const Ip local("10.0.0.1");
+  const Endpoint remote{.ip = Ip("13.113.253.11"), .port = Port(443)};
+  for (uint16_t queue: {0, 1, 1, 0}) {
+    const auto port = ports.allocate(local, remote, queue);
+    ASSERT_TRUE(port.has_value());
+    EXPECT_GE(port->value(), tcp::PortAllocator::kFirstPort);
+    EXPECT_EQ(ports.rss_model().reply_queue(Connection{.session = {.src = {.ip = local}, .dst = {.ip = remote.ip}},
+                                                       .src_port = *port,
+                                                       .dst_port = remote.port}),
+              queue);
+  }
+  // No such queue
+  EXPECT_FALSE(ports.allocate(local, remote, 2).has_value());
+
+  const Port configured(50000);
+  EXPECT_LT(ports.reserve(local, remote, configured), 2);
+  EXPECT_THROW(ports.reserve(local, remote, configured), std::exception);
+  ports.release(configured);
+  EXPECT_NO_THROW(ports.reserve(local, remote, configured));
+}
+
+// Every worker of a wider port finds a source port whose replies come to its queue
+TEST(RssTest, SpreadCoversEveryQueue) {
+  const auto reta = dpdk::Rss::spread(512, 4);
+  for (uint16_t queue = 0; queue < 4; ++queue) {
+    EXPECT_EQ(std::ranges::count(reta, queue), 128);
+  }
+  tcp::PortAllocator ports(dpdk::Rss({dpdk::Rss::kDefaultKey.begin(), dpdk::Rss::kDefaultKey.end()}, reta));
+  const Endpoint remote{.ip = Ip("13.113.253.11"), .port = Port(443)};
+  for (uint16_t queue = 0; queue < 4; ++queue) {
+    EXPECT_TRUE(ports.allocate(Ip("10.0.0.1"), remote, queue).has_value());
+  }
+}
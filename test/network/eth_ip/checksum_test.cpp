@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "network/eth_ip/checksum.h"
+
+using namespace idk::net;
+
+class ChecksumTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  // Straightforward RFC 1071 over big endian words
+  static uint16_t
+  reference(const std::vector<uint8_t>& data) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < data.size(); i += 2) {
+      sum += data[i] << 8 | (i + 1 < data.size() ? data[i + 1] : 0);
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(sum);
+  }
+
+  static uint16_t
+  to_big_endian(uint16_t folded) {
+    return static_cast<uint16_t>(folded << 8 | folded >> 8);
+  }
+};
+
+TEST_F(ChecksumTest, Ipv4Header) {
+  const std::vector<uint8_t> header = {0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+                                       0xb8, 0x61, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7};
+  EXPECT_TRUE(is_checksum_valid(checksum_add(header)));
+
+  auto corrupted = header;
+  corrupted[15] ^= 0x01;
+  EXPECT_FALSE(is_checksum_valid(checksum_add(corrupted)));
+}
+
+TEST_F(ChecksumTest, MatchesReference) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (size_t size = 0; size < 300; ++size) {
+    std::vector<uint8_t> data(size);
+    for (auto& el: data) {
+      el = byte(gen);
+    }
+    EXPECT_EQ(to_big_endian(checksum_fold(checksum_add(data))), reference(data)) << size;
+  }
+}
+
+TEST_F(ChecksumTest, AllOnes) {
+  // Stresses the carries of the vector accumulators
+  std::vector<uint8_t> data(9000, 0xff);
+  EXPECT_EQ(to_big_endian(checksum_fold(checksum_add(data))), reference(data));
+}
+
+TEST_F(ChecksumTest, Chained) {
+  std::vector<uint8_t> data(100);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  const auto sum = checksum_add({data.data() + 40, 60}, checksum_add({data.data(), 40}));
+  EXPECT_EQ(checksum_fold(sum), checksum_fold(checksum_add(data)));
+}
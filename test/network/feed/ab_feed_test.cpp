@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "network/feed/ab_feed.h"
+#include "network/sim/simulator.h"
+#include "network/udp/multicast.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::feed;
+
+// Line A is the client device of the simulator and line B the server one, each gets what the other end sends. The
+// ports differ, so the copies are timed by the poll cycle which returned them.
+class AbFeedTest : public ::testing::Test {
+protected:
+  static inline const Ip kGroup{"239.1.2.3"};
+  static constexpr uint16_t kPort = 5000;
+
+  // A datagram of the feed with sequence number `seq` on `line`
+  void
+  send(Line line, uint64_t seq) {
+    auto sender = simulator.device(line == Line::A ? sim::Simulator::kServer : sim::Simulator::kClient).get_sender();
+    auto tx = sender.get_send_buffer();
+    udp::PacketView datagram(tx.view());
+    datagram.init(Connection{.session = {.src = {.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")},
+                                         .dst = {.mac = udp::MulticastMembership::group_mac(kGroup), .ip = kGroup}},
+                             .src_port = Port(40000),
+                             .dst_port = Port(kPort)});
+    datagram.resize_payload(sizeof(seq));
+    std::memcpy(datagram.payload().data(), &seq, sizeof(seq));
+    datagram.update_checksum();
+    datagram.ip().update_checksum();
+    sender.send_raw(std::move(tx), udp::PacketView::predict_size(sizeof(seq)));
+  }
+
+  // Lines of the datagrams forwarded by one poll
+  std::vector<Line>
+  poll() {
+    simulator.step(simulator.now());
+    std::vector<Line> forwarded;
+    feed.poll(
+        [](base::ByteView payload) -> std::optional<uint64_t> {
+          uint64_t seq;
+          if (payload.size() != sizeof(seq)) {
+            return std::nullopt;
+          }
+          std::memcpy(&seq, payload.data(), sizeof(seq));
+          return seq;
+        },
+        [&](const udp::PacketView&, Line line) { forwarded.push_back(line); });
+    return forwarded;
+  }
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  AbFeed feed{{.device = &simulator.device(sim::Simulator::kClient), .group = kGroup, .port = Port(kPort)},
+              {.device = &simulator.device(sim::Simulator::kServer), .group = kGroup, .port = Port(kPort)}};
+};
+
+TEST_F(AbFeedTest, LinesTakeTurnsAtBeingPolledFirst) {
+  for (uint64_t seq = 1; seq <= 4; ++seq) {
+    send(Line::A, seq);
+    send(Line::B, seq);
+    EXPECT_EQ(poll(), std::vector<Line>{seq % 2 == 1 ? Line::A : Line::B});
+  }
+  // Both copies came with the same poll, no line was faster
+  const auto& stats = feed.stats();
+  EXPECT_EQ(stats.forwarded, 4);
+  EXPECT_EQ(stats.ties, 4);
+  EXPECT_EQ(stats.a.wins, 0);
+  EXPECT_EQ(stats.b.wins, 0);
+}
+
+TEST_F(AbFeedTest, CopyOfALaterPollLoses) {
+  send(Line::B, 1);
+  EXPECT_EQ(poll(), std::vector<Line>{Line::B});
+  send(Line::A, 1);
+  EXPECT_TRUE(poll().empty());
+
+  const auto& stats = feed.stats();
+  EXPECT_EQ(stats.ties, 0);
+  EXPECT_EQ(stats.b.wins, 1);
+  EXPECT_GT(stats.b.win_margin_ns, 0);
+  EXPECT_EQ(stats.a.wins, 0);
+}
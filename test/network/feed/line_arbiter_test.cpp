@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "network/feed/line_arbiter.h"
+
+using namespace idk::net::feed;
+
+class LineArbiterTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static LineArbiter::time_point
+  at(int64_t ns) {
+    return LineArbiter::time_point{std::chrono::nanoseconds(ns)};
+  }
+
+  LineArbiter arbiter;
+};
+
+TEST_F(LineArbiterTest, FirstCopyWins) {
+  EXPECT_EQ(arbiter.on_message(Line::A, 1, at(100)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 1, at(130)), LineArbiter::Verdict::Duplicate);
+  EXPECT_EQ(arbiter.on_message(Line::B, 2, at(200)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::A, 2, at(210)), LineArbiter::Verdict::Duplicate);
+  EXPECT_EQ(arbiter.on_message(Line::A, 3, at(300)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 3, at(350)), LineArbiter::Verdict::Duplicate);
+
+  const auto& stats = arbiter.stats();
+  EXPECT_EQ(stats.forwarded, 3);
+  EXPECT_EQ(stats.duplicates, 3);
+  EXPECT_EQ(stats.a.wins, 2);
+  EXPECT_EQ(stats.a.win_margin_ns, 80);
+  EXPECT_EQ(stats.a.max_win_margin_ns, 50);
+  EXPECT_EQ(stats.b.wins, 1);
+  EXPECT_EQ(stats.b.win_margin_ns, 10);
+  EXPECT_EQ(stats.lost, 0);
+}
+
+TEST_F(LineArbiterTest, GapFilledByOtherLine) {
+  EXPECT_EQ(arbiter.on_message(Line::A, 10, at(0)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::A, 13, at(1)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 10, at(2)), LineArbiter::Verdict::Duplicate);
+  EXPECT_EQ(arbiter.on_message(Line::B, 11, at(3)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 12, at(4)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 13, at(5)), LineArbiter::Verdict::Duplicate);
+
+  const auto& stats = arbiter.stats();
+  EXPECT_EQ(stats.a.gaps, 1);
+  EXPECT_EQ(stats.a.gap_messages, 2);
+  EXPECT_EQ(stats.b.gaps, 0);
+  EXPECT_EQ(stats.forwarded, 4);
+  EXPECT_EQ(stats.lost, 0);
+}
+
+TEST_F(LineArbiterTest, LostOnBothLines) {
+  arbiter.on_message(Line::A, 1, at(0));
+  arbiter.on_message(Line::B, 1, at(0));
+  arbiter.on_message(Line::A, 3, at(0));
+  arbiter.on_message(Line::B, 3, at(0));
+  EXPECT_EQ(arbiter.stats().lost, 0);
+
+  // Message 2 leaves the window without being seen on any line
+  arbiter.on_message(Line::A, 2 + LineArbiter::kWindow, at(0));
+  EXPECT_EQ(arbiter.stats().lost, 1);
+  EXPECT_EQ(arbiter.on_message(Line::B, 2, at(0)), LineArbiter::Verdict::Stale);
+  EXPECT_EQ(arbiter.stats().stale, 1);
+}
+
+TEST_F(LineArbiterTest, SameArrivalIsATie) {
+  EXPECT_EQ(arbiter.on_message(Line::A, 1, at(100)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 1, at(100)), LineArbiter::Verdict::Duplicate);
+
+  const auto& stats = arbiter.stats();
+  EXPECT_EQ(stats.ties, 1);
+  EXPECT_EQ(stats.duplicates, 1);
+  EXPECT_EQ(stats.a.wins, 0);
+  EXPECT_EQ(stats.b.wins, 0);
+}
+
+TEST_F(LineArbiterTest, StampedEarlierCopyWinsWhenSeenSecond) {
+  // Line A was polled first, but the NIC stamped the copy of line B earlier
+  EXPECT_EQ(arbiter.on_message(Line::A, 1, at(150)), LineArbiter::Verdict::Forward);
+  EXPECT_EQ(arbiter.on_message(Line::B, 1, at(100)), LineArbiter::Verdict::Duplicate);
+
+  const auto& stats = arbiter.stats();
+  EXPECT_EQ(stats.a.wins, 0);
+  EXPECT_EQ(stats.b.wins, 1);
+  EXPECT_EQ(stats.b.win_margin_ns, 50);
+  EXPECT_EQ(stats.b.max_win_margin_ns, 50);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "network/eth_ip/ethernet.h"
+#include "network/sim/link.h"
+
+using namespace idk;
+using namespace idk::net::sim;
+using namespace std::chrono_literals;
+
+class LinkTest : public ::testing::Test {
+protected:
+  using time_point = Link::time_point;
+
+  static time_point
+  at(std::chrono::nanoseconds offset) {
+    return time_point{} + base::RdtscDuration(offset);
+  }
+
+  // Frame of `size` bytes tagged with `id` in the first byte
+  static std::vector<uint8_t>
+  frame(uint8_t id, size_t size = 100) {
+    std::vector<uint8_t> bytes(size);
+    bytes[0] = id;
+    return bytes;
+  }
+
+  static std::vector<uint8_t>
+  drain(Link& link, time_point now) {
+    std::vector<uint8_t> ids;
+    link.deliver(now, [&](base::ByteView bytes) { ids.push_back(bytes[0]); });
+    return ids;
+  }
+};
+
+TEST_F(LinkTest, LatencyAndOrder) {
+  Link link(LinkConfig{.latency = 100us});
+  for (uint8_t id = 0; id < 3; ++id) {
+    link.send(frame(id), at(0us));
+  }
+  EXPECT_TRUE(drain(link, at(99us)).empty());
+  EXPECT_EQ(drain(link, at(100us)), (std::vector<uint8_t>{0, 1, 2}));
+  EXPECT_FALSE(link.next_delivery().has_value());
+}
+
+TEST_F(LinkTest, Bandwidth) {
+  // 1000 bytes take 8us at 1 Gbit/s
+  Link link(LinkConfig{.latency = 0us, .bandwidth_bps = 1'000'000'000});
+  link.send(frame(0, 1000), at(0us));
+  link.send(frame(1, 1000), at(0us));
+  EXPECT_EQ(drain(link, at(8us)), (std::vector<uint8_t>{0}));
+  EXPECT_EQ(drain(link, at(16us)), (std::vector<uint8_t>{1}));
+}
+
+TEST_F(LinkTest, MtuLossAndDuplicates) {
+  Link oversize(LinkConfig{.mtu = 1500});
+  oversize.send(frame(0, sizeof(net::EthernetHeader) + 1501), at(0us));
+  EXPECT_EQ(oversize.stats().oversize, 1);
+  EXPECT_FALSE(oversize.next_delivery().has_value());
+
+  Link lossy(LinkConfig{.loss = 1});
+  lossy.send(frame(0), at(0us));
+  EXPECT_EQ(lossy.stats().lost, 1);
+  EXPECT_FALSE(lossy.next_delivery().has_value());
+
+  Link duplicating(LinkConfig{.duplicate = 1});
+  duplicating.send(frame(7), at(0us));
+  EXPECT_EQ(drain(duplicating, at(1s)), (std::vector<uint8_t>{7, 7}));
+}
+
+TEST_F(LinkTest, Reorder) {
+  Link link(LinkConfig{.latency = 10us, .reorder = 1, .reorder_delay = 50us});
+  link.send(frame(0), at(0us));
+  link.send(frame(1), at(20us));
+  EXPECT_EQ(drain(link, at(1s)), (std::vector<uint8_t>{0, 1}));
+
+  // Held back by the reorder delay on top of the latency
+  link.send(frame(2), at(0us));
+  EXPECT_GT(link.next_delivery(), at(59us));
+  EXPECT_LT(link.next_delivery(), at(61us));
+
+  // Frames sent in order after a reordered one overtake it
+  Link mixed(LinkConfig{.latency = 10us, .reorder = 0.5, .reorder_delay = 50us, .seed = 7});
+  for (uint8_t id = 0; id < 20; ++id) {
+    mixed.send(frame(id), at(std::chrono::microseconds(id)));
+  }
+  const auto ids = drain(mixed, at(1s));
+  EXPECT_EQ(ids.size(), 20);
+  EXPECT_FALSE(std::ranges::is_sorted(ids));
+  EXPECT_GT(mixed.stats().reordered, 0);
+}
+
+TEST_F(LinkTest, SameSeedSameRun) {
+  const LinkConfig config{.jitter = 30us, .loss = 0.2, .duplicate = 0.1, .reorder = 0.1, .seed = 42};
+  const auto run = [&] {
+    Link link(config);
+    for (uint8_t id = 0; id < 200; ++id) {
+      link.send(frame(id), at(std::chrono::microseconds(id)));
+    }
+    return drain(link, at(1s));
+  };
+  const auto first = run();
+  EXPECT_EQ(first, run());
+  EXPECT_LT(first.size(), 200 * 1.1);
+  EXPECT_GT(first.size(), 100);
+}
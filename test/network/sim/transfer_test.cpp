@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "../tcp_client/tcp_pair.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+// A bulk transfer from the client to the server over impaired links. The byte stream has to arrive intact and in
+// order whatever the links do, the counters of both ends show how it got there.
+class TransferTest : public ::testing::Test {
+protected:
+  static constexpr size_t kTransferBytes = 256 << 10;
+  static constexpr size_t kChunkBytes = 16 << 10;
+
+  // Runs the transfer, false if it did not complete in `limit`
+  bool
+  transfer(const sim::LinkConfig& link, size_t bytes = kTransferBytes, std::chrono::seconds limit = 30s) {
+    pair.emplace(sim::Simulator::Config{.to_server = link, .to_client = link});
+    // The server appears with the first ACK it receives, which may be lost: only the client is waited for
+    pair->client.connect();
+    if (!pair->run_until([&] { return pair->client.get_state() == Client::State::Connected; }, limit)) {
+      ADD_FAILURE() << "No connection";
+      return false;
+    }
+    std::mt19937 random(7);
+    sent.clear();
+    for (size_t i = 0; i < bytes; ++i) {
+      sent.push_back(static_cast<char>(random()));
+    }
+    size_t offset = 0;
+    start = pair->now;
+    const bool done = pair->run_until(
+        [&] {
+          // The application keeps the send queue short, like the gateway does
+          while (offset < sent.size() && pair->client.writable()) {
+            const size_t len = std::min(kChunkBytes, sent.size() - offset);
+            test::send_bytes(pair->client, std::string_view(sent).substr(offset, len));
+            offset += len;
+          }
+          return pair->server_received.size() >= sent.size();
+        },
+        limit);
+    EXPECT_EQ(pair->server_received.size(), sent.size());
+    EXPECT_TRUE(pair->server_received == sent) << "The byte stream arrived corrupted or out of order";
+    return done;
+  }
+
+  [[nodiscard]] ClientStats
+  client() {
+    return pair->client.stats();
+  }
+
+  [[nodiscard]] ClientStats
+  server() {
+    return pair->server().stats();
+  }
+
+  std::optional<test::TcpPair> pair;
+  std::string sent;
+  test::TcpPair::time_point start;
+};
+
+TEST_F(TransferTest, Clean) {
+  ASSERT_TRUE(transfer({.latency = 1ms}));
+  EXPECT_EQ(client().retransmitted_segments, 0);
+  EXPECT_EQ(client().fast_retransmits, 0);
+  EXPECT_EQ(client().rto_timeouts, 0);
+  EXPECT_EQ(server().out_of_order, 0);
+  EXPECT_EQ(server().duplicate_segments, 0);
+}
+
+TEST_F(TransferTest, Loss) {
+  ASSERT_TRUE(transfer({.latency = 1ms, .loss = 0.02}));
+  EXPECT_GT(client().retransmitted_segments, 0);
+  EXPECT_GT(client().fast_retransmits, 0);
+  EXPECT_GT(server().out_of_order, 0);
+}
+
+TEST_F(TransferTest, HeavyLossTimesOut) {
+  ASSERT_TRUE(transfer({.latency = 1ms, .loss = 0.1}, 64 << 10, 120s));
+  EXPECT_GT(client().rto_timeouts, 0);
+  EXPECT_GE(client().retransmitted_segments, client().fast_retransmits + client().rto_timeouts);
+}
+
+TEST_F(TransferTest, Reorder) {
+  ASSERT_TRUE(transfer({.latency = 1ms, .reorder = 0.05, .reorder_delay = 300us}));
+  EXPECT_GT(server().out_of_order, 0);
+  EXPECT_EQ(client().rto_timeouts, 0);
+}
+
+TEST_F(TransferTest, Duplicate) {
+  ASSERT_TRUE(transfer({.latency = 1ms, .duplicate = 0.05}));
+  EXPECT_GT(server().duplicate_segments, 0);
+  EXPECT_GT(client().duplicate_acks, 0);
+  EXPECT_EQ(client().rto_timeouts, 0);
+}
+
+TEST_F(TransferTest, BandwidthLimited) {
+  constexpr uint64_t kBandwidthBps = 20'000'000;
+  ASSERT_TRUE(transfer({.latency = 1ms, .bandwidth_bps = kBandwidthBps}));
+  // The link, not the stack, sets the pace
+  const std::chrono::nanoseconds elapsed = pair->now - start;
+  EXPECT_GE(elapsed, std::chrono::nanoseconds(kTransferBytes * 8 * 1'000'000'000 / kBandwidthBps));
+  EXPECT_EQ(client().rto_timeouts, 0);
+  EXPECT_EQ(server().out_of_order, 0);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Pure ACKs among `frames`, with the sequence number each acknowledges
+std::vector<uint32_t>
+acks(std::vector<test::Frame> frames) {
+  std::vector<uint32_t> acked;
+  for (auto& frame: frames) {
+    if (frame.tcp().header().flags == Flags::ACK && frame.payload().empty()) {
+      acked.push_back(frame.tcp().header().ack.value().value());
+    }
+  }
+  return acked;
+}
+
+} // namespace
+
+TEST(AckPolicyTest, ImmediateAcksEverySegment) {
+  test::ScriptedPeer peer(AckPolicy::Immediate);
+  peer.handshake();
+  const uint32_t start = peer.peer_seq.value();
+  peer.send_data("a");
+  peer.send_data("b");
+  peer.send_data("c");
+  EXPECT_EQ(peer.receive(false, false), "abc");
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{start + 1, start + 2, start + 3}));
+}
+
+TEST(AckPolicyTest, CoalescedAcksOncePerBurst) {
+  test::ScriptedPeer peer(AckPolicy::Coalesced);
+  peer.handshake();
+  peer.send_data("a");
+  peer.send_data("b");
+  peer.send_data("c");
+  EXPECT_EQ(peer.receive(true, false), "abc");
+  EXPECT_TRUE(peer.sent().empty());
+
+  peer.client.on_burst_end();
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{peer.peer_seq.value()}));
+  // Nothing is owed any more
+  peer.client.on_burst_end();
+  EXPECT_TRUE(peer.sent().empty());
+}
+
+TEST(AckPolicyTest, CoalescedAckRidesOnData) {
+  test::ScriptedPeer peer(AckPolicy::Coalesced);
+  peer.handshake();
+  peer.send_data("request");
+  EXPECT_EQ(peer.receive(true, false), "request");
+  test::send_bytes(peer.client, "reply");
+  peer.client.on_burst_end();
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "reply");
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+}
+
+TEST(AckPolicyTest, CoalescedAcksAFilledGapAtOnce) {
+  test::ScriptedPeer peer(AckPolicy::Coalesced);
+  peer.handshake();
+  const SeqNumber start = peer.peer_seq;
+  peer.send(Flags::PSH_ACK, start + 1, peer.client_seq, "b");
+  EXPECT_EQ(peer.receive(true, false), "");
+  std::ignore = peer.sent();
+
+  // The peer is likely in fast retransmit, it should hear at once
+  peer.send(Flags::PSH_ACK, start, peer.client_seq, "a");
+  EXPECT_EQ(peer.receive(true, false), "ab");
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{(start + 2).value()}));
+}
+
+TEST(AckPolicyTest, DelayedAcksEverySecondSegment) {
+  test::ScriptedPeer peer(AckPolicy::Delayed);
+  peer.handshake();
+  peer.send_data("a");
+  EXPECT_EQ(peer.receive(), "a");
+  EXPECT_TRUE(peer.sent().empty());
+  peer.send_data("b");
+  EXPECT_EQ(peer.receive(), "b");
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{peer.peer_seq.value()}));
+
+  // The timer armed for the first segment has nothing left to acknowledge
+  peer.advance(Client::kDelayedAckTimeout + 1ms);
+  EXPECT_TRUE(peer.sent().empty());
+}
+
+TEST(AckPolicyTest, DelayedAckTimer) {
+  test::ScriptedPeer peer(AckPolicy::Delayed);
+  peer.handshake();
+  peer.send_data("a");
+  EXPECT_EQ(peer.receive(), "a");
+  peer.advance(Client::kDelayedAckTimeout - 5ms);
+  EXPECT_TRUE(peer.sent().empty());
+  peer.advance(10ms);
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{peer.peer_seq.value()}));
+}
+
+TEST(AckPolicyTest, DelayedAckRidesOnData) {
+  test::ScriptedPeer peer(AckPolicy::Delayed);
+  peer.handshake();
+  peer.send_data("request");
+  EXPECT_EQ(peer.receive(), "request");
+  test::send_bytes(peer.client, "reply");
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+
+  // The data carried the ACK, the timer does not send another one
+  peer.advance(Client::kDelayedAckTimeout + 1ms);
+  EXPECT_TRUE(acks(peer.sent()).empty());
+}
+
+TEST(AckPolicyTest, DeferredAckOnceConsumed) {
+  test::ScriptedPeer peer(AckPolicy::Deferred);
+  peer.handshake();
+  peer.send_data("a");
+  EXPECT_EQ(peer.receive(false, false), "a");
+  EXPECT_TRUE(peer.sent().empty());
+
+  peer.client.on_data_consumed();
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{peer.peer_seq.value()}));
+  peer.client.on_data_consumed();
+  peer.client.on_burst_end();
+  EXPECT_TRUE(peer.sent().empty());
+}
+
+TEST(AckPolicyTest, DeferredAckAtTheEndOfTheBurst) {
+  test::ScriptedPeer peer(AckPolicy::Deferred);
+  peer.handshake();
+  peer.send_data("a");
+  peer.send_data("b");
+  EXPECT_EQ(peer.receive(false, false), "ab");
+  EXPECT_TRUE(peer.sent().empty());
+
+  // Unless the application says so first, the burst end sends it
+  peer.client.on_burst_end();
+  EXPECT_EQ(acks(peer.sent()), (std::vector<uint32_t>{peer.peer_seq.value()}));
+}
+
+TEST(AckPolicyTest, DeferredAckRidesOnTheReply) {
+  test::ScriptedPeer peer(AckPolicy::Deferred);
+  peer.handshake();
+  peer.send_data("request");
+  EXPECT_EQ(peer.receive(false, false), "request");
+  // The application answers before it returns
+  test::send_bytes(peer.client, "reply");
+  peer.client.on_data_consumed();
+  peer.client.on_burst_end();
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "reply");
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "network/tcp/congestion_control.h"
+
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint32_t kMss = 1000;
+
+} // namespace
+
+TEST(NewRenoTest, SlowStartGrowsPerAckedBytes) {
+  NewReno cc(kMss);
+  EXPECT_EQ(cc.cwnd(), 10 * kMss);
+  EXPECT_EQ(cc.ssthresh(), UINT32_MAX);
+  cc.on_ack(kMss, {}, 1ms);
+  EXPECT_EQ(cc.cwnd(), 11 * kMss);
+  // A stretch ack grows the window by two segments at most
+  cc.on_ack(10 * kMss, {}, 1ms);
+  EXPECT_EQ(cc.cwnd(), 13 * kMss);
+}
+
+TEST(NewRenoTest, HalvesOnLoss) {
+  NewReno cc(kMss);
+  cc.on_loss(20 * kMss, {});
+  EXPECT_EQ(cc.ssthresh(), 10 * kMss);
+  EXPECT_EQ(cc.cwnd(), 10 * kMss);
+
+  // Congestion avoidance, one segment per window
+  cc.on_ack(9 * kMss, {}, 1ms);
+  EXPECT_EQ(cc.cwnd(), 10 * kMss);
+  cc.on_ack(kMss, {}, 1ms);
+  EXPECT_EQ(cc.cwnd(), 11 * kMss);
+}
+
+TEST(NewRenoTest, TimeoutRestartsSlowStart) {
+  NewReno cc(kMss);
+  cc.on_timeout(2 * kMss);
+  EXPECT_EQ(cc.cwnd(), kMss);
+  EXPECT_EQ(cc.ssthresh(), 2 * kMss);
+  cc.on_ack(kMss, {}, 1ms);
+  EXPECT_EQ(cc.cwnd(), 2 * kMss);
+}
+
+TEST(CubicTest, ReducesByBeta) {
+  Cubic cc(kMss);
+  EXPECT_EQ(cc.cwnd(), 10 * kMss);
+  cc.on_loss(10 * kMss, {});
+  EXPECT_EQ(cc.cwnd(), 7 * kMss);
+  EXPECT_EQ(cc.ssthresh(), 7 * kMss);
+  cc.on_timeout(7 * kMss);
+  EXPECT_EQ(cc.cwnd(), kMss);
+}
+
+TEST(CubicTest, ClimbsBackToWmax) {
+  Cubic cc(kMss);
+  for (int i = 0; i < 90; i++) {
+    cc.on_ack(kMss, {}, 1ms);
+  }
+  EXPECT_EQ(cc.cwnd(), 100 * kMss);
+  cc.on_loss(100 * kMss, {});
+  EXPECT_EQ(cc.cwnd(), 70 * kMss);
+
+  // K = cbrt(30 / 0.4) ~ 4.2s to reach the previous maximum, the window is concave below it
+  const auto start = idk::base::RdtscClock::now();
+  uint32_t previous = cc.cwnd();
+  uint32_t at_two_seconds = 0;
+  for (int ms = 0; ms <= 6000; ms += 10) {
+    const auto now = start + idk::base::RdtscDuration(std::chrono::milliseconds(ms));
+    cc.on_ack(kMss, now, 10ms);
+    EXPECT_GE(cc.cwnd(), previous);
+    previous = cc.cwnd();
+    if (ms == 2000) {
+      at_two_seconds = cc.cwnd();
+    }
+  }
+  EXPECT_GT(at_two_seconds, 85 * kMss);
+  EXPECT_LT(at_two_seconds, 100 * kMss);
+  EXPECT_GT(cc.cwnd(), 100 * kMss);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "network/tcp/connect_scheduler.h"
+
+using namespace idk;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+class ConnectSchedulerTest : public ::testing::Test {
+protected:
+  using time_point = ConnectScheduler::time_point;
+
+  static time_point
+  at(std::chrono::nanoseconds offset) {
+    return time_point{} + base::RdtscDuration(offset);
+  }
+
+  // Keys of the attempts which start at `now`
+  static std::vector<uint32_t>
+  drain(ConnectScheduler& scheduler, time_point now) {
+    std::vector<uint32_t> keys;
+    while (const auto key = scheduler.next(now)) {
+      keys.push_back(key.value());
+    }
+    return keys;
+  }
+};
+
+TEST_F(ConnectSchedulerTest, BurstThenSteadyRate) {
+  ConnectScheduler scheduler({.syn_rate = 100, .syn_burst = 4, .max_in_flight = 100});
+  for (uint32_t key = 0; key < 10; ++key) {
+    scheduler.request(key, at(1s));
+  }
+  EXPECT_TRUE(drain(scheduler, at(0s)).empty());
+  EXPECT_EQ(drain(scheduler, at(1s)), (std::vector<uint32_t>{0, 1, 2, 3}));
+  // One every 10ms from then on
+  EXPECT_TRUE(drain(scheduler, at(1s + 5ms)).empty());
+  EXPECT_EQ(drain(scheduler, at(1s + 11ms)), (std::vector<uint32_t>{4}));
+  EXPECT_EQ(drain(scheduler, at(1s + 31ms)), (std::vector<uint32_t>{5, 6}));
+  EXPECT_EQ(scheduler.queued(), 3);
+  EXPECT_EQ(scheduler.in_flight(), 7);
+}
+
+TEST_F(ConnectSchedulerTest, InFlightLimit) {
+  ConnectScheduler scheduler({.syn_rate = 1000, .syn_burst = 10, .max_in_flight = 2});
+  for (uint32_t key = 0; key < 4; ++key) {
+    scheduler.request(key, at(0s));
+  }
+  EXPECT_EQ(drain(scheduler, at(0s)), (std::vector<uint32_t>{0, 1}));
+  scheduler.finished();
+  EXPECT_EQ(drain(scheduler, at(0s)), (std::vector<uint32_t>{2}));
+  scheduler.finished();
+  scheduler.finished();
+  EXPECT_EQ(drain(scheduler, at(0s)), (std::vector<uint32_t>{3}));
+  scheduler.finished();
+  EXPECT_ANY_THROW(scheduler.finished());
+}
+
+TEST_F(ConnectSchedulerTest, RetryBackoff) {
+  ConnectScheduler scheduler({.retry_backoff = 100ms, .max_retry_backoff = 1s});
+  EXPECT_EQ(std::chrono::milliseconds(scheduler.backoff(0)).count(), 0);
+  EXPECT_NEAR(std::chrono::milliseconds(scheduler.backoff(1)).count(), 100, 1);
+  EXPECT_NEAR(std::chrono::milliseconds(scheduler.backoff(3)).count(), 400, 1);
+  EXPECT_NEAR(std::chrono::milliseconds(scheduler.backoff(30)).count(), 1000, 1);
+
+  // A retry waits for its backoff, attempts requested later but due earlier go first
+  scheduler.request(7, at(0s) + scheduler.backoff(2));
+  scheduler.request(8, at(0s));
+  EXPECT_EQ(drain(scheduler, at(100ms)), (std::vector<uint32_t>{8}));
+  EXPECT_EQ(drain(scheduler, at(201ms)), (std::vector<uint32_t>{7}));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "network/tcp/connection_manager.h"
+
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+
+namespace {
+
+struct TestSession : base::NoCopy {
+  TestSession(bool throws, bool throws_at_burst_end) : throws(throws), throws_at_burst_end(throws_at_burst_end) {}
+
+  void
+  on_burst_end() {
+    bursts++;
+    REQUIRE(!throws_at_burst_end, "Burst end failed");
+  }
+
+  bool throws;
+  bool throws_at_burst_end;
+  size_t packets{0};
+  size_t bursts{0};
+};
+
+// Sessions of the client side of the simulator, the segments come from the server side
+class ConnectionManagerTest : public ::testing::Test {
+protected:
+  static Connection
+  connection(uint16_t port) {
+    return {.session = {.src = test::kClientHost, .dst = test::kServerHost},
+            .src_port = Port(port),
+            .dst_port = Port(443)};
+  }
+
+  void
+  send(uint16_t port) {
+    test::send_segment(simulator.device(sim::Simulator::kServer).get_sender(),
+                       {.session = {.src = test::kServerHost, .dst = test::kClientHost},
+                        .src_port = Port(443),
+                        .dst_port = Port(port)},
+                       Flags::ACK, SeqNumber(1), SeqNumber(1));
+  }
+
+  // Hands the segments on the wire to `manager` as one burst
+  void
+  process() {
+    simulator.step(simulator.now());
+    auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+    std::vector<dpdk::RxPacket> packets;
+    for (size_t i = 0; i < burst.size(); ++i) {
+      packets.push_back(burst.take(i));
+    }
+    manager.process(packets, [](TestSession& session, const dpdk::RxPacket&) {
+      session.packets++;
+      REQUIRE(!session.throws, "Packet failed");
+    });
+  }
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  ConnectionManager<TestSession> manager{simulator.device(sim::Simulator::kClient).get_sender()};
+};
+
+} // namespace
+
+TEST_F(ConnectionManagerTest, FailedSessionIsRemovedAndTheBurstGoesOn) {
+  auto& healthy = manager.add(connection(50001), false, false);
+  manager.add(connection(50000), true, false);
+  send(50000);
+  send(50001);
+  send(50000);
+  send(50001);
+  process();
+
+  EXPECT_EQ(manager.size(), 1);
+  EXPECT_EQ(healthy.packets, 2);
+  EXPECT_EQ(healthy.bursts, 1);
+  // The failed session is gone, its next segment is of an unknown flow
+  EXPECT_EQ(manager.unknown(), 1);
+}
+
+TEST_F(ConnectionManagerTest, FailuresGoToTheCallback) {
+  std::vector<std::string> failures;
+  manager.on_failure([&](TestSession&, const std::exception& e) { failures.emplace_back(e.what()); });
+  auto& failing = manager.add(connection(50000), true, false);
+  auto& failing_at_end = manager.add(connection(50001), false, true);
+  auto& healthy = manager.add(connection(50002), false, false);
+  send(50000);
+  send(50001);
+  send(50000);
+  send(50002);
+  process();
+
+  ASSERT_EQ(failures.size(), 3);
+  EXPECT_NE(failures[0].find("Packet failed"), std::string::npos);
+  EXPECT_NE(failures[1].find("Packet failed"), std::string::npos);
+  EXPECT_NE(failures[2].find("Burst end failed"), std::string::npos);
+  // The callback did not remove them, every session saw its segments and the end of the burst
+  EXPECT_EQ(manager.size(), 3);
+  EXPECT_EQ(failing.packets, 2);
+  EXPECT_EQ(failing.bursts, 1);
+  EXPECT_EQ(failing_at_end.bursts, 1);
+  EXPECT_EQ(healthy.packets, 1);
+  EXPECT_EQ(healthy.bursts, 1);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+
+namespace {
+
+size_t
+payload_size(std::vector<test::Frame>& frames) {
+  size_t size = 0;
+  for (auto& frame: frames) {
+    size += frame.payload().size();
+  }
+  return size;
+}
+
+} // namespace
+
+TEST(CorkTest, OnlyFullSegmentsWhileCorked) {
+  test::ScriptedPeer peer;
+  peer.handshake();
+  const std::string sent(3000, 'x');
+  {
+    Cork cork(peer.client);
+    test::send_bytes(peer.client, sent, 100);
+    auto frames = peer.sent();
+    ASSERT_FALSE(frames.empty());
+    const size_t segment = frames.front().payload().size();
+    for (auto& frame: frames) {
+      EXPECT_EQ(frame.payload().size(), segment);
+    }
+    EXPECT_LT(sent.size() - payload_size(frames), segment);
+    EXPECT_EQ(peer.client.queued_bytes(), sent.size() - payload_size(frames));
+
+    // The remainder goes out on uncork
+    cork.uncork();
+    frames = peer.sent();
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames[0].payload().size(), sent.size() % segment);
+    EXPECT_EQ(frames[0].tcp().header().flags, Flags::PSH_ACK);
+  }
+  EXPECT_EQ(peer.client.queued_bytes(), 0);
+  EXPECT_FALSE(peer.client.is_corked());
+}
+
+TEST(CorkTest, NestedCorksReleaseOnTheLast) {
+  test::ScriptedPeer peer;
+  peer.handshake();
+  {
+    Cork outer(peer.client);
+    {
+      Cork inner(peer.client);
+      test::send_bytes(peer.client, "hello");
+    }
+    EXPECT_TRUE(peer.client.is_corked());
+    EXPECT_TRUE(peer.sent().empty());
+    test::send_bytes(peer.client, " world");
+  }
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "hello world");
+}
+
+TEST(CorkTest, CoalescedAckIsHeldBack) {
+  test::ScriptedPeer peer(AckPolicy::Coalesced);
+  peer.handshake();
+  Cork cork(peer.client);
+  peer.send_data("request");
+  EXPECT_EQ(peer.receive(), "request");
+  EXPECT_TRUE(peer.sent().empty());
+
+  cork.uncork();
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().flags, Flags::ACK);
+  EXPECT_TRUE(frames[0].payload().empty());
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+}
+
+TEST(CorkTest, DeferredAckRidesOnTheReply) {
+  test::ScriptedPeer peer(AckPolicy::Deferred);
+  peer.handshake();
+  {
+    Cork cork(peer.client);
+    peer.send_data("request");
+    EXPECT_EQ(peer.receive(), "request");
+    test::send_bytes(peer.client, "reply");
+    EXPECT_TRUE(peer.sent().empty());
+  }
+  // One segment carries the reply and the ACK
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "reply");
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+}
+
+TEST(CorkTest, DestructorDoesNotThrow) {
+  test::ScriptedPeer peer;
+  peer.handshake();
+  EXPECT_NO_THROW({
+    Cork cork(peer.client);
+    // Released behind the guard's back, uncorking again fails
+    peer.client.uncork();
+  });
+  Cork cork(peer.client);
+  peer.client.uncork();
+  EXPECT_THROW(cork.uncork(), std::runtime_error);
+}
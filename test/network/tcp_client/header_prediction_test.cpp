@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "network/tcp/header_prediction.h"
+#include "network/tcp/packet_view.h"
+
+using namespace idk;
+using namespace idk::net::tcp;
+
+class HeaderPredictionTest : public ::testing::Test {
+protected:
+  static constexpr uint16_t kWindow = 512;
+
+  void
+  SetUp() override {
+    prediction.enable(true);
+    prediction.set_window(kWindow);
+  }
+
+  base::ByteView
+  segment(Flags flags, SeqNumber seq, SeqNumber ack, size_t payload_size, bool timestamp = true) {
+    PacketView tcp(base::MutableByteView{buffer.data(), buffer.size()});
+    std::optional<Timestamp> ts;
+    if (timestamp) {
+      ts = Timestamp{.value = 7, .echo = 3};
+    }
+    tcp.init(net::Connection{}, flags, seq, ack, false, ts);
+    tcp.header().window = kWindow;
+    tcp.resize_payload(payload_size);
+    return {buffer.data(), PacketView::predict_size(payload_size, false, timestamp)};
+  }
+
+  HeaderPrediction prediction;
+  std::array<uint8_t, 2048> buffer{};
+};
+
+TEST_F(HeaderPredictionTest, InOrderData) {
+  const auto result = prediction.classify(segment(Flags::PSH_ACK, 1000, 500, 100), 1000, 500, 600);
+  EXPECT_EQ(result.kind, HeaderPrediction::Kind::Data);
+  EXPECT_EQ(result.payload.size(), 100);
+  EXPECT_EQ(result.timestamp.value, 7);
+  EXPECT_EQ(result.timestamp.echo, 3);
+}
+
+TEST_F(HeaderPredictionTest, PureAck) {
+  EXPECT_EQ(prediction.classify(segment(Flags::ACK, 1000, 550, 0), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Ack);
+  // Nothing new acknowledged, or beyond what was sent
+  EXPECT_EQ(prediction.classify(segment(Flags::ACK, 1000, 500, 0), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+  EXPECT_EQ(prediction.classify(segment(Flags::ACK, 1000, 700, 0), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+}
+
+TEST_F(HeaderPredictionTest, Misses) {
+  // Out of order
+  EXPECT_EQ(prediction.classify(segment(Flags::PSH_ACK, 1100, 500, 100), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+  // Data acknowledging new data
+  EXPECT_EQ(prediction.classify(segment(Flags::PSH_ACK, 1000, 550, 100), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+  EXPECT_EQ(prediction.classify(segment(Flags::FIN_ACK, 1000, 500, 100), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+  // Options layout differs from the negotiated one
+  EXPECT_EQ(prediction.classify(segment(Flags::PSH_ACK, 1000, 500, 100, false), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+
+  prediction.set_window(kWindow + 1);
+  EXPECT_EQ(prediction.classify(segment(Flags::PSH_ACK, 1000, 500, 100), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+
+  prediction.set_window(kWindow);
+  prediction.disable();
+  EXPECT_EQ(prediction.classify(segment(Flags::PSH_ACK, 1000, 500, 100), 1000, 500, 600).kind,
+            HeaderPrediction::Kind::Miss);
+}
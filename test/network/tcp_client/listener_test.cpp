@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+
+#include "network/tcp/listener.h"
+#include "network/tcp/receive_window.h"
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+// The test plays the client of a handshake with a Listener, through the simulator
+class ListenerTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kIsn = 5000;
+  static constexpr uint32_t kTimestamp = 777;
+
+  // Puts a segment of the client on the wire
+  void
+  send(Flags flags, SeqNumber seq, SeqNumber ack, const test::SegmentOptions& options = {},
+       std::string_view payload = {}) {
+    test::send_segment(simulator.device(sim::Simulator::kClient).get_sender(), client, flags, seq, ack, payload,
+                       options);
+  }
+
+  // The listener handles the segment on the wire
+  std::optional<Accepted>
+  deliver() {
+    simulator.step(simulator.now());
+    auto burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    EXPECT_EQ(burst.size(), 1);
+    return listener.process_packet(burst.take(0));
+  }
+
+  // Frames the listener sent
+  std::vector<test::Frame>
+  replies() {
+    simulator.step(simulator.now());
+    return test::receive_frames(simulator.device(sim::Simulator::kClient));
+  }
+
+  // Sends a SYN with `options` and returns the SYN-ACK
+  test::Frame
+  syn(test::SegmentOptions options) {
+    options.syn = true;
+    send(Flags::SYN, SeqNumber(kIsn), SeqNumber(0), options);
+    EXPECT_FALSE(deliver().has_value());
+    auto frames = replies();
+    EXPECT_EQ(frames.size(), 1);
+    return frames.at(0);
+  }
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  Listener listener{Port(443), simulator.device(sim::Simulator::kServer).get_sender()};
+  // The view of the client
+  Connection client{
+      .session = {.src = test::kClientHost, .dst = test::kServerHost}, .src_port = Port(50000), .dst_port = Port(443)};
+};
+
+TEST_F(ListenerTest, Handshake) {
+  auto syn_ack =
+      syn({.mss = 1400, .window_scale = 7, .sack_permitted = true, .timestamp = Timestamp{.value = kTimestamp}});
+  const auto& header = syn_ack.tcp().header();
+  EXPECT_EQ(header.flags, Flags::SYN_ACK);
+  EXPECT_EQ(header.ack.value(), SeqNumber(kIsn + 1));
+  const auto options = syn_ack.tcp().parse_options();
+  EXPECT_EQ(options.mss, Client::kDefaultMss);
+  EXPECT_EQ(options.window_scale,
+            ReceiveWindow(Client::kInitialReceiveBuffer, Client::kMaxReceiveBuffer).offered_scale());
+  EXPECT_TRUE(options.sack_permitted);
+  ASSERT_TRUE(options.timestamp.has_value());
+  EXPECT_EQ(options.timestamp->echo, kTimestamp);
+  EXPECT_EQ(listener.stats().syns, 1);
+
+  // The final ACK returns the cookie, and the options in the echo
+  const SeqNumber cookie = header.seq.value();
+  send(Flags::ACK, SeqNumber(kIsn + 1), cookie + 1,
+       {.timestamp = Timestamp{.value = kTimestamp + 1, .echo = options.timestamp->value}, .window = 1000});
+  const auto accepted = deliver();
+  ASSERT_TRUE(accepted.has_value());
+  EXPECT_EQ(accepted->connection, (Connection{.session = {.src = test::kServerHost, .dst = test::kClientHost},
+                                              .src_port = Port(443),
+                                              .dst_port = Port(50000)}));
+  EXPECT_EQ(accepted->iss, cookie);
+  EXPECT_EQ(accepted->irs, SeqNumber(kIsn));
+  EXPECT_EQ(accepted->window, 1000);
+  // Rounded down to the cookie's mss table
+  EXPECT_EQ(accepted->options.mss, 1380);
+  EXPECT_EQ(accepted->options.window_scale, 7);
+  EXPECT_TRUE(accepted->options.sack_permitted);
+  EXPECT_EQ(accepted->options.timestamp, kTimestamp + 1);
+  EXPECT_EQ(listener.stats().accepted, 1);
+  EXPECT_TRUE(replies().empty());
+}
+
+TEST_F(ListenerTest, NoTimestampsNoScaleOrSack) {
+  // Window scale and SACK only survive in the timestamp, without it they are not offered
+  auto syn_ack = syn({.mss = 1460, .window_scale = 7, .sack_permitted = true});
+  const auto options = syn_ack.tcp().parse_options();
+  EXPECT_EQ(options.mss, Client::kDefaultMss);
+  EXPECT_FALSE(options.window_scale.has_value());
+  EXPECT_FALSE(options.sack_permitted);
+  EXPECT_FALSE(options.timestamp.has_value());
+
+  send(Flags::ACK, SeqNumber(kIsn + 1), syn_ack.tcp().header().seq.value() + 1);
+  const auto accepted = deliver();
+  ASSERT_TRUE(accepted.has_value());
+  EXPECT_EQ(accepted->options.mss, 1460);
+  EXPECT_FALSE(accepted->options.window_scale.has_value());
+  EXPECT_FALSE(accepted->options.sack_permitted);
+  EXPECT_FALSE(accepted->options.timestamp.has_value());
+}
+
+TEST_F(ListenerTest, MissingMssIsTheDefault) {
+  // A SYN without options, the mss option is the minimum of the cookie table
+  send(Flags::SYN, SeqNumber(kIsn), SeqNumber(0));
+  EXPECT_FALSE(deliver().has_value());
+  auto frames = replies();
+  ASSERT_EQ(frames.size(), 1);
+  send(Flags::ACK, SeqNumber(kIsn + 1), frames[0].tcp().header().seq.value() + 1);
+  const auto accepted = deliver();
+  ASSERT_TRUE(accepted.has_value());
+  EXPECT_EQ(accepted->options.mss, SynCookies::kMssTable.front());
+}
+
+TEST_F(ListenerTest, BadCookieIsReset) {
+  auto syn_ack = syn({});
+  send(Flags::ACK, SeqNumber(kIsn + 1), syn_ack.tcp().header().seq.value() + 2);
+  EXPECT_FALSE(deliver().has_value());
+  EXPECT_EQ(listener.stats().bad_cookies, 1);
+  EXPECT_EQ(listener.stats().accepted, 0);
+  auto frames = replies();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_TRUE(has_flag(frames[0].tcp().header().flags, Flags::RST));
+
+  // Neither is an ACK of another sequence number of the peer
+  send(Flags::ACK, SeqNumber(kIsn + 2), syn_ack.tcp().header().seq.value() + 1);
+  EXPECT_FALSE(deliver().has_value());
+  EXPECT_EQ(listener.stats().bad_cookies, 2);
+}
+
+TEST_F(ListenerTest, ExpiredCookieIsReset) {
+#ifndef IDK_SIMULATED_CLOCK
+  GTEST_SKIP() << "Needs the simulated clock";
+#else
+  auto syn_ack = syn({});
+  // A cookie is valid in the period it was issued in and the next one, two periods later it expired for sure
+  simulator.step(simulator.now() + base::RdtscDuration(std::chrono::seconds(2 * SynCookies::kPeriodSeconds + 1)));
+  send(Flags::ACK, SeqNumber(kIsn + 1), syn_ack.tcp().header().seq.value() + 1);
+  EXPECT_FALSE(deliver().has_value());
+  EXPECT_EQ(listener.stats().bad_cookies, 1);
+#endif
+}
+
+TEST_F(ListenerTest, UnexpectedSegmentsAreReset) {
+  send(Flags::PSH_ACK | Flags::SYN, SeqNumber(kIsn), SeqNumber(1));
+  EXPECT_FALSE(deliver().has_value());
+  // Without ACK
+  send(Flags::PSH, SeqNumber(kIsn), SeqNumber(0), {}, "data");
+  EXPECT_FALSE(deliver().has_value());
+  EXPECT_EQ(listener.stats().resets, 2);
+  EXPECT_EQ(replies().size(), 2);
+
+  // RSTs are not answered
+  send(Flags::RST, SeqNumber(kIsn), SeqNumber(0));
+  EXPECT_FALSE(deliver().has_value());
+  EXPECT_TRUE(replies().empty());
+}
+
+class AcceptedClientTest : public ::testing::Test {
+protected:
+  // The client of an accepted connection, local view of the server
+  Client
+  accept(const Accepted& accepted) {
+    return Client(accepted, simulator.device(sim::Simulator::kServer).get_sender(), timers);
+  }
+
+  std::vector<test::Frame>
+  sent() {
+    simulator.step(simulator.now());
+    return test::receive_frames(simulator.device(sim::Simulator::kClient));
+  }
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  base::TimerWheel timers{std::chrono::microseconds(100), simulator.now()};
+  Accepted accepted{
+      .connection = {.session = {.src = test::kServerHost, .dst = test::kClientHost},
+                     .src_port = Port(443),
+                     .dst_port = Port(50000)},
+      .iss = SeqNumber(0xFFFFFFF0),
+      .irs = SeqNumber(5000),
+      .window = 100,
+      .options = {.mss = 1000},
+  };
+};
+
+TEST_F(AcceptedClientTest, SequenceNumbers) {
+  auto client = accept(accepted);
+  EXPECT_EQ(client.get_state(), Client::State::Connected);
+  test::send_bytes(client, "hello");
+  auto frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().seq.value(), accepted.iss + 1);
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), accepted.irs + 1);
+  EXPECT_EQ(frames[0].payload(), "hello");
+}
+
+TEST_F(AcceptedClientTest, MssOfThePeer) {
+  accepted.window = 65535;
+  auto client = accept(accepted);
+  test::send_bytes(client, std::string(2500, 'x'));
+  auto frames = sent();
+  ASSERT_FALSE(frames.empty());
+  size_t size = 0;
+  for (auto& frame: frames) {
+    EXPECT_LE(frame.payload().size(), 1000);
+    size += frame.payload().size();
+  }
+  EXPECT_EQ(frames[0].payload().size(), 1000);
+  EXPECT_EQ(size, 2500);
+}
+
+TEST_F(AcceptedClientTest, WindowScale) {
+  {
+    // Unscaled without the option
+    auto unscaled = accept(accepted);
+    EXPECT_EQ(unscaled.stats().send_window, 100);
+  }
+  // Its reset
+  std::ignore = sent();
+
+  accepted.options.window_scale = 3;
+  auto client = accept(accepted);
+  EXPECT_EQ(client.stats().send_window, 100 << 3);
+  // Our windows are scaled by the shift the listener offered
+  const uint8_t shift = ReceiveWindow(Client::kInitialReceiveBuffer, Client::kMaxReceiveBuffer).offered_scale();
+  client.set_receive_space(Client::kInitialReceiveBuffer);
+  test::send_bytes(client, "hello");
+  auto frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().window.value(), Client::kInitialReceiveBuffer >> shift);
+}
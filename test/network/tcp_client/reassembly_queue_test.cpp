@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "network/tcp/reassembly_queue.h"
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+
+class ReassemblyQueueTest : public ::testing::Test {
+protected:
+  ReassemblyQueueTest() {
+    for (size_t i = 0; i < stream.size(); ++i) {
+      stream[i] = static_cast<uint8_t>('a' + i % 26);
+    }
+  }
+
+  // Queues the bytes [seq, seq + size) of the stream which starts at `kBase`
+  bool
+  insert(uint32_t seq, size_t size) {
+    return queue.insert(SeqNumber(seq), base::ByteView(stream).subspan(seq - kBase, size),
+                        test::received_packet(simulator));
+  }
+
+  // Drains from `next`, the sequence number after the drained data goes to `next`
+  std::string
+  drain(SeqNumber& next) {
+    std::string drained;
+    next = queue.drain(next, [&](base::ByteView bytes, const dpdk::RxPacket&) {
+      drained.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    });
+    return drained;
+  }
+
+  [[nodiscard]] std::string
+  expected(uint32_t seq, size_t size) const {
+    return {reinterpret_cast<const char*>(stream.data()) + (seq - kBase), size};
+  }
+
+  static constexpr uint32_t kBase = 1000;
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  std::vector<uint8_t> stream = std::vector<uint8_t>(ReassemblyQueue::kMaxBytes + 1000);
+  ReassemblyQueue queue;
+};
+
+TEST_F(ReassemblyQueueTest, DrainsAcrossSegments) {
+  ASSERT_TRUE(insert(1200, 100));
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1400, 100));
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_EQ(queue.size_bytes(), 300);
+
+  // Nothing continues the stream until the hole is filled
+  SeqNumber next(1000);
+  EXPECT_EQ(drain(next), "");
+  EXPECT_EQ(next, SeqNumber(1000));
+
+  next = SeqNumber(1100);
+  EXPECT_EQ(drain(next), expected(1100, 200));
+  EXPECT_EQ(next, SeqNumber(1300));
+  EXPECT_EQ(queue.size(), 1);
+  EXPECT_EQ(queue.size_bytes(), 100);
+
+  next = SeqNumber(1400);
+  EXPECT_EQ(drain(next), expected(1400, 100));
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size_bytes(), 0);
+}
+
+TEST_F(ReassemblyQueueTest, OverlapsAreTrimmed) {
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1150, 100));
+  ASSERT_TRUE(insert(1120, 200));
+  SeqNumber next(1100);
+  EXPECT_EQ(drain(next), expected(1100, 220));
+  EXPECT_EQ(next, SeqNumber(1320));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ReassemblyQueueTest, DataBelowNextIsSkipped) {
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1200, 100));
+  // The first segment was delivered in part already
+  SeqNumber next(1150);
+  EXPECT_EQ(drain(next), expected(1150, 150));
+  EXPECT_EQ(next, SeqNumber(1300));
+
+  // Fully delivered, the segment only leaves the queue
+  ASSERT_TRUE(insert(1300, 100));
+  next = SeqNumber(1400);
+  EXPECT_EQ(drain(next), "");
+  EXPECT_EQ(next, SeqNumber(1400));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ReassemblyQueueTest, DuplicatesAreNotQueued) {
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1120, 50));
+  EXPECT_EQ(queue.size(), 1);
+  EXPECT_EQ(queue.size_bytes(), 100);
+  SeqNumber next(1100);
+  EXPECT_EQ(drain(next), expected(1100, 100));
+}
+
+TEST_F(ReassemblyQueueTest, WrappedSequenceNumbers) {
+  // The queue holds sequence numbers just below and above the wrap
+  const uint32_t start = 0xFFFFFF00;
+  std::vector<uint8_t> bytes(0x200);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  const auto slice = [&](uint32_t seq, size_t size) {
+    return base::ByteView(bytes).subspan(static_cast<uint32_t>(seq - start), size);
+  };
+  ASSERT_TRUE(queue.insert(SeqNumber(0x80), slice(0x80, 0x80), test::received_packet(simulator)));
+  ASSERT_TRUE(queue.insert(SeqNumber(0xFFFFFF80), slice(0xFFFFFF80, 0x100), test::received_packet(simulator)));
+
+  std::array<SackBlock, kMaxSackBlocks> blocks;
+  ASSERT_EQ(queue.sack_blocks(blocks), 1);
+  EXPECT_EQ(blocks[0].left.value(), SeqNumber(0xFFFFFF80));
+  EXPECT_EQ(blocks[0].right.value(), SeqNumber(0x100));
+
+  std::vector<uint8_t> drained;
+  const auto next = queue.drain(SeqNumber(0xFFFFFF80), [&](base::ByteView data, const dpdk::RxPacket&) {
+    drained.insert(drained.end(), data.begin(), data.end());
+  });
+  EXPECT_EQ(next, SeqNumber(0x100));
+  EXPECT_TRUE(std::ranges::equal(drained, slice(0xFFFFFF80, 0x180)));
+}
+
+TEST_F(ReassemblyQueueTest, SegmentLimit) {
+  for (size_t i = 0; i < ReassemblyQueue::kMaxSegments; ++i) {
+    ASSERT_TRUE(insert(kBase + 100 + i * 2, 1));
+  }
+  EXPECT_FALSE(insert(kBase + 100 + ReassemblyQueue::kMaxSegments * 2, 1));
+  EXPECT_EQ(queue.size(), ReassemblyQueue::kMaxSegments);
+  // Data which is queued already is still accepted
+  EXPECT_TRUE(insert(kBase + 100, 1));
+}
+
+TEST_F(ReassemblyQueueTest, ByteLimit) {
+  constexpr size_t kSegment = ReassemblyQueue::kMaxBytes / 4;
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(insert(kBase + 100 + i * kSegment, kSegment));
+  }
+  EXPECT_EQ(queue.size_bytes(), ReassemblyQueue::kMaxBytes);
+  EXPECT_FALSE(insert(kBase + 50, 1));
+
+  // Draining makes room again
+  SeqNumber next(kBase + 100);
+  EXPECT_EQ(drain(next).size(), ReassemblyQueue::kMaxBytes);
+  EXPECT_TRUE(insert(kBase + 50, 1));
+}
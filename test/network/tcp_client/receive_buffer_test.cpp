@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include "network/tcp/receive_buffer.h"
+
+using namespace idk::net::tcp;
+using namespace idk;
+
+class ReceiveBufferTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::iota(data.begin(), data.end(), 0);
+    // Three segments: [0, 10), [10, 15), [15, 40)
+    buffer.push_borrowed({data.data(), 10});
+    buffer.push_borrowed({data.data() + 10, 5});
+    buffer.push_borrowed({data.data() + 15, 25});
+  }
+
+  std::array<uint8_t, 40> data;
+  ReceiveBuffer buffer;
+};
+
+TEST_F(ReceiveBufferTest, Size) {
+  EXPECT_EQ(buffer.size(), 40);
+  EXPECT_EQ(buffer.segments_size(), 3);
+}
+
+TEST_F(ReceiveBufferTest, PeekAcrossSegments) {
+  const auto value = buffer.peek<std::array<uint8_t, 8>>(6);
+  ASSERT_TRUE(value);
+  for (size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(value.value()[i], 6 + i);
+  }
+  EXPECT_FALSE((buffer.peek<std::array<uint8_t, 8>>(33)));
+}
+
+TEST_F(ReceiveBufferTest, LineariseInsideSegmentIsInPlace) {
+  buffer.consume(16);
+  const auto view = buffer.linearise(20);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(view->data(), data.data() + 16);
+}
+
+TEST_F(ReceiveBufferTest, LineariseAcrossSegmentsCopies) {
+  buffer.consume(8);
+  const auto view = buffer.linearise(10);
+  ASSERT_TRUE(view);
+  EXPECT_NE(view->data(), data.data() + 8);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ((*view)[i], 8 + i);
+  }
+  EXPECT_FALSE(buffer.linearise(33));
+}
+
+TEST_F(ReceiveBufferTest, ReleaseDropsConsumedSegments) {
+  buffer.consume(15);
+  EXPECT_EQ(buffer.size(), 25);
+  EXPECT_EQ(buffer.segments_size(), 3);
+  buffer.release();
+  EXPECT_EQ(buffer.segments_size(), 1);
+  EXPECT_EQ(buffer.peek<uint8_t>(), 15);
+
+  buffer.consume(25);
+  buffer.release();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(buffer.segments_size(), 0);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include "network/tcp/receive_window.h"
+
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+TEST(ReceiveWindowTest, OfferedScaleCoversMaxBuffer) {
+  EXPECT_EQ(ReceiveWindow(1000, 65535).offered_scale(), 0);
+  EXPECT_EQ(ReceiveWindow(1000, 65536).offered_scale(), 1);
+  EXPECT_EQ(ReceiveWindow(1000, 4 * 1024 * 1024).offered_scale(), 7);
+}
+
+TEST(ReceiveWindowTest, UnscaledUntilNegotiated) {
+  ReceiveWindow window(200000, 4 * 1024 * 1024);
+  EXPECT_EQ(window.advertised(), 65535);
+  window.enable_scaling();
+  EXPECT_EQ(window.advertised(), 200000 >> 7);
+}
+
+TEST(ReceiveWindowTest, FollowsFreeSpace) {
+  ReceiveWindow window(20600, 20600);
+  EXPECT_EQ(window.advertised(), 20600);
+  window.on_delivered(600, {}, 0ns);
+  EXPECT_EQ(window.advertised(), 20000);
+  window.set_space(20600);
+  EXPECT_EQ(window.advertised(), 20600);
+  window.on_delivered(30000, {}, 0ns);
+  EXPECT_EQ(window.advertised(), 0);
+}
+
+TEST(ReceiveWindowTest, Autotuning) {
+  ReceiveWindow window(64 * 1024, 1024 * 1024);
+  const auto start = idk::base::RdtscClock::now();
+  window.on_delivered(10, start, 1ms);
+  EXPECT_EQ(window.buffer_target(), 64 * 1024);
+
+  // 100KB within one rtt, the buffer should hold two rtts of that
+  window.set_space(64 * 1024);
+  window.on_delivered(100 * 1024, start + idk::base::RdtscDuration(1ms), 1ms);
+  EXPECT_EQ(window.buffer_target(), 200 * 1024);
+
+  // Capped by the maximum
+  window.on_delivered(1024 * 1024, start + idk::base::RdtscDuration(3ms), 1ms);
+  EXPECT_EQ(window.buffer_target(), 1024 * 1024);
+}
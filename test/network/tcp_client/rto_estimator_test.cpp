@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "network/tcp/rto_estimator.h"
+
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+class RtoEstimatorTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  RtoEstimator estimator;
+};
+
+TEST_F(RtoEstimatorTest, InitialRto) {
+  EXPECT_EQ(estimator.rto(), 1s);
+}
+
+TEST_F(RtoEstimatorTest, FirstSample) {
+  estimator.on_sample(100ms);
+  EXPECT_EQ(estimator.srtt(), 100ms);
+  EXPECT_EQ(estimator.rttvar(), 50ms);
+  EXPECT_EQ(estimator.rto(), 300ms);
+}
+
+TEST_F(RtoEstimatorTest, Smoothing) {
+  estimator.on_sample(100ms);
+  estimator.on_sample(180ms);
+  // rttvar = 3/4 * 50 + 1/4 * 80, srtt = 7/8 * 100 + 1/8 * 180
+  EXPECT_EQ(estimator.rttvar(), 57500us);
+  EXPECT_EQ(estimator.srtt(), 110ms);
+  EXPECT_EQ(estimator.rto(), 340ms);
+}
+
+TEST_F(RtoEstimatorTest, LowerBound) {
+  for (int i = 0; i < 50; ++i) {
+    estimator.on_sample(2ms);
+  }
+  EXPECT_EQ(estimator.rto(), RtoEstimator::kMinRto);
+}
+
+TEST_F(RtoEstimatorTest, BackOff) {
+  estimator.on_sample(100ms);
+  estimator.back_off();
+  EXPECT_EQ(estimator.rto(), 600ms);
+  for (int i = 0; i < 20; ++i) {
+    estimator.back_off();
+  }
+  EXPECT_EQ(estimator.rto(), RtoEstimator::kMaxRto);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "network/tcp/reassembly_queue.h"
+#include "network/tcp/retransmission_queue.h"
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+
+class SackTest : public ::testing::Test {
+protected:
+  // Queues [seq, seq + size)
+  bool
+  insert(uint32_t seq, size_t size) {
+    return reassembly.insert(SeqNumber(seq), {payload.data(), size}, test::received_packet(simulator));
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>>
+  blocks(size_t capacity = kMaxSackBlocks) {
+    std::array<SackBlock, kMaxSackBlocks> out;
+    const size_t size = reassembly.sack_blocks(std::span(out).first(capacity));
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (size_t i = 0; i < size; ++i) {
+      ranges.emplace_back(out[i].left.value().value(), out[i].right.value().value());
+    }
+    return ranges;
+  }
+
+  // Pushes segments of 100 bytes from `seq` on
+  void
+  push(uint32_t seq, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      retransmission.push(SeqNumber(seq + i * 100), 100,
+                          simulator.device(sim::Simulator::kClient).get_send_buffer(), simulator.now());
+    }
+  }
+
+  std::vector<uint32_t>
+  holes() {
+    std::vector<uint32_t> seqs;
+    retransmission.for_each_hole([&](RetransmissionQueue::Segment& segment) { seqs.push_back(segment.seq.value()); });
+    return seqs;
+  }
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  std::vector<uint8_t> payload = std::vector<uint8_t>(1000, 'x');
+  ReassemblyQueue reassembly;
+  RetransmissionQueue retransmission;
+};
+
+using Blocks = std::vector<std::pair<uint32_t, uint32_t>>;
+
+TEST_F(SackTest, AdjacentSegmentsMakeOneBlock) {
+  ASSERT_TRUE(insert(1000, 100));
+  ASSERT_TRUE(insert(1100, 100));
+  ASSERT_TRUE(insert(1150, 100));
+  EXPECT_EQ(blocks(), (Blocks{{1000, 1250}}));
+}
+
+TEST_F(SackTest, LatestBlockFirstThenMostRecent) {
+  ASSERT_TRUE(insert(1000, 100));
+  ASSERT_TRUE(insert(1200, 100));
+  ASSERT_TRUE(insert(1400, 100));
+  EXPECT_EQ(blocks(), (Blocks{{1400, 1500}, {1200, 1300}, {1000, 1100}}));
+
+  // The block which grew moves to the front, the others keep their order
+  ASSERT_TRUE(insert(1100, 50));
+  EXPECT_EQ(blocks(), (Blocks{{1000, 1150}, {1400, 1500}, {1200, 1300}}));
+
+  // A segment received again makes its block the latest too
+  ASSERT_TRUE(insert(1200, 100));
+  EXPECT_EQ(blocks(), (Blocks{{1200, 1300}, {1000, 1150}, {1400, 1500}}));
+}
+
+TEST_F(SackTest, OldestBlocksFallOff) {
+  for (uint32_t seq = 1000; seq < 2000; seq += 200) {
+    ASSERT_TRUE(insert(seq, 100));
+  }
+  EXPECT_EQ(blocks(), (Blocks{{1800, 1900}, {1600, 1700}, {1400, 1500}, {1200, 1300}}));
+  EXPECT_EQ(blocks(2), (Blocks{{1800, 1900}, {1600, 1700}}));
+
+  ASSERT_TRUE(insert(1000, 100));
+  EXPECT_EQ(blocks(3), (Blocks{{1000, 1100}, {1800, 1900}, {1600, 1700}}));
+}
+
+TEST_F(SackTest, NoBlocksWhenEmpty) {
+  EXPECT_TRUE(blocks().empty());
+  EXPECT_EQ(blocks(0).size(), 0);
+}
+
+TEST_F(SackTest, OnSackMarksCoveredSegments) {
+  push(0, 5);
+  EXPECT_FALSE(retransmission.has_sacked());
+  EXPECT_TRUE(retransmission.on_sack(SeqNumber(100), SeqNumber(300)));
+  EXPECT_TRUE(retransmission.has_sacked());
+  // Nothing new
+  EXPECT_FALSE(retransmission.on_sack(SeqNumber(100), SeqNumber(300)));
+  // Only whole segments count
+  EXPECT_FALSE(retransmission.on_sack(SeqNumber(350), SeqNumber(450)));
+  EXPECT_TRUE(retransmission.on_sack(SeqNumber(300), SeqNumber(450)));
+
+  // The acknowledged sacked segments leave the count
+  std::ignore = retransmission.acknowledge(SeqNumber(400), simulator.now());
+  EXPECT_FALSE(retransmission.has_sacked());
+}
+
+TEST_F(SackTest, HolesBelowTheHighestSack) {
+  push(0, 6);
+  ASSERT_TRUE(retransmission.on_sack(SeqNumber(100), SeqNumber(200)));
+  ASSERT_TRUE(retransmission.on_sack(SeqNumber(300), SeqNumber(400)));
+  // Nothing is known of the segments above the highest sacked one
+  EXPECT_EQ(holes(), (std::vector<uint32_t>{0, 200}));
+}
+
+TEST_F(SackTest, HolesArePassedOncePerEpisode) {
+  push(0, 4);
+  ASSERT_TRUE(retransmission.on_sack(SeqNumber(200), SeqNumber(300)));
+  EXPECT_EQ(holes(), (std::vector<uint32_t>{0, 100}));
+  EXPECT_TRUE(holes().empty());
+
+  // A sack uncovering a new hole passes only that one
+  ASSERT_TRUE(retransmission.on_sack(SeqNumber(300), SeqNumber(400)));
+  EXPECT_TRUE(holes().empty());
+  push(400, 2);
+  ASSERT_TRUE(retransmission.on_sack(SeqNumber(500), SeqNumber(600)));
+  EXPECT_EQ(holes(), (std::vector<uint32_t>{400}));
+
+  // The next episode retransmits them again
+  retransmission.reset_holes();
+  EXPECT_EQ(holes(), (std::vector<uint32_t>{0, 100, 400}));
+}
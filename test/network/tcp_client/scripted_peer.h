@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/macros/require.h"
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/tcp/client.h"
+
+namespace idk::net::tcp::test {
+
+// A frame as it went over the wire
+struct Frame {
+  [[nodiscard]] PacketView
+  tcp() {
+    return PacketView(base::MutableByteView{bytes.data(), bytes.size()});
+  }
+
+  [[nodiscard]] std::string
+  payload() {
+    const auto bytes = tcp().payload();
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  }
+
+  std::vector<uint8_t> bytes;
+};
+
+inline const Host kClientHost{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+inline const Host kServerHost{.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")};
+
+// Options of a segment written by the test
+struct SegmentOptions {
+  // The SYN options block, with the mss, window scale and SACK below. Absent options are padded with NOPs.
+  bool syn{false};
+  uint16_t mss{1460};
+  std::optional<uint8_t> window_scale;
+  bool sack_permitted{false};
+  std::optional<Timestamp> timestamp;
+  uint16_t window{65535};
+};
+
+// Builds a segment of `connection` in a buffer of `sender` and sends it
+inline void
+send_segment(dpdk::Sender sender, const Connection& connection, Flags flags, SeqNumber seq, SeqNumber ack,
+             std::string_view payload = {}, const SegmentOptions& options = {}) {
+  auto tx = sender.get_send_buffer();
+  PacketView segment(tx.view());
+  segment.init(connection, flags, seq, ack, options.syn, options.timestamp);
+  if (options.syn) {
+    auto& block = segment.syn_options();
+    block.mss.mss = options.mss;
+    if (options.window_scale) {
+      block.window_scale.shift = options.window_scale.value();
+    } else {
+      std::memset(&block.window_scale, OptionsBlock::kNoOperationByte, sizeof(block.window_scale));
+    }
+    if (!options.sack_permitted) {
+      std::memset(&block.sack_permitted, OptionsBlock::kNoOperationByte, sizeof(block.sack_permitted));
+    }
+    if (!options.timestamp) {
+      std::memset(&block.timestamp, OptionsBlock::kNoOperationByte, sizeof(block.timestamp));
+    }
+  }
+  segment.header().window = options.window;
+  segment.resize_payload(payload.size());
+  std::copy(payload.begin(), payload.end(), segment.payload().begin());
+  segment.update_checksum();
+  segment.ip().update_checksum();
+  sender.send_raw(std::move(tx), segment.eth().raw_bytes().size());
+}
+
+// Writes `bytes` from `client`, in segments of at most `chunk` bytes
+inline void
+send_bytes(Client& client, std::string_view bytes, size_t chunk = SIZE_MAX) {
+  while (!bytes.empty()) {
+    auto packet = client.get_send_buffer(Flags::PSH_ACK);
+    const size_t len = std::min({bytes.size(), chunk, packet.tcp.payload().size()});
+    std::copy_n(bytes.data(), len, packet.tcp.payload().begin());
+    client.send(std::move(packet), len);
+    bytes.remove_prefix(len);
+  }
+}
+
+// Frames `device` received
+inline std::vector<Frame>
+receive_frames(dpdk::Device& device) {
+  std::vector<Frame> frames;
+  auto burst = device.receive_burst();
+  for (size_t i = 0; i < burst.size(); ++i) {
+    const auto bytes = burst.bytes(i);
+    frames.push_back({.bytes = {bytes.begin(), bytes.end()}});
+  }
+  return frames;
+}
+
+// An mbuf received by the client side of `simulator`, for the queues which only hold a reference to their packets.
+// The links must have no delay.
+inline dpdk::RxPacket
+received_packet(sim::Simulator& simulator) {
+  auto sender = simulator.device(sim::Simulator::kServer).get_sender();
+  sender.send_raw(sender.get_send_buffer(), 64);
+  simulator.step(simulator.now());
+  auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+  REQUIRE_EQ(burst.size(), 1, "The frame was not delivered");
+  return burst.take(0);
+}
+
+// A tcp::Client facing a peer scripted by the test through the network simulator: the test writes the segments of
+// the peer by hand and reads the ones the client sent. The links have no delay, time moves only in `advance`.
+class ScriptedPeer {
+public:
+  using time_point = sim::Simulator::time_point;
+
+  static constexpr std::chrono::microseconds kTick{100};
+  static constexpr uint32_t kPeerIss = 1000;
+
+  explicit ScriptedPeer(AckPolicy policy = AckPolicy::Immediate) :
+      simulator({.to_server = {.latency = {}}, .to_client = {.latency = {}}}), timers(kTick, simulator.now()),
+      client(Connection{.session = {.src = kClientHost, .dst = kServerHost},
+                        .src_port = Port(50000),
+                        .dst_port = Port(443)},
+             simulator.device(sim::Simulator::kClient).get_sender(), timers) {
+    client.set_ack_policy(policy);
+    peer = Connection{
+        .session = {.src = kServerHost, .dst = kClientHost}, .src_port = Port(443), .dst_port = Port(50000)};
+    // With the real clock the setup took time already
+    now = simulator.step(simulator.now());
+  }
+
+  // Connects the client, its SYN is answered with `syn_ack`. The SYN is returned.
+  Frame
+  handshake(SegmentOptions syn_ack = {}) {
+    client.connect();
+    auto frames = sent();
+    REQUIRE_EQ(frames.size(), 1, "No SYN");
+    client_seq = frames[0].tcp().header().seq.value() + 1;
+    syn_ack.syn = true;
+    send(Flags::SYN_ACK, SeqNumber(kPeerIss), client_seq, {}, syn_ack);
+    receive();
+    // The ACK of the SYN-ACK
+    std::ignore = sent();
+    return frames[0];
+  }
+
+  // Puts a segment of the peer on the wire
+  void
+  send(Flags flags, SeqNumber seq, SeqNumber ack, std::string_view payload = {}, const SegmentOptions& options = {}) {
+    send_segment(simulator.device(sim::Simulator::kServer).get_sender(), peer, flags, seq, ack, payload, options);
+  }
+
+  // Sends `payload` in sequence and acknowledges everything the client sent
+  void
+  send_data(std::string_view payload, const SegmentOptions& options = {}) {
+    send(Flags::PSH_ACK, peer_seq, client_seq, payload, options);
+    peer_seq += payload.size();
+  }
+
+  // The client handles the segments on the wire as one rx burst and returns the bytes delivered in order. Every packet
+  // is consumed unless `consume` is false, and the burst ends unless `end_burst` is false.
+  std::string
+  receive(bool consume = true, bool end_burst = true) {
+    now = simulator.step(now);
+    std::string delivered;
+    auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      client.set_receive_space(client.receive_buffer_target());
+      client.process_packet(burst.take(i), [&](base::ByteView bytes, const dpdk::RxPacket&) {
+        delivered.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+      });
+      if (consume) {
+        client.on_data_consumed();
+      }
+    }
+    if (end_burst && !burst.empty()) {
+      client.on_burst_end();
+    }
+    return delivered;
+  }
+
+  // Frames the client sent since the last call
+  std::vector<Frame>
+  sent() {
+    now = simulator.step(now);
+    return receive_frames(simulator.device(sim::Simulator::kServer));
+  }
+
+  // Moves the clock and fires the timers which are due
+  void
+  advance(std::chrono::nanoseconds duration) {
+    const auto until = now + base::RdtscDuration(duration);
+    while (now < until) {
+      now = simulator.step(std::min(until, now + base::RdtscDuration(kTick)));
+      timers.advance(now);
+    }
+  }
+
+  sim::Simulator simulator;
+  base::TimerWheel timers;
+  Client client;
+  // The connection as the peer sees it
+  Connection peer;
+  // Next sequence numbers of both sides
+  SeqNumber peer_seq{kPeerIss + 1};
+  SeqNumber client_seq;
+  time_point now;
+};
+
+} // namespace idk::net::tcp::test
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "tcp_pair.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+TEST(SendTest, FullRetransmissionQueueClosesTheWindow) {
+  test::TcpPair pair({.to_server = {.latency = 1ms}, .to_client = {.latency = 1ms}});
+  ASSERT_TRUE(pair.connect());
+
+  // Tiny segments the server does not acknowledge, more than the retransmission queue holds
+  pair.server_reads = false;
+  constexpr size_t kSegments = RetransmissionQueue::kMaxSegments + 44;
+  std::string sent;
+  for (size_t i = 0; i < kSegments; ++i) {
+    sent.push_back(static_cast<char>('a' + i % 26));
+  }
+  EXPECT_NO_THROW(test::send_bytes(pair.client, sent, 1));
+  EXPECT_EQ(pair.client.stats().flight_size, RetransmissionQueue::kMaxSegments);
+  EXPECT_EQ(pair.client.queued_bytes(), kSegments - RetransmissionQueue::kMaxSegments);
+
+  // The blocked bytes follow once the acks free the queue
+  pair.server_reads = true;
+  ASSERT_TRUE(pair.run_until([&] { return pair.server_received.size() == sent.size(); }, 2s));
+  EXPECT_EQ(pair.server_received, sent);
+  EXPECT_EQ(pair.client.get_state(), Client::State::Connected);
+}
+
+TEST(SendTest, TinyPeerMssIsRaised) {
+  test::ScriptedPeer peer;
+  peer.handshake({.mss = 20});
+  const std::string sent(1000, 'x');
+  test::send_bytes(peer.client, sent);
+  auto frames = peer.sent();
+  ASSERT_FALSE(frames.empty());
+  for (auto frame: frames) {
+    EXPECT_LE(frame.payload().size(), Client::kMinMss);
+  }
+  EXPECT_EQ(frames.front().payload().size(), Client::kMinMss);
+}
+
+TEST(SendTest, MovedClientKeepsItsTimers) {
+  test::ScriptedPeer peer(AckPolicy::Delayed);
+  peer.handshake();
+  // Data waiting on the retransmission timer and an ACK on the delayed ack timer
+  test::send_bytes(peer.client, "hello");
+  ASSERT_EQ(peer.sent().size(), 1);
+  peer.send(Flags::PSH_ACK, peer.peer_seq, peer.client_seq, "a");
+  peer.peer_seq += 1;
+  EXPECT_EQ(peer.receive(), "a");
+
+  Client moved(std::move(peer.client));
+  EXPECT_EQ(peer.client.get_state(), Client::State::Offline);
+  EXPECT_EQ(moved.get_state(), Client::State::Connected);
+
+  peer.advance(Client::kDelayedAckTimeout + 1ms);
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "");
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+
+  peer.advance(std::chrono::nanoseconds(moved.stats().rto_ns));
+  frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "hello");
+  EXPECT_EQ(moved.stats().rto_timeouts, 1);
+}
+
+TEST(SendTest, ZeroWindowIsProbedUntilItOpens) {
+  test::ScriptedPeer peer;
+  peer.handshake();
+  test::send_bytes(peer.client, "first");
+  ASSERT_EQ(peer.sent().size(), 1);
+
+  // The peer takes the data, but the application does not read it and the window closes
+  peer.client_seq += 5;
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq, {}, {.window = 0});
+  EXPECT_EQ(peer.receive(), "");
+  EXPECT_EQ(peer.client.stats().send_window, 0);
+  EXPECT_EQ(peer.client.stats().zero_window_stalls, 1);
+  test::send_bytes(peer.client, "second");
+  EXPECT_TRUE(peer.sent().empty());
+  EXPECT_EQ(peer.client.queued_bytes(), 6);
+
+  // Nothing is in flight, the persist timer probes the window with a segment below it
+  const auto rto = std::chrono::nanoseconds(peer.client.stats().rto_ns);
+  peer.advance(rto + 1ms);
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "");
+  EXPECT_EQ(frames[0].tcp().header().seq.value(), peer.client_seq - 1);
+
+  // Still closed, the probes back off and go on without timing the connection out
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq, {}, {.window = 0});
+  EXPECT_EQ(peer.receive(), "");
+  peer.advance(rto + 1ms);
+  EXPECT_TRUE(peer.sent().empty());
+  peer.advance(rto + 1ms);
+  EXPECT_EQ(peer.sent().size(), 1);
+  EXPECT_EQ(peer.client.stats().window_probes, 2);
+  EXPECT_EQ(peer.client.get_state(), Client::State::Connected);
+
+  // The answer to a probe opens the window, the queued data follows
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq, {}, {.window = 1000});
+  EXPECT_EQ(peer.receive(), "");
+  frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].payload(), "second");
+  peer.client_seq += 6;
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq, {}, {.window = 1000});
+  EXPECT_EQ(peer.receive(), "");
+  peer.advance(4 * rto);
+  EXPECT_TRUE(peer.sent().empty());
+  EXPECT_EQ(peer.client.stats().window_probes, 2);
+}
+
+TEST(SendTest, WindowProbeIsAnswered) {
+  test::ScriptedPeer peer;
+  peer.handshake();
+  peer.send(Flags::ACK, SeqNumber(peer.peer_seq.value() - 1), peer.client_seq);
+  EXPECT_EQ(peer.receive(), "");
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().flags, Flags::ACK);
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+  EXPECT_GT(frames[0].tcp().header().window.value(), 0);
+
+  // A pure ACK in the window is not answered
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq);
+  EXPECT_EQ(peer.receive(), "");
+  EXPECT_TRUE(peer.sent().empty());
+}
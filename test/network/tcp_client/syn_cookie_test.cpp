@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "network/tcp/syn_cookie.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+
+class SynCookieTest : public ::testing::Test {
+protected:
+  static SynCookies::time_point
+  at(std::chrono::seconds seconds) {
+    return SynCookies::time_point{} + base::RdtscDuration(seconds);
+  }
+
+  SynCookies cookies{{0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL}};
+  Connection connection{.session = {.src = {.ip = Ip("10.0.0.1")}, .dst = {.ip = Ip("10.0.0.2")}},
+                        .src_port = Port(443),
+                        .dst_port = Port(50000)};
+  SeqNumber peer_isn{123456};
+};
+
+TEST_F(SynCookieTest, RoundTrip) {
+  const auto now = at(std::chrono::seconds(1000));
+  EXPECT_EQ(cookies.decode(connection, peer_isn, cookies.encode(connection, peer_isn, 1460, now), now), 1460);
+  // Rounded down to the table
+  EXPECT_EQ(cookies.decode(connection, peer_isn, cookies.encode(connection, peer_isn, 1400, now), now), 1380);
+  EXPECT_EQ(cookies.decode(connection, peer_isn, cookies.encode(connection, peer_isn, 9000, now), now), 1460);
+  EXPECT_EQ(cookies.decode(connection, peer_isn, cookies.encode(connection, peer_isn, 100, now), now), 536);
+}
+
+TEST_F(SynCookieTest, RejectsForgedAndExpired) {
+  const auto now = at(std::chrono::seconds(1000));
+  const auto cookie = cookies.encode(connection, peer_isn, 1460, now);
+  EXPECT_FALSE(cookies.decode(connection, peer_isn + 1, cookie, now).has_value());
+  EXPECT_FALSE(cookies.decode(connection, peer_isn, cookie + 1, now).has_value());
+  auto other = connection;
+  other.dst_port = Port(50001);
+  EXPECT_FALSE(cookies.decode(other, peer_isn, cookie, now).has_value());
+  EXPECT_FALSE(SynCookies().decode(connection, peer_isn, cookie, now).has_value());
+
+  // Valid during the next period, not after
+  EXPECT_TRUE(cookies.decode(connection, peer_isn, cookie, at(std::chrono::seconds(1000 + 64))).has_value());
+  EXPECT_FALSE(cookies.decode(connection, peer_isn, cookie, at(std::chrono::seconds(1000 + 128))).has_value());
+}
+
+TEST_F(SynCookieTest, OptionsInTimestamp) {
+  const uint32_t clock = 1'000'000;
+  const uint32_t value = SynCookies::encode_options(clock, {.window_scale = 7, .sack_permitted = true});
+  EXPECT_LE(value, clock);
+  EXPECT_GT(value, clock - 64);
+  auto options = SynCookies::decode_options(value);
+  EXPECT_EQ(options.window_scale, 7);
+  EXPECT_TRUE(options.sack_permitted);
+
+  options = SynCookies::decode_options(SynCookies::encode_options(clock, {}));
+  EXPECT_FALSE(options.window_scale.has_value());
+  EXPECT_FALSE(options.sack_permitted);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/tcp/client.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/listener.h"
+
+#include "scripted_peer.h"
+
+namespace idk::net::tcp::test {
+
+// A tcp::Client connected through the network simulator to a passive tcp::Client of our own stack. Both ends append
+// the bytes they receive to `client_received` and `server_received`. Time moves only in `run_for` and `run_until`,
+// in steps of one timer tick.
+class TcpPair {
+public:
+  using time_point = sim::Simulator::time_point;
+
+  static constexpr std::chrono::microseconds kTick{100};
+  inline static const Port kServerPort{443};
+
+  explicit TcpPair(const sim::Simulator::Config& config = {}, AckPolicy client_policy = AckPolicy::Immediate) :
+      simulator(config), timers(kTick, simulator.now()),
+      listener(kServerPort, simulator.device(sim::Simulator::kServer).get_sender()),
+      servers(simulator.device(sim::Simulator::kServer).get_sender()),
+      client(Connection{.session = {.src = kClientHost, .dst = kServerHost},
+                        .src_port = Port(50000),
+                        .dst_port = kServerPort},
+             simulator.device(sim::Simulator::kClient).get_sender(), timers) {
+    client.set_ack_policy(client_policy);
+    servers.listen(listener, [this](const Accepted& accepted) {
+      auto& session = servers.add(accepted.connection, accepted,
+                                  simulator.device(sim::Simulator::kServer).get_sender(), timers);
+      session.set_ack_policy(server_policy);
+    });
+    // With the real clock the setup took time already
+    now = simulator.step(simulator.now());
+  }
+
+  // Runs the handshake, returns false if it did not complete within `limit`
+  bool
+  connect(std::chrono::milliseconds limit = std::chrono::milliseconds(100)) {
+    client.connect();
+    return run_until([this] { return client.get_state() == Client::State::Connected && servers.size() > 0; }, limit);
+  }
+
+  [[nodiscard]] Client&
+  server() {
+    return servers[0];
+  }
+
+  void
+  run_for(std::chrono::nanoseconds duration) {
+    const auto until = now + base::RdtscDuration(duration);
+    while (now < until) {
+      step();
+    }
+  }
+
+  template<typename Done>
+  bool
+  run_until(Done&& done, std::chrono::nanoseconds limit) {
+    const auto until = now + base::RdtscDuration(limit);
+    while (!done()) {
+      if (now >= until) {
+        return false;
+      }
+      step();
+    }
+    return true;
+  }
+
+  sim::Simulator simulator;
+  base::TimerWheel timers;
+  Listener listener;
+  ConnectionManager<Client> servers;
+  Client client;
+  // Set before `connect`
+  AckPolicy server_policy{AckPolicy::Immediate};
+  // While false the server does not look at its queue, nothing it received is acknowledged
+  bool server_reads{true};
+  std::string client_received;
+  std::string server_received;
+  time_point now;
+
+private:
+  void
+  step() {
+    now = simulator.step(now + base::RdtscDuration(kTick));
+    timers.advance(now);
+
+    if (server_reads) {
+      auto burst = simulator.device(sim::Simulator::kServer).receive_burst();
+      std::vector<dpdk::RxPacket> packets;
+      for (size_t i = 0; i < burst.size(); ++i) {
+        packets.push_back(burst.take(i));
+      }
+      servers.process(packets, [this](Client& server, const dpdk::RxPacket& packet) {
+        // The received bytes are consumed at once
+        server.set_receive_space(server.receive_buffer_target());
+        server.process_packet(packet, [this](base::ByteView bytes, const dpdk::RxPacket&) {
+          server_received.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        });
+        server.on_data_consumed();
+      });
+    }
+
+    auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      client.set_receive_space(client.receive_buffer_target());
+      client.process_packet(burst.take(i), [this](base::ByteView bytes, const dpdk::RxPacket&) {
+        client_received.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+      });
+      client.on_data_consumed();
+    }
+    if (!burst.empty()) {
+      client.on_burst_end();
+    }
+  }
+};
+
+} // namespace idk::net::tcp::test
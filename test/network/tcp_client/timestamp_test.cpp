@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "scripted_peer.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::tcp;
+using namespace std::chrono_literals;
+
+namespace {
+
+const Connection kConnection{
+    .session = {.src = test::kClientHost, .dst = test::kServerHost}, .src_port = Port(50000), .dst_port = Port(443)};
+
+// Timestamp of the last frame in `frames`
+Timestamp
+last_timestamp(std::vector<test::Frame> frames) {
+  REQUIRE(!frames.empty(), "No frames");
+  return frames.back().tcp().parse_options().timestamp.value();
+}
+
+} // namespace
+
+TEST(TimestampOptionsTest, AppendixALayout) {
+  std::vector<uint8_t> bytes(1514);
+  PacketView segment(base::MutableByteView{bytes.data(), bytes.size()});
+  segment.init(kConnection, Flags::ACK, SeqNumber(1), SeqNumber(2), false, Timestamp{.value = 123, .echo = 456});
+  ASSERT_EQ(segment.header().data_offset() - sizeof(Header), sizeof(TimestampBlock));
+  const auto options = segment.parse_options();
+  ASSERT_TRUE(options.timestamp.has_value());
+  EXPECT_EQ(options.timestamp->value, 123);
+  EXPECT_EQ(options.timestamp->echo, 456);
+  EXPECT_TRUE(options.sack().empty());
+}
+
+TEST(TimestampOptionsTest, OtherLayoutsTakeTheGeneralPath) {
+  // Twelve bytes of options which are not a timestamp: two NOPs and a SACK block
+  std::vector<uint8_t> bytes(1514);
+  PacketView segment(base::MutableByteView{bytes.data(), bytes.size()});
+  segment.init(kConnection, Flags::ACK, SeqNumber(1), SeqNumber(2));
+  const std::array<SackBlock, 1> blocks{SackBlock{.left = SeqNumber(100), .right = SeqNumber(200)}};
+  segment.append_sack(blocks);
+  ASSERT_EQ(segment.header().data_offset() - sizeof(Header), sizeof(TimestampBlock));
+  auto options = segment.parse_options();
+  EXPECT_FALSE(options.timestamp.has_value());
+  ASSERT_EQ(options.sack().size(), 1);
+  EXPECT_EQ(options.sack()[0].left.value(), SeqNumber(100));
+
+  // A timestamp followed by a SACK block
+  segment.init(kConnection, Flags::ACK, SeqNumber(1), SeqNumber(2), false, Timestamp{.value = 7, .echo = 8});
+  segment.append_sack(blocks);
+  options = segment.parse_options();
+  ASSERT_TRUE(options.timestamp.has_value());
+  EXPECT_EQ(options.timestamp->value, 7);
+  EXPECT_EQ(options.timestamp->echo, 8);
+  EXPECT_EQ(options.sack().size(), 1);
+}
+
+class TimestampTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kPeerClock = 1000;
+
+  void
+  SetUp() override {
+    auto syn = peer.handshake({.timestamp = Timestamp{.value = kPeerClock}});
+    client_clock = syn.tcp().parse_options().timestamp.value().value;
+  }
+
+  // Sends `payload` in sequence with the peer's timestamp `value`
+  void
+  send_data(std::string_view payload, uint32_t value) {
+    peer.send_data(payload, {.timestamp = Timestamp{.value = value, .echo = client_clock}});
+  }
+
+  test::ScriptedPeer peer;
+  uint32_t client_clock{0};
+};
+
+TEST_F(TimestampTest, PawsDropsOldSegments) {
+  send_data("new", kPeerClock + 10);
+  EXPECT_EQ(peer.receive(), "new");
+  EXPECT_EQ(last_timestamp(peer.sent()).echo, kPeerClock + 10);
+
+  // A segment with an older timestamp is a duplicate of an earlier wrap, it is dropped and answered with an ACK
+  peer.send(Flags::PSH_ACK, peer.peer_seq, peer.client_seq, "old",
+            {.timestamp = Timestamp{.value = kPeerClock + 5, .echo = client_clock}});
+  EXPECT_EQ(peer.receive(), "");
+  EXPECT_EQ(peer.client.stats().paws_drops, 1);
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames[0].tcp().header().ack.value(), peer.peer_seq);
+
+  send_data("next", kPeerClock + 20);
+  EXPECT_EQ(peer.receive(), "next");
+}
+
+TEST_F(TimestampTest, TsRecentFollowsOnlyInSequenceSegments) {
+  send_data("a", kPeerClock + 10);
+  EXPECT_EQ(peer.receive(), "a");
+  EXPECT_EQ(last_timestamp(peer.sent()).echo, kPeerClock + 10);
+
+  // Out of order, beyond the last ACK sent: the timestamp is not taken
+  peer.send(Flags::PSH_ACK, peer.peer_seq + 1, peer.client_seq, "c",
+            {.timestamp = Timestamp{.value = kPeerClock + 50, .echo = client_clock}});
+  EXPECT_EQ(peer.receive(), "");
+  EXPECT_EQ(last_timestamp(peer.sent()).echo, kPeerClock + 10);
+
+  // The segment filling the hole starts at the last ACK sent, its timestamp is echoed
+  send_data("b", kPeerClock + 30);
+  EXPECT_EQ(peer.receive(), "bc");
+  EXPECT_EQ(last_timestamp(peer.sent()).echo, kPeerClock + 30);
+}
+
+TEST_F(TimestampTest, RttFromTheEcho) {
+  test::send_bytes(peer.client, "request");
+  auto frames = peer.sent();
+  ASSERT_EQ(frames.size(), 1);
+  const uint32_t sent_at = last_timestamp(frames).value;
+  const auto srtt = std::chrono::nanoseconds(peer.client.stats().srtt_ns);
+
+  // The echo, not the time the ACK took, gives the sample: an echo 50ms old means an rtt of 50ms
+  peer.send(Flags::ACK, peer.peer_seq, peer.client_seq + 7, {},
+            {.timestamp = Timestamp{.value = kPeerClock + 10, .echo = sent_at - 50'000}});
+  std::ignore = peer.receive();
+  const auto expected = srtt * 7 / 8 + 50ms / 8;
+  const auto smoothed = std::chrono::nanoseconds(peer.client.stats().srtt_ns);
+  EXPECT_GE(smoothed, expected - 1us);
+  EXPECT_LT(smoothed, expected + 1ms);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/sim/tls_server.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/listener.h"
+#include "network/tls12/client.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::string kHost = "simulated.server";
+
+// A tls12::Client connected through the network simulator to a sim::TlsServer. After the handshake the client
+// decrypts the records inside the mbufs they arrived in.
+class TlsPair {
+public:
+  static constexpr std::chrono::microseconds kTick{100};
+  inline static const Port kServerPort{443};
+
+  explicit TlsPair(size_t held_mbufs = 256) :
+      simulator({.to_server = {.latency = 1ms}, .to_client = {.latency = 1ms}}), timers(kTick, simulator.now()),
+      listener(kServerPort, simulator.device(sim::Simulator::kServer).get_sender()),
+      servers(simulator.device(sim::Simulator::kServer).get_sender()) {
+    servers.listen(listener, [this](const tcp::Accepted& accepted) {
+      servers.add(accepted.connection, kHost,
+                  tcp::Client(accepted, simulator.device(sim::Simulator::kServer).get_sender(), timers));
+    });
+    tcp::Client tcp(Connection{.session = {.src = {.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")},
+                                           .dst = {.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")}},
+                               .src_port = Port(50000),
+                               .dst_port = kServerPort},
+                    simulator.device(sim::Simulator::kClient).get_sender(), timers);
+    client.emplace(kHost, std::move(tcp), held_mbufs);
+    now = simulator.step(simulator.now());
+  }
+
+  [[nodiscard]] sim::TlsServer&
+  server() {
+    return servers[0];
+  }
+
+  bool
+  handshake() {
+    return run_until([this] { return client->is_handshake_complete() && server().is_handshake_complete(); }, 1s);
+  }
+
+  template<typename Done>
+  bool
+  run_until(Done&& done, std::chrono::nanoseconds limit) {
+    const auto until = now + base::RdtscDuration(limit);
+    while (!done()) {
+      if (now >= until) {
+        return false;
+      }
+      step();
+    }
+    return true;
+  }
+
+  sim::Simulator simulator;
+  base::TimerWheel timers;
+  tcp::Listener listener;
+  tcp::ConnectionManager<sim::TlsServer> servers;
+  std::optional<tls12::Client> client;
+  // Sent by the server in the flight which completes its handshake, behind its Finished
+  std::string early;
+  // While false the application leaves the records in the receive buffer
+  bool client_reads{true};
+  std::vector<std::string> records;
+  sim::Simulator::time_point now;
+
+private:
+  void
+  step() {
+    now = simulator.step(now + base::RdtscDuration(kTick));
+    timers.advance(now);
+
+    auto server_burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    std::vector<dpdk::RxPacket> packets;
+    for (size_t i = 0; i < server_burst.size(); ++i) {
+      packets.push_back(server_burst.take(i));
+    }
+    servers.process(packets, [this](sim::TlsServer& server, const dpdk::RxPacket& packet) {
+      // Corked, the Finished and what follows it share segments
+      tcp::Cork cork(server.tcp());
+      const bool complete = server.is_handshake_complete();
+      server.process_packet(packet, [](base::ByteView) {});
+      if (!complete && server.is_handshake_complete() && !early.empty()) {
+        server.send({reinterpret_cast<const uint8_t*>(early.data()), early.size()});
+      }
+      cork.uncork();
+    });
+
+    auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      client->process_packet(burst.take(i));
+      // The handshake goes on in `receive`
+      if (client_reads || !client->is_handshake_complete()) {
+        while (const auto record = client->receive()) {
+          records.emplace_back(reinterpret_cast<const char*>(record->data()), record->size());
+        }
+      }
+      client->on_data_consumed();
+    }
+    if (!burst.empty()) {
+      client->on_burst_end();
+    }
+  }
+};
+
+std::string
+pattern(size_t size, char first) {
+  std::string bytes(size, 0);
+  for (size_t i = 0; i < size; ++i) {
+    bytes[i] = static_cast<char>(first + i % 23);
+  }
+  return bytes;
+}
+
+std::string
+joined(const std::vector<std::string>& records) {
+  std::string bytes;
+  for (const auto& record: records) {
+    bytes += record;
+  }
+  return bytes;
+}
+
+} // namespace
+
+// Several small records share a segment, the larger ones span several and are linearised
+TEST(TlsZeroCopyTest, RecordsAcrossSegments) {
+  TlsPair pair;
+  ASSERT_TRUE(pair.handshake());
+  std::string sent;
+  for (const size_t size: {1, 100, 3000, 16384, 5, 5000, 16384, 7}) {
+    const auto message = pattern(size, static_cast<char>('a' + sent.size() % 13));
+    pair.server().send({reinterpret_cast<const uint8_t*>(message.data()), message.size()});
+    sent += message;
+  }
+  ASSERT_TRUE(pair.run_until([&] { return joined(pair.records).size() >= sent.size(); }, 1s));
+  EXPECT_EQ(joined(pair.records), sent);
+  // One record per write, at most 16k each
+  EXPECT_EQ(pair.records.size(), 8);
+  EXPECT_EQ(pair.records[3].size(), 16384);
+}
+
+// The segment which completes the handshake carries the start of a record as well: it is left in the handshake
+// stream and handed over to the zero-copy buffer without a copy, the rest of the record follows in the mbufs
+TEST(TlsZeroCopyTest, RecordBehindTheFinishedIsHandedOver) {
+  TlsPair pair;
+  pair.early = pattern(16384, 'A');
+  ASSERT_TRUE(pair.handshake());
+  ASSERT_TRUE(pair.run_until([&] { return !pair.records.empty(); }, 1s));
+  EXPECT_EQ(joined(pair.records), pair.early);
+
+  const auto next = pattern(2000, 'k');
+  pair.server().send({reinterpret_cast<const uint8_t*>(next.data()), next.size()});
+  ASSERT_TRUE(pair.run_until([&] { return pair.records.size() == 2; }, 1s));
+  EXPECT_EQ(pair.records[1], next);
+}
+
+// The records held by an application which does not read close the window once they pin the connection's share of
+// the pool
+TEST(TlsZeroCopyTest, HeldMbufsCloseTheWindow) {
+  TlsPair pair(tls12::Client::kMinHeldMbufs);
+  ASSERT_TRUE(pair.handshake());
+  pair.client_reads = false;
+  std::string sent;
+  for (size_t i = 0; i < 64; ++i) {
+    const auto message = pattern(1000, static_cast<char>('a' + i % 13));
+    pair.server().send({reinterpret_cast<const uint8_t*>(message.data()), message.size()});
+    sent += message;
+  }
+  pair.run_until([] { return false; }, 50ms);
+  EXPECT_GT(pair.server().tcp().stats().zero_window_stalls, 0);
+  EXPECT_TRUE(pair.records.empty());
+
+  // The next window probe finds the application reading, which frees the mbufs: the window opens and everything
+  // arrives
+  pair.client_reads = true;
+  ASSERT_TRUE(pair.run_until([&] { return joined(pair.records).size() >= sent.size(); }, 5s));
+  EXPECT_EQ(joined(pair.records), sent);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network/eth_ip/checksum.h"
+#include "network/eth_ip/ip.h"
+#include "network/sim/simulator.h"
+#include "network/udp/multicast.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::udp;
+
+class MulticastTest : public ::testing::Test {
+protected:
+  // Frames the membership sent
+  std::vector<std::vector<uint8_t>>
+  sent() {
+    simulator.step(simulator.now());
+    std::vector<std::vector<uint8_t>> frames;
+    auto burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      const auto bytes = burst.bytes(i);
+      frames.emplace_back(bytes.begin(), bytes.end());
+    }
+    return frames;
+  }
+
+  // Checks the ip header of an IGMP frame sent to `dst` and returns the message
+  template<typename Message>
+  static Message
+  message(std::vector<uint8_t>& frame, Ip dst) {
+    IPPacketView ip(base::MutableByteView{frame.data(), frame.size()});
+    EXPECT_TRUE(ip.is_valid());
+    EXPECT_EQ(ip.eth().header().dst_mac, MulticastMembership::group_mac(dst));
+    const auto& header = ip.header();
+    EXPECT_EQ(header.src_addr, kLocalHost.ip);
+    EXPECT_EQ(header.dst_addr, dst);
+    EXPECT_EQ(header.protocol, IpProtocol::Igmp);
+    EXPECT_EQ(header.ttl, 1);
+    EXPECT_TRUE(is_checksum_valid(checksum_add({reinterpret_cast<const uint8_t*>(&header), header.size()})));
+
+    // Router Alert follows the fixed header
+    EXPECT_EQ(header.size(), sizeof(IpHeader) + sizeof(RouterAlertOption));
+    const auto* option = reinterpret_cast<const uint8_t*>(&header) + sizeof(IpHeader);
+    EXPECT_EQ(std::vector<uint8_t>(option, option + sizeof(RouterAlertOption)), (std::vector<uint8_t>{0x94, 4, 0, 0}));
+
+    const auto payload = ip.payload();
+    EXPECT_EQ(payload.size(), sizeof(Message));
+    EXPECT_TRUE(is_checksum_valid(checksum_add(payload)));
+    Message message;
+    std::memcpy(&message, payload.data(), std::min(payload.size(), sizeof(Message)));
+    return message;
+  }
+
+  static inline const Host kLocalHost{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+  static inline const Ip kGroup{"239.1.2.3"};
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  dpdk::Sender sender = simulator.device(sim::Simulator::kClient).get_sender();
+};
+
+TEST_F(MulticastTest, GroupMac) {
+  EXPECT_EQ(MulticastMembership::group_mac(Ip("239.1.2.3")), Mac("01:00:5e:01:02:03"));
+  // Only the low 23 bits are mapped
+  EXPECT_EQ(MulticastMembership::group_mac(Ip("224.129.2.3")), Mac("01:00:5e:01:02:03"));
+  EXPECT_EQ(MulticastMembership::group_mac(Ip("224.0.0.22")), Mac("01:00:5e:00:00:16"));
+}
+
+TEST_F(MulticastTest, IsMulticast) {
+  EXPECT_TRUE(MulticastMembership::is_multicast(Ip("224.0.0.1")));
+  EXPECT_TRUE(MulticastMembership::is_multicast(Ip("239.255.255.255")));
+  EXPECT_FALSE(MulticastMembership::is_multicast(Ip("223.255.255.255")));
+  EXPECT_FALSE(MulticastMembership::is_multicast(Ip("240.0.0.1")));
+  EXPECT_FALSE(MulticastMembership::is_multicast(Ip("10.0.0.1")));
+}
+
+TEST_F(MulticastTest, V2ReportAndLeave) {
+  MulticastMembership membership(kLocalHost, sender, IgmpVersion::V2);
+  membership.join(kGroup);
+  EXPECT_TRUE(membership.is_member(kGroup));
+  auto frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  auto report = message<IgmpV2Message>(frames[0], kGroup);
+  EXPECT_EQ(report.type, IgmpType::V2MembershipReport);
+  EXPECT_EQ(report.max_response_time, 0);
+  EXPECT_EQ(report.group, kGroup);
+
+  // Joined already
+  membership.join(kGroup);
+  EXPECT_TRUE(sent().empty());
+
+  // Leaves go to all routers
+  membership.leave(kGroup);
+  EXPECT_FALSE(membership.is_member(kGroup));
+  frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  auto leave = message<IgmpV2Message>(frames[0], Ip("224.0.0.2"));
+  EXPECT_EQ(leave.type, IgmpType::V2LeaveGroup);
+  EXPECT_EQ(leave.group, kGroup);
+
+  membership.leave(kGroup);
+  EXPECT_TRUE(sent().empty());
+}
+
+TEST_F(MulticastTest, V3ReportAndLeave) {
+  const Ip routers("224.0.0.22");
+  MulticastMembership membership(kLocalHost, sender);
+  membership.join(kGroup);
+  auto frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  auto report = message<IgmpV3Report>(frames[0], routers);
+  EXPECT_EQ(report.type, IgmpType::V3MembershipReport);
+  EXPECT_EQ(report.records.value(), 1);
+  EXPECT_EQ(report.record.type, IgmpV3RecordType::ChangeToExcludeMode);
+  EXPECT_EQ(report.record.aux_data_len, 0);
+  EXPECT_EQ(report.record.sources.value(), 0);
+  EXPECT_EQ(report.record.group, kGroup);
+
+  membership.leave(kGroup);
+  frames = sent();
+  ASSERT_EQ(frames.size(), 1);
+  auto leave = message<IgmpV3Report>(frames[0], routers);
+  EXPECT_EQ(leave.record.type, IgmpV3RecordType::ChangeToIncludeMode);
+  EXPECT_EQ(leave.record.group, kGroup);
+}
+
+TEST_F(MulticastTest, DestructorLeavesTheGroups) {
+  {
+    MulticastMembership membership(kLocalHost, sender, IgmpVersion::V2);
+    membership.join(kGroup);
+    membership.join(Ip("239.1.2.4"));
+    EXPECT_EQ(sent().size(), 2);
+  }
+  auto frames = sent();
+  ASSERT_EQ(frames.size(), 2);
+  EXPECT_EQ(message<IgmpV2Message>(frames[0], Ip("224.0.0.2")).group, kGroup);
+  EXPECT_EQ(message<IgmpV2Message>(frames[1], Ip("224.0.0.2")).group, Ip("239.1.2.4"));
+}
+
+TEST_F(MulticastTest, JoinChecks) {
+  MulticastMembership membership(kLocalHost, sender);
+  EXPECT_THROW(membership.join(Ip("10.0.0.2")), std::runtime_error);
+  for (size_t i = 0; i < MulticastMembership::kMaxGroups; ++i) {
+    membership.join(Ip("239.0.0." + std::to_string(i)));
+  }
+  EXPECT_THROW(membership.join(kGroup), std::runtime_error);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "network/eth_ip/checksum.h"
+#include "network/udp/packet_view.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::udp;
+
+class UdpPacketViewTest : public ::testing::Test {
+protected:
+  // Builds a datagram carrying `payload` at the start of `frame`
+  PacketView
+  build(std::string_view payload) {
+    PacketView datagram(base::MutableByteView{frame.data(), frame.size()});
+    datagram.init(kConnection);
+    datagram.resize_payload(payload.size());
+    std::copy(payload.begin(), payload.end(), datagram.payload().begin());
+    datagram.update_checksum();
+    datagram.ip().update_checksum();
+    return datagram;
+  }
+
+  // The view a receiver has of the first `size` bytes of `frame`
+  PacketView
+  received(size_t size) {
+    return PacketView(base::MutableByteView{frame.data(), size});
+  }
+
+  const Connection kConnection{.session = {.src = {.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")},
+                                           .dst = {.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")}},
+                               .src_port = Port(40000),
+                               .dst_port = Port(5000)};
+
+  std::vector<uint8_t> frame = std::vector<uint8_t>(1514);
+};
+
+TEST_F(UdpPacketViewTest, Build) {
+  auto datagram = build("hello");
+  EXPECT_EQ(datagram.eth().raw_bytes().size(), PacketView::predict_size(5));
+  EXPECT_EQ(datagram.header().src_port, Port(40000));
+  EXPECT_EQ(datagram.header().dst_port, Port(5000));
+  EXPECT_EQ(datagram.header().length.value(), sizeof(Header) + 5);
+  EXPECT_EQ(datagram.ip().header().protocol, IpProtocol::Udp);
+
+  const auto view = received(PacketView::predict_size(5));
+  ASSERT_TRUE(view.is_valid());
+  const auto payload = view.payload();
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(payload.data()), payload.size()), "hello");
+
+  const auto& ip = view.ip().header();
+  const auto udp = base::ByteView(reinterpret_cast<const uint8_t*>(&view.header()), sizeof(Header) + 5);
+  const auto pseudo_header =
+      pseudo_header_sum(ip.src_addr, ip.dst_addr, static_cast<uint8_t>(IpProtocol::Udp), udp.size());
+  EXPECT_TRUE(is_checksum_valid(checksum_add(udp, pseudo_header)));
+}
+
+TEST_F(UdpPacketViewTest, PaddedFrame) {
+  // A short frame is padded to the ethernet minimum, the lengths in the headers tell the payload
+  build("hi");
+  const auto view = received(60);
+  ASSERT_TRUE(view.is_valid());
+  EXPECT_EQ(view.payload().size(), 2);
+}
+
+TEST_F(UdpPacketViewTest, LengthBelowTheHeader) {
+  auto datagram = build("hello");
+  datagram.header().length = sizeof(Header) - 1;
+  EXPECT_FALSE(received(PacketView::predict_size(5)).is_valid());
+}
+
+TEST_F(UdpPacketViewTest, LengthBeyondTheIpPayload) {
+  auto datagram = build("hello");
+  datagram.header().length = sizeof(Header) + 6;
+  EXPECT_FALSE(received(PacketView::predict_size(5)).is_valid());
+
+  // Shorter than the ip payload is fine, the rest is not part of the datagram
+  datagram.header().length = sizeof(Header) + 3;
+  const auto view = received(PacketView::predict_size(5));
+  ASSERT_TRUE(view.is_valid());
+  EXPECT_EQ(view.payload().size(), 3);
+}
+
+TEST_F(UdpPacketViewTest, IpPayloadShorterThanTheHeader) {
+  auto datagram = build("");
+  datagram.ip().header().total_length = sizeof(IpHeader) + sizeof(Header) - 1;
+  EXPECT_FALSE(received(60).is_valid());
+}
+
+TEST_F(UdpPacketViewTest, TruncatedFrame) {
+  build(std::string(100, 'x'));
+  // The frame ends before the ip packet does
+  EXPECT_FALSE(received(PacketView::predict_size(100) - 10).is_valid());
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "network/sim/simulator.h"
+#include "network/udp/receiver.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace idk::net::udp;
+
+class ReceiverTest : public ::testing::Test {
+protected:
+  ReceiverTest() {
+    receiver.subscribe(Port(5000), [this](const PacketView& datagram) {
+      const auto payload = datagram.payload();
+      delivered.emplace_back(reinterpret_cast<const char*>(payload.data()), payload.size());
+    });
+  }
+
+  // A datagram with `payload` to `dst`:`dst_port`
+  PacketView
+  datagram(Ip dst, uint16_t dst_port, std::string_view payload = "data") {
+    auto& frame = frames.emplace_back(1514);
+    PacketView datagram(base::MutableByteView{frame.data(), frame.size()});
+    datagram.init(Connection{.session = {.src = {.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")},
+                                         .dst = {.mac = MulticastMembership::group_mac(dst), .ip = dst}},
+                             .src_port = Port(40000),
+                             .dst_port = Port(dst_port)});
+    datagram.resize_payload(payload.size());
+    std::copy(payload.begin(), payload.end(), datagram.payload().begin());
+    return PacketView(base::MutableByteView{frame.data(), PacketView::predict_size(payload.size())});
+  }
+
+  static inline const Ip kUnicast{"10.0.0.1"};
+  static inline const Ip kGroup{"239.1.2.3"};
+
+  std::vector<std::vector<uint8_t>> frames;
+  std::vector<std::string> delivered;
+  Receiver receiver;
+};
+
+TEST_F(ReceiverTest, DeliversBySubscribedPort) {
+  EXPECT_TRUE(receiver.process_packet(datagram(kUnicast, 5000, "first")));
+  EXPECT_FALSE(receiver.process_packet(datagram(kUnicast, 5001, "other")));
+  EXPECT_EQ(delivered, (std::vector<std::string>{"first"}));
+  EXPECT_EQ(receiver.dropped(), 1);
+}
+
+TEST_F(ReceiverTest, OnePortOneSubscriber) {
+  EXPECT_THROW(receiver.subscribe(Port(5000), [](const PacketView&) {}), std::runtime_error);
+}
+
+TEST_F(ReceiverTest, InvalidDatagramsAreDropped) {
+  auto invalid = datagram(kUnicast, 5000);
+  invalid.header().length = 4;
+  EXPECT_FALSE(receiver.process_packet(invalid));
+  EXPECT_TRUE(delivered.empty());
+  EXPECT_EQ(receiver.dropped(), 1);
+}
+
+TEST_F(ReceiverTest, GroupsAreFilteredByMembership) {
+  // Without a membership every group is taken
+  EXPECT_TRUE(receiver.process_packet(datagram(Ip("239.9.9.9"), 5000)));
+
+  sim::Simulator simulator{{.to_server = {.latency = {}}, .to_client = {.latency = {}}}};
+  MulticastMembership membership({.mac = Mac("02:00:00:00:00:01"), .ip = kUnicast},
+                                 simulator.device(sim::Simulator::kClient).get_sender());
+  membership.join(kGroup);
+  receiver.set_membership(membership);
+  EXPECT_TRUE(receiver.process_packet(datagram(kGroup, 5000, "joined")));
+  EXPECT_FALSE(receiver.process_packet(datagram(Ip("239.9.9.9"), 5000, "not joined")));
+  // Unicast is not filtered
+  EXPECT_TRUE(receiver.process_packet(datagram(kUnicast, 5000, "unicast")));
+  EXPECT_EQ(delivered, (std::vector<std::string>{"data", "joined", "unicast"}));
+  EXPECT_EQ(receiver.dropped(), 1);
+
+  membership.leave(kGroup);
+  EXPECT_FALSE(receiver.process_packet(datagram(kGroup, 5000)));
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/sim/tls_server.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/listener.h"
+#include "network/wss/connection_pool.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::string kHost = "simulated.server";
+const Host kClientHost{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+const Host kServerHost{.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")};
+
+// A wss::ConnectionPool of one stream connected through the network simulator to sim::TlsServers, which answer the
+// upgrade request and publish the messages of the test on every upgraded connection
+class PoolTest : public ::testing::Test {
+protected:
+  using time_point = sim::Simulator::time_point;
+
+  static constexpr std::chrono::microseconds kTick{100};
+  // Each sim::TlsServer generates its rsa key when it accepts, which takes a while on the real clock
+  static constexpr std::chrono::seconds kLimit{10};
+  static constexpr std::chrono::milliseconds kRetryBackoff{50};
+  inline static const Port kServerPort{443};
+  inline static const Port kFirstPort{50000};
+  inline static const Endpoint kRemote{.ip = kServerHost.ip, .port = kServerPort};
+
+  PoolTest() :
+      simulator({.to_server = {.latency = 1ms}, .to_client = {.latency = 1ms}}), timers(kTick, simulator.now()),
+      listener(kServerPort, simulator.device(sim::Simulator::kServer).get_sender()),
+      servers(simulator.device(sim::Simulator::kServer).get_sender()),
+      ports({{dpdk::Rss::kDefaultKey.begin(), dpdk::Rss::kDefaultKey.end()}, dpdk::Rss::spread(128, 1)}),
+      connections(simulator.device(sim::Simulator::kClient).get_sender()) {
+    servers.listen(listener, [this](const tcp::Accepted& accepted) {
+      accepted_by_port[accepted.connection.dst_port.value()] = accepted.connection;
+      servers.add(accepted.connection, kHost,
+                  tcp::Client(accepted, simulator.device(sim::Simulator::kServer).get_sender(), timers));
+    });
+    now = simulator.step(simulator.now());
+  }
+
+  // The stream's first connection goes out from kFirstPort, the others from allocated ports
+  void
+  start(size_t standby, std::chrono::milliseconds setup_timeout = 5s) {
+    wss::ConnectionPool::Config config{.standby = standby, .setup_timeout = setup_timeout};
+    config.connect.retry_backoff = kRetryBackoff;
+    pool.emplace(config,
+                 Connection{.session = {.src = kClientHost, .dst = kServerHost}, .dst_port = kServerPort},
+                 0,
+                 ports,
+                 connections,
+                 [this](const Connection& next) {
+                   opened_ports.push_back(next.src_port);
+                   return tcp::Client(next, simulator.device(sim::Simulator::kClient).get_sender(), timers);
+                 });
+    ports.reserve(kClientHost.ip, kRemote, kFirstPort);
+    pool->add_stream({.host = kHost, .path = "/stream"}, {R"({"subscribe":"trades"})"}, kFirstPort);
+  }
+
+  // The server sends `text` on every connection it upgraded
+  void
+  publish(std::string_view text) {
+    std::vector<uint8_t> frame{0x81, static_cast<uint8_t>(text.size())};
+    frame.insert(frame.end(), text.begin(), text.end());
+    for (auto& [port, server]: upgraded) {
+      server->send({frame.data(), frame.size()});
+    }
+  }
+
+  // The server aborts the connection from the client's `port`, its destructor sends a RST
+  void
+  reset(Port port) {
+    upgraded.erase(port.value());
+    servers.remove(accepted_by_port.at(port.value()));
+  }
+
+  [[nodiscard]] Port
+  active_port() const {
+    return pool->active(0)->get_connection().src_port;
+  }
+
+  // Whether `port` is free again in the allocator, a port still in use throws
+  [[nodiscard]] bool
+  released(Port port) {
+    try {
+      ports.reserve(kClientHost.ip, kRemote, port);
+    } catch (const std::runtime_error&) {
+      return false;
+    }
+    ports.release(port);
+    return true;
+  }
+
+  template<typename Done>
+  bool
+  run_until(Done&& done, std::chrono::nanoseconds limit) {
+    const auto until = now + base::RdtscDuration(limit);
+    while (!done()) {
+      if (now >= until) {
+        return false;
+      }
+      step();
+    }
+    return true;
+  }
+
+  sim::Simulator simulator;
+  base::TimerWheel timers;
+  tcp::Listener listener;
+  tcp::ConnectionManager<sim::TlsServer> servers;
+  tcp::PortAllocator ports;
+  wss::ConnectionPool::Connections connections;
+  std::optional<wss::ConnectionPool> pool;
+  // While false the server does not look at its queue, the peer never answers
+  bool server_reads{true};
+  // By the client's source port
+  std::map<uint16_t, Connection> accepted_by_port;
+  std::map<uint16_t, sim::TlsServer*> upgraded;
+  // Source ports of the connections in the order the pool opened them
+  std::vector<Port> opened_ports;
+  // Handed to the application, only the active connection's
+  std::vector<std::string> messages;
+  time_point now;
+
+private:
+  void
+  step() {
+    now = simulator.step(now + base::RdtscDuration(kTick));
+    timers.advance(now);
+
+    auto server_burst = simulator.device(sim::Simulator::kServer).receive_burst();
+    std::vector<dpdk::RxPacket> packets;
+    for (size_t i = 0; server_reads && i < server_burst.size(); ++i) {
+      packets.push_back(server_burst.take(i));
+    }
+    servers.process(packets, [this](sim::TlsServer& server, const dpdk::RxPacket& packet) {
+      server.process_packet(packet, [&](base::ByteView bytes) {
+        const std::string_view request(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        if (request.starts_with("GET ")) {
+          static constexpr std::string_view kResponse = "HTTP/1.1 101 Switching Protocols\r\n"
+                                                        "Upgrade: websocket\r\n"
+                                                        "Connection: Upgrade\r\n\r\n";
+          server.send({reinterpret_cast<const uint8_t*>(kResponse.data()), kResponse.size()});
+          upgraded[server.tcp().get_connection().dst_port.value()] = &server;
+        }
+      });
+    });
+
+    auto burst = simulator.device(sim::Simulator::kClient).receive_burst();
+    packets.clear();
+    for (size_t i = 0; i < burst.size(); ++i) {
+      packets.push_back(burst.take(i));
+    }
+    connections.process(packets, [this](wss::ConnectionPool::Session& session, const dpdk::RxPacket& packet) {
+      pool->process_packet(session, packet, [this](uint32_t, base::ByteView payload) {
+        messages.emplace_back(reinterpret_cast<const char*>(payload.data()), payload.size());
+      });
+    });
+    pool->poll(now);
+  }
+};
+
+} // namespace
+
+// The oldest ready standby takes over from a reset active connection at once, and a replacement is built from a
+// fresh port
+TEST_F(PoolTest, FailoverToTheOldestStandby) {
+  start(2);
+  ASSERT_TRUE(run_until([this] { return pool->stats().ready == 3 && upgraded.size() == 3; }, kLimit));
+  ASSERT_NE(pool->active(0), nullptr);
+  publish("a");
+  ASSERT_TRUE(run_until([this] { return !messages.empty(); }, kLimit));
+
+  const Port failed = active_port();
+  ASSERT_EQ(opened_ports.size(), 3);
+  const Port oldest = opened_ports[0] != failed ? opened_ports[0] : opened_ports[1];
+  reset(failed);
+  ASSERT_TRUE(run_until([this] { return pool->stats().failovers == 1; }, kLimit));
+  EXPECT_EQ(active_port(), oldest);
+  EXPECT_EQ(pool->stats().outages, 0);
+  EXPECT_EQ(pool->streams_up(), 1);
+
+  // The next poll drops the failed connection and gives its port back
+  ASSERT_TRUE(run_until([&] { return released(failed); }, kLimit));
+  publish("b");
+  ASSERT_TRUE(run_until([this] { return messages.size() == 2; }, kLimit));
+  EXPECT_EQ(messages, (std::vector<std::string>{"a", "b"}));
+
+  ASSERT_TRUE(run_until([this] { return pool->stats().ready == 4; }, kLimit));
+  EXPECT_EQ(pool->stats().opened, 4);
+  EXPECT_EQ(pool->stats().failed, 1);
+  EXPECT_EQ(opened_ports.size(), 4);
+  // The replacement is a standby
+  EXPECT_EQ(active_port(), oldest);
+}
+
+// Without a standby the stream is down until the replacement is ready
+TEST_F(PoolTest, OutageUntilTheReplacementIsReady) {
+  start(0);
+  ASSERT_TRUE(run_until([this] { return pool->active(0) != nullptr && !upgraded.empty(); }, kLimit));
+  EXPECT_EQ(pool->streams_up(), 1);
+
+  reset(kFirstPort);
+  ASSERT_TRUE(run_until([this] { return pool->stats().outages == 1; }, kLimit));
+  EXPECT_EQ(pool->active(0), nullptr);
+  EXPECT_EQ(pool->streams_up(), 0);
+  EXPECT_EQ(pool->stats().failovers, 0);
+
+  // The failed connection was ready, the replacement does not back off
+  ASSERT_TRUE(run_until([this] { return pool->active(0) != nullptr && !upgraded.empty(); }, kLimit));
+  EXPECT_TRUE(released(kFirstPort));
+  EXPECT_NE(active_port(), kFirstPort);
+  EXPECT_EQ(pool->streams_up(), 1);
+  EXPECT_EQ(pool->stats().opened, 2);
+  EXPECT_EQ(pool->stats().ready, 2);
+  EXPECT_EQ(pool->stats().outages, 1);
+
+  publish("a");
+  ASSERT_TRUE(run_until([this] { return !messages.empty(); }, kLimit));
+  EXPECT_EQ(messages, std::vector<std::string>{"a"});
+}
+
+// An attempt to a peer which never answers is dropped after the setup timeout, the next one backs off
+TEST_F(PoolTest, SetupTimeoutBacksOff) {
+  static constexpr std::chrono::milliseconds kSetupTimeout{200};
+  server_reads = false;
+  start(0, kSetupTimeout);
+  const auto started = now;
+  ASSERT_TRUE(run_until([this] { return pool->stats().timeouts == 1; }, kLimit));
+  EXPECT_GE(now - started, base::RdtscDuration(kSetupTimeout));
+  EXPECT_EQ(pool->stats().failed, 1);
+  EXPECT_EQ(pool->stats().outages, 0);
+  EXPECT_EQ(pool->active(0), nullptr);
+  EXPECT_TRUE(released(kFirstPort));
+  EXPECT_EQ(pool->connect_scheduler().queued(), 1);
+  EXPECT_EQ(pool->connect_scheduler().in_flight(), 0);
+
+  const auto failed = now;
+  ASSERT_TRUE(run_until([this] { return pool->stats().opened == 2; }, kLimit));
+  EXPECT_GE(now - failed, base::RdtscDuration(kRetryBackoff));
+
+  // The peer is back and a retry gets through. On the real clock the server's first accept generates its key, which
+  // may time out one more attempt.
+  server_reads = true;
+  ASSERT_TRUE(run_until([this] { return pool->active(0) != nullptr; }, kLimit));
+  EXPECT_EQ(pool->stats().ready, 1);
+  EXPECT_EQ(pool->streams_up(), 1);
+}
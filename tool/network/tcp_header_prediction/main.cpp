@@ -0,0 +1,121 @@
+// Per-packet cost of tcp::Client::process_packet for in-order data segments with timestamps, with the header
+// prediction and without it. The client receives the segments through the network simulator from a passive
+// tcp::Client of our own stack, only its processing of the received bursts is timed.
+
+#include <chrono>
+#include <vector>
+
+#include "base/clock/sync_rdtsc_clock.h"
+#include "base/logger/logger.h"
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/tcp/client.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tcp/listener.h"
+
+using namespace idk;
+using namespace idk::net;
+
+namespace {
+
+constexpr size_t kPayloadSize = 200;
+// Segments the server sends at once, they arrive in bursts of the device
+constexpr size_t kSegments = 256;
+constexpr size_t kRounds = 2'000;
+constexpr std::chrono::microseconds kTimerTick{100};
+constexpr std::chrono::seconds kConnectTimeout{1};
+
+void
+measure(bool header_prediction) {
+  // No latency, what the server sends is in the client's queue at the next step
+  sim::Simulator simulator({.to_server = {.latency = {}}, .to_client = {.latency = {}}});
+  auto& client_device = simulator.device(sim::Simulator::kClient);
+  auto& server_device = simulator.device(sim::Simulator::kServer);
+  base::TimerWheel timers(kTimerTick, simulator.now());
+
+  const Host client_host{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+  const Host server_host{.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")};
+  const Port server_port(443);
+
+  tcp::Listener listener(server_port, server_device.get_sender());
+  tcp::ConnectionManager<tcp::Client> servers(server_device.get_sender());
+  servers.listen(listener, [&](const tcp::Accepted& accepted) {
+    servers.add(accepted.connection, accepted, server_device.get_sender(), timers);
+  });
+
+  tcp::Client client(
+      Connection{.session = {.src = client_host, .dst = server_host}, .src_port = Port(50000), .dst_port = server_port},
+      client_device.get_sender(), timers);
+  client.set_ack_policy(tcp::AckPolicy::Coalesced);
+  client.set_header_prediction(header_prediction);
+
+  size_t received = 0;
+  std::chrono::nanoseconds processing{0};
+  size_t processed = 0;
+  auto now = simulator.now();
+  const auto step = [&] {
+    now = simulator.step(now + base::RdtscDuration(kTimerTick));
+    timers.advance(now);
+
+    auto server_burst = server_device.receive_burst();
+    std::vector<dpdk::RxPacket> server_packets;
+    for (size_t i = 0; i < server_burst.size(); ++i) {
+      server_packets.push_back(server_burst.take(i));
+    }
+    servers.process(server_packets, [](tcp::Client& server, const dpdk::RxPacket& packet) {
+      server.process_packet(packet, [](base::ByteView, const dpdk::RxPacket&) {});
+    });
+
+    for (auto burst = client_device.receive_burst(); !burst.empty(); burst = client_device.receive_burst()) {
+      const auto start = base::SyncRdtscClock::now();
+      for (size_t i = 0; i < burst.size(); ++i) {
+        client.set_receive_space(client.receive_buffer_target());
+        client.process_packet(burst.take(i),
+                              [&](base::ByteView bytes, const dpdk::RxPacket&) { received += bytes.size(); });
+        client.on_data_consumed();
+      }
+      processing += base::SyncRdtscClock::now() - start;
+      processed += burst.size();
+      client.on_burst_end();
+    }
+  };
+
+  client.connect();
+  const auto connect_deadline = now + base::RdtscDuration(kConnectTimeout);
+  while ((client.get_state() != tcp::Client::State::Connected || servers.size() == 0) && now < connect_deadline) {
+    step();
+  }
+  REQUIRE(servers.size() > 0 && client.get_state() == tcp::Client::State::Connected, "Handshake failed");
+  auto& server = servers[0];
+
+  processing = {};
+  processed = 0;
+  received = 0;
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (size_t i = 0; i < kSegments; ++i) {
+      auto packet = server.get_send_buffer(tcp::Flags::PSH_ACK);
+      server.send(std::move(packet), kPayloadSize);
+    }
+    const size_t expected = (round + 1) * kSegments * kPayloadSize;
+    while (received < expected) {
+      step();
+    }
+  }
+  const auto& stats = client.stats();
+  REQUIRE_EQ(received, kRounds * kSegments * kPayloadSize, "Data was lost");
+  INFO("{}: {:.2f}ns per packet over {} packets, {} predicted",
+       header_prediction ? "predicted" : "general",
+       static_cast<double>(processing.count()) / static_cast<double>(processed), processed, stats.predicted);
+}
+
+} // namespace
+
+int
+main() {
+  base::Logger logger(base::Logger::Params{});
+  for (size_t run = 0; run < 3; ++run) {
+    measure(false);
+    measure(true);
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+// Bulk transfer over the simulated link under a set of impairments: the tcp and tls stack of the gateway downloads
+// from an OpenSSL server running on our passive tcp. Prints the transfer time and the tcp stats of both ends per
+// scenario. Runs on the simulator's virtual clock, deterministically.
+
+#include <vector>
+
+#include "base/logger/logger.h"
+#include "base/timer/timer_wheel.h"
+#include "network/sim/simulator.h"
+#include "network/sim/tls_server.h"
+#include "network/tcp/connection_manager.h"
+#include "network/tls12/client.h"
+
+using namespace idk;
+using namespace idk::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr size_t kTransferBytes = 8 << 20;
+constexpr size_t kChunkBytes = 16 << 10;
+constexpr std::chrono::seconds kDeadline{120};
+constexpr std::chrono::microseconds kTimerTick{100};
+// The only connection takes half of the simulator's pool
+constexpr size_t kHeldMbufs = 4096;
+const std::string kHost = "simulated.server";
+
+struct Scenario {
+  std::string name;
+  sim::LinkConfig link;
+};
+
+std::vector<dpdk::RxPacket>
+take_all(dpdk::RxBurst& burst) {
+  std::vector<dpdk::RxPacket> packets;
+  packets.reserve(burst.size());
+  for (size_t i = 0; i < burst.size(); ++i) {
+    packets.push_back(burst.take(i));
+  }
+  return packets;
+}
+
+void
+run(const Scenario& scenario) {
+  sim::Simulator simulator({.to_server = scenario.link, .to_client = scenario.link});
+  auto& client_device = simulator.device(sim::Simulator::kClient);
+  auto& server_device = simulator.device(sim::Simulator::kServer);
+  base::TimerWheel timers(kTimerTick, simulator.now());
+
+  const Host client_host{.mac = Mac("02:00:00:00:00:01"), .ip = Ip("10.0.0.1")};
+  const Host server_host{.mac = Mac("02:00:00:00:00:02"), .ip = Ip("10.0.0.2")};
+  const Port server_port(443);
+
+  tcp::Listener listener(server_port, server_device.get_sender());
+  tcp::ConnectionManager<sim::TlsServer> servers(server_device.get_sender());
+  servers.listen(listener, [&](const tcp::Accepted& accepted) {
+    servers.add(accepted.connection, kHost, tcp::Client(accepted, server_device.get_sender(), timers));
+  });
+
+  tcp::Client client_tcp(
+      Connection{.session = {.src = client_host, .dst = server_host}, .src_port = Port(50000), .dst_port = server_port},
+      client_device.get_sender(), timers);
+  client_tcp.set_ack_policy(tcp::AckPolicy::Coalesced);
+  tls12::Client client(kHost, std::move(client_tcp), kHeldMbufs);
+
+  size_t sent = 0;
+  size_t received = 0;
+  const auto start = simulator.now();
+  auto now = start;
+  while (received < kTransferBytes && now - start < base::RdtscDuration(kDeadline)) {
+    now = simulator.step(now + base::RdtscDuration(kTimerTick));
+    timers.advance(now);
+
+    auto server_burst = server_device.receive_burst();
+    auto server_packets = take_all(server_burst);
+    servers.process(server_packets, [](sim::TlsServer& server, const dpdk::RxPacket& packet) {
+      server.process_packet(packet, [](base::ByteView) {});
+    });
+    if (servers.size() > 0 && servers[0].is_handshake_complete()) {
+      auto& server = servers[0];
+      while (sent < kTransferBytes && server.tcp().writable()) {
+        const std::vector<uint8_t> chunk(std::min(kChunkBytes, kTransferBytes - sent), 'x');
+        server.send({chunk.data(), chunk.size()});
+        sent += chunk.size();
+      }
+    }
+
+    auto client_burst = client_device.receive_burst();
+    for (size_t i = 0; i < client_burst.size(); ++i) {
+      client.process_packet(client_burst.take(i));
+      while (const auto data = client.receive()) {
+        received += data->size();
+      }
+      client.on_data_consumed();
+    }
+    if (!client_burst.empty()) {
+      client.on_burst_end();
+    }
+  }
+
+  const std::chrono::microseconds elapsed = now - start;
+  INFO("{}: {} of {} bytes in {}us, {:.1f} Mbit/s", scenario.name, received, kTransferBytes, elapsed.count(),
+       static_cast<double>(received) * 8 / static_cast<double>(elapsed.count()));
+  INFO("{}: client tcp {}", scenario.name, client.tcp_stats());
+  if (servers.size() > 0) {
+    INFO("{}: server tcp {}", scenario.name, servers[0].tcp().stats());
+  }
+  INFO("{}: to server {}, to client {}", scenario.name, simulator.link(sim::Simulator::kClient).stats(),
+       simulator.link(sim::Simulator::kServer).stats());
+}
+
+} // namespace
+
+int
+main() {
+  base::Logger logger(base::Logger::Params{});
+  const std::vector<Scenario> scenarios{
+      {.name = "clean", .link = {.latency = 1ms}},
+      {.name = "loss 1%", .link = {.latency = 1ms, .loss = 0.01}},
+      {.name = "reorder 5%", .link = {.latency = 1ms, .reorder = 0.05, .reorder_delay = 300us}},
+      {.name = "jitter 200us", .link = {.latency = 1ms, .jitter = 200us}},
+      {.name = "duplicate 2%", .link = {.latency = 1ms, .duplicate = 0.02}},
+      {.name = "100 Mbit/s", .link = {.latency = 1ms, .bandwidth_bps = 100'000'000}},
+  };
+  for (const auto& scenario: scenarios) {
+    run(scenario);
+  }
+  return 0;
+}